@@ -3,6 +3,9 @@
 #include "asset_lookup.h"
 #include "config.h"
 #include "item_stats.h"
+#include "path_hash.h"
+#include "platform_mmap.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -24,11 +27,23 @@ typedef struct {
   int count;
 } AffixTableList;
 
-// Global map: normalized item path -> AffixTableList
-static GHashTable *g_affix_map = NULL;
+// Resolved affix data for one language. Display names and stat summaries
+// come from the translation table, so each language keeps its own caches
+// while the item map is shared; switching back to a language reuses them.
+typedef struct {
+  // Cache of resolved affix results: normalized item path -> TQItemAffixes*
+  GHashTable *affix_cache;
+
+  // Resolved randomizer tables: table path -> ResolvedTable*
+  GHashTable *table_cache;
+
+  // Resolved affix records: affix path -> AffixInfo* (owns the strings that
+  // every TQAffixEntry points to)
+  GHashTable *affix_info;
+} AffixLangCache;
 
-// Cache of resolved affix results: normalized item path -> TQItemAffixes*
-static GHashTable *g_affix_cache = NULL;
+// Per-language caches: language code -> AffixLangCache*
+static GHashTable *g_lang_caches = NULL;
 
 
 // -- Helpers --
@@ -51,6 +66,26 @@ normalize_path(const char *path)
   return(norm);
 }
 
+// GHashTable hash function for game paths, folding case and separators,
+// so tables keyed on normalized paths can be probed with raw ones.
+// @param key  NUL-terminated path
+// @return hash value
+static guint
+path_key_hash(gconstpointer key)
+{
+  return((guint)path_hash(key));
+}
+
+// GHashTable equality function matching path_key_hash().
+// @param a  first path
+// @param b  second path
+// @return TRUE if the paths match ignoring case and separator style
+static gboolean
+path_key_equal(gconstpointer a, gconstpointer b)
+{
+  return(path_equal(a, b));
+}
+
 // Extract a human-readable name from a file path for fallback display.
 // Strips directory, extension, replaces underscores, capitalizes first letter.
 // @param path  file path to extract name from
@@ -331,12 +366,24 @@ affix_result_free_internal(gpointer data)
 
 // -- Phase A: Build item->table map --
 
-// Process a single LootItemTable record (FixedWeight or DynWeight),
-// extracting item paths and their associated prefix/suffix randomizer tables.
+// Parsed form of one LootItemTable record
+typedef struct {
+  char **names;             // item paths the table applies to
+  int num_names;
+  AffixTablePair *pairs;    // prefix/suffix randomizer table pairs
+  int num_pairs;
+} LootTableResult;
+
+// Parse a single LootItemTable record (FixedWeight or DynWeight),
+// extracting item paths and their associated prefix/suffix randomizer
+// tables. Touches no shared state, so loot tables parse in parallel.
 // @param dbr         decompressed DBR record data
 // @param class_name  the Class field value (FixedWeight or DynWeight)
+// @param out         receives the parse result (left zeroed if it has no
+//                    item paths or no table pairs)
 static void
-process_loot_item_table(TQArzRecordData *dbr, const char *class_name)
+parse_loot_item_table(TQArzRecordData *dbr, const char *class_name,
+                      LootTableResult *out)
 {
   // Collect loot names (item paths this table applies to)
   char *loot_names[64];
@@ -492,14 +539,50 @@ process_loot_item_table(TQArzRecordData *dbr, const char *class_name)
   // Don't free pair strings -- ownership transferred
   g_hash_table_destroy(table_groups);
 
-  // Insert into global map for each loot name
+  out->names = malloc(num_loot_names * sizeof(char *));
+
+  if(!out->names)
+  {
+    for(int j = 0; j < num_pairs; j++)
+    {
+      free(pairs[j].prefix_table);
+      free(pairs[j].suffix_table);
+    }
+
+    free(pairs);
+
+    for(int i = 0; i < num_loot_names; i++)
+      free(loot_names[i]);
+
+    return;
+  }
+
+  memcpy(out->names, loot_names, num_loot_names * sizeof(char *));
+  out->num_names = num_loot_names;
+  out->pairs = pairs;
+  out->num_pairs = num_pairs;
+}
+
+// Merge one parsed LootItemTable into an item -> AffixTableList map. The
+// result's strings and pairs are consumed.
+// @param map  item map (normalized item path -> AffixTableList)
+// @param res  parsed table from parse_loot_item_table()
+static void
+merge_loot_table(GHashTable *map, LootTableResult *res)
+{
+  char **loot_names = res->names;
+  int num_loot_names = res->num_names;
+  AffixTablePair *pairs = res->pairs;
+  int num_pairs = res->num_pairs;
+
+  // Insert into the map for each loot name
   for(int i = 0; i < num_loot_names; i++)
   {
     char *norm_key = normalize_path(loot_names[i]);
 
     free(loot_names[i]);
 
-    AffixTableList *existing = g_hash_table_lookup(g_affix_map, norm_key);
+    AffixTableList *existing = g_hash_table_lookup(map, norm_key);
 
     if(existing)
     {
@@ -560,7 +643,7 @@ process_loot_item_table(TQArzRecordData *dbr, const char *class_name)
         list->count = num_pairs;
       }
 
-      g_hash_table_insert(g_affix_map, norm_key, list);
+      g_hash_table_insert(map, norm_key, list);
     }
   }
 
@@ -575,96 +658,475 @@ process_loot_item_table(TQArzRecordData *dbr, const char *class_name)
 
     free(pairs);
   }
+
+  free(loot_names);
+  res->names = NULL;
+  res->pairs = NULL;
+  res->num_names = 0;
+  res->num_pairs = 0;
 }
 
-// Initialize the global affix table by scanning all LootItemTable records
-// across all loaded .arz files. Call once after asset_manager_init().
-// @param tr  translation table (unused at init time, reserved for future use)
-void
-affix_table_init(TQTranslation *tr)
-{
-  (void)tr;  // tr not needed at init time, only at resolve time
+// -- Background build and persisted map --
 
-  if(g_affix_map)
-    return;  // already initialized
+#define AFFIX_MAP_VERSION 1
+#define AFFIX_MAP_NONE UINT32_MAX
 
-  struct timespec t0;
+#pragma pack(push, 1)
 
-  clock_gettime(CLOCK_MONOTONIC, &t0);
+// AffixMapHeader - header for tqvc-affix-map.bin
+// size: 32 bytes
+typedef struct {
+  char magic[4];            // "TQVA"
+  uint32_t version;         // AFFIX_MAP_VERSION
+  uint32_t index_generation; // resource index generation the map was built from
+  uint32_t num_items;       // number of AffixMapItem entries
+  uint32_t items_offset;    // offset to AffixMapItem array (sorted by hash)
+  uint32_t num_pairs;       // number of AffixMapPair entries
+  uint32_t pairs_offset;    // offset to AffixMapPair array
+  uint32_t strings_offset;  // offset to null-terminated path strings
+} AffixMapHeader;
+
+// AffixMapItem - one item path and its run of table pairs
+// size: 20 bytes
+typedef struct {
+  uint64_t hash;            // path_hash() of the item path
+  uint32_t path_offset;     // normalized item path, relative to strings_offset
+  uint32_t first_pair;      // index of the first AffixMapPair
+  uint32_t num_pairs;       // number of pairs
+} AffixMapItem;
+
+// AffixMapPair - prefix and suffix randomizer tables of one loot entry
+// size: 8 bytes
+typedef struct {
+  uint32_t prefix_offset;   // relative to strings_offset, or AFFIX_MAP_NONE
+  uint32_t suffix_offset;   // relative to strings_offset, or AFFIX_MAP_NONE
+} AffixMapPair;
+
+#pragma pack(pop)
+
+// The item map, either mapped from the cache file or built this session.
+// Written once by the build thread before g_affix_ready is set.
+static uint8_t *g_map = NULL;
+static size_t g_map_size = 0;
+static bool g_map_mapped = false;
+static const AffixMapItem *g_map_items = NULL;
+static const AffixMapPair *g_map_pairs = NULL;
+static const char *g_map_strings = NULL;
+static uint32_t g_map_num_items = 0;
+
+static GThread *g_build_thread = NULL;
+static GMutex g_ready_mutex;
+static GCond g_ready_cond;
+static bool g_affix_ready = false;
+
+// Shared state for the loot table parse workers
+typedef struct {
+  const TQAssetEntry **entries; // LootItemTable records to parse
+  LootTableResult *results;     // one slot per entry
+  int num_entries;
+  gint next;                    // next entry to claim (atomic)
+} AffixBuildShared;
+
+// Collect a LootItemTable record found through the class index.
+// @param entry      index entry of the record
+// @param path       normalized record path
+// @param user_data  GPtrArray of entries
+// @return true to keep iterating
+static bool
+collect_loot_record(const TQAssetEntry *entry, const char *path, void *user_data)
+{
+  // loot tables outside loottables/merchantloottables were never mapped
+  if(strstr(path, "loottables"))
+    g_ptr_array_add(user_data, (gpointer)entry);
 
-  g_affix_map = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, affix_table_list_free);
-  g_affix_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, affix_result_free_internal);
+  return(true);
+}
 
-  int num_files = asset_get_num_files();
-  int records_scanned = 0;
-  int tables_found = 0;
+// Worker thread: decode and parse loot tables claimed from the shared counter.
+// @param user_data  AffixBuildShared
+// @return NULL
+static gpointer
+affix_parse_worker(gpointer user_data)
+{
+  AffixBuildShared *s = user_data;
+  int i;
 
-  for(int fid = 0; fid < num_files; fid++)
+  while((i = g_atomic_int_add(&s->next, 1)) < s->num_entries)
   {
-    const char *fpath = asset_get_file_path((uint16_t)fid);
+    const TQAssetEntry *e = s->entries[i];
+    TQArzRecordData *dbr = asset_read_record(e->file_id, e->offset, e->size);
 
-    if(!fpath)
+    if(!dbr)
       continue;
 
-    // Only process .arz files
-    const char *ext = strrchr(fpath, '.');
+    parse_loot_item_table(dbr, asset_entry_class(e), &s->results[i]);
+    arz_record_data_free(dbr);
+  }
 
-    if(!ext || strcasecmp(ext, ".arz") != 0)
-      continue;
+  return(NULL);
+}
 
-    TQArzFile *arz = asset_get_arz((uint16_t)fid);
+// Build the item map from the game data: decode the LootItemTable records
+// on a worker pool, then merge the parsed tables in index order so the
+// result does not depend on thread timing.
+// @param tables_found  receives the number of tables parsed
+// @return item map (normalized item path -> AffixTableList), or NULL
+static GHashTable *
+affix_map_build(int *tables_found)
+{
+  GPtrArray *records = g_ptr_array_new();
 
-    if(!arz)
-      continue;
+  asset_foreach_class("LootItemTable_FixedWeight", collect_loot_record, records);
+  asset_foreach_class("LootItemTable_DynWeight", collect_loot_record, records);
+
+  AffixBuildShared s;
+
+  s.entries = (const TQAssetEntry **)records->pdata;
+  s.num_entries = (int)records->len;
+  s.results = calloc(records->len ? records->len : 1, sizeof(LootTableResult));
+  s.next = 0;
+
+  if(!s.results)
+  {
+    g_ptr_array_free(records, TRUE);
+    return(NULL);
+  }
+
+  int num_threads = (int)g_get_num_processors();
+
+  if(num_threads > 8)
+    num_threads = 8;
+
+  if(num_threads > s.num_entries)
+    num_threads = s.num_entries;
+
+  GThread *threads[8];
+
+  for(int i = 0; i < num_threads; i++)
+    threads[i] = g_thread_new("tqvc-affix", affix_parse_worker, &s);
+
+  for(int i = 0; i < num_threads; i++)
+    g_thread_join(threads[i]);
+
+  GHashTable *map = g_hash_table_new_full(path_key_hash, path_key_equal, g_free, affix_table_list_free);
+
+  *tables_found = 0;
+
+  for(int i = 0; i < s.num_entries; i++)
+  {
+    if(s.results[i].num_names > 0)
+      (*tables_found)++;
+
+    merge_loot_table(map, &s.results[i]);
+  }
+
+  free(s.results);
+  g_ptr_array_free(records, TRUE);
+  return(map);
+}
+
+// Append a NUL-terminated string to a growing string pool.
+// @param pool  string pool
+// @param str   string to append (NULL allowed)
+// @return offset of the string in the pool, or AFFIX_MAP_NONE for NULL
+static uint32_t
+pool_add(GString *pool, const char *str)
+{
+  if(!str)
+    return(AFFIX_MAP_NONE);
+
+  uint32_t off = (uint32_t)pool->len;
+
+  g_string_append_len(pool, str, (gssize)strlen(str) + 1);
+  return(off);
+}
+
+// Compare two AffixMapItem entries by hash for qsort.
+// @param a  pointer to first AffixMapItem
+// @param b  pointer to second AffixMapItem
+// @return negative/zero/positive
+static int
+compare_map_items(const void *a, const void *b)
+{
+  const AffixMapItem *ia = a;
+  const AffixMapItem *ib = b;
+
+  return(ia->hash < ib->hash ? -1 : (ia->hash > ib->hash ? 1 : 0));
+}
+
+// Serialize an item map into the tqvc-affix-map.bin layout.
+// @param map         item map from affix_map_build()
+// @param generation  resource index generation to record
+// @param size_out    receives the image size
+// @return newly allocated image (caller frees), or NULL
+static uint8_t *
+affix_map_serialize(GHashTable *map, uint32_t generation, size_t *size_out)
+{
+  uint32_t num_items = g_hash_table_size(map);
+  uint32_t num_pairs = 0;
+  AffixMapItem *items = calloc(num_items ? num_items : 1, sizeof(AffixMapItem));
+  GArray *pairs = g_array_new(FALSE, FALSE, sizeof(AffixMapPair));
+  GString *pool = g_string_new(NULL);
+  GHashTableIter iter;
+  gpointer key, value;
+  uint32_t n = 0;
+
+  if(!items)
+  {
+    g_array_free(pairs, TRUE);
+    g_string_free(pool, TRUE);
+    return(NULL);
+  }
+
+  g_hash_table_iter_init(&iter, map);
+
+  while(g_hash_table_iter_next(&iter, &key, &value))
+  {
+    const AffixTableList *list = value;
 
-    for(uint32_t ri = 0; ri < arz->num_records; ri++)
+    items[n].hash = path_hash(key);
+    items[n].path_offset = pool_add(pool, key);
+    items[n].first_pair = num_pairs;
+    items[n].num_pairs = (uint32_t)list->count;
+
+    for(int j = 0; j < list->count; j++)
     {
-      const char *rpath = arz->records[ri].path;
+      AffixMapPair pair;
 
-      if(!rpath)
-        continue;
+      pair.prefix_offset = pool_add(pool, list->pairs[j].prefix_table);
+      pair.suffix_offset = pool_add(pool, list->pairs[j].suffix_table);
+      g_array_append_val(pairs, pair);
+    }
 
-      // Process LootItemTable records
-      if(!path_contains_ci(rpath, "loottables") &&
-         !path_contains_ci(rpath, "merchantloottables"))
-        continue;
+    num_pairs += (uint32_t)list->count;
+    n++;
+  }
 
-      records_scanned++;
+  qsort(items, num_items, sizeof(AffixMapItem), compare_map_items);
 
-      // Decompress and check Class field
-      TQArzRecordData *dbr = arz_read_record_at(arz,
-        arz->records[ri].offset, arz->records[ri].compressed_size);
+  AffixMapHeader h;
 
-      if(!dbr)
-        continue;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "TQVA", 4);
+  h.version = AFFIX_MAP_VERSION;
+  h.index_generation = generation;
+  h.num_items = num_items;
+  h.items_offset = sizeof(AffixMapHeader);
+  h.num_pairs = num_pairs;
+  h.pairs_offset = h.items_offset + num_items * sizeof(AffixMapItem);
+  h.strings_offset = h.pairs_offset + num_pairs * sizeof(AffixMapPair);
 
-      char *class_name_str = arz_record_get_string(dbr, "Class", NULL);
+  size_t size = (size_t)h.strings_offset + pool->len;
+  uint8_t *image = malloc(size);
 
-      if(class_name_str &&
-         (strcasecmp(class_name_str, "LootItemTable_FixedWeight") == 0 ||
-          strcasecmp(class_name_str, "LootItemTable_DynWeight") == 0))
-      {
-        process_loot_item_table(dbr, class_name_str);
-        tables_found++;
-      }
+  if(image)
+  {
+    memcpy(image, &h, sizeof(h));
+    memcpy(image + h.items_offset, items, num_items * sizeof(AffixMapItem));
+    memcpy(image + h.pairs_offset, pairs->data, num_pairs * sizeof(AffixMapPair));
+    memcpy(image + h.strings_offset, pool->str, pool->len);
+    *size_out = size;
+  }
+
+  free(items);
+  g_array_free(pairs, TRUE);
+  g_string_free(pool, TRUE);
+  return(image);
+}
+
+// Check a map image and point the lookup globals at it.
+// @param image       mapped or built image
+// @param size        image size in bytes
+// @param generation  resource index generation the image must match
+// @return true if the image is valid and current
+static bool
+affix_map_attach(const uint8_t *image, size_t size, uint32_t generation)
+{
+  if(size < sizeof(AffixMapHeader))
+    return(false);
+
+  const AffixMapHeader *h = (const AffixMapHeader *)image;
+
+  if(memcmp(h->magic, "TQVA", 4) != 0 || h->version != AFFIX_MAP_VERSION ||
+     h->index_generation != generation ||
+     (uint64_t)h->items_offset + (uint64_t)h->num_items * sizeof(AffixMapItem) > size ||
+     (uint64_t)h->pairs_offset + (uint64_t)h->num_pairs * sizeof(AffixMapPair) > size ||
+     h->strings_offset > size)
+    return(false);
+
+  const AffixMapItem *items = (const AffixMapItem *)(image + h->items_offset);
+  const AffixMapPair *pairs = (const AffixMapPair *)(image + h->pairs_offset);
+  const char *strings = (const char *)image + h->strings_offset;
+  size_t strings_size = size - h->strings_offset;
+
+  // every string must be NUL-terminated inside the pool
+  if(strings_size > 0 && strings[strings_size - 1] != '\0')
+    return(false);
+
+  for(uint32_t i = 0; i < h->num_items; i++)
+  {
+    if(items[i].path_offset >= strings_size ||
+       (uint64_t)items[i].first_pair + items[i].num_pairs > h->num_pairs)
+      return(false);
+  }
+
+  for(uint32_t i = 0; i < h->num_pairs; i++)
+  {
+    if((pairs[i].prefix_offset != AFFIX_MAP_NONE && pairs[i].prefix_offset >= strings_size) ||
+       (pairs[i].suffix_offset != AFFIX_MAP_NONE && pairs[i].suffix_offset >= strings_size))
+      return(false);
+  }
 
-      free(class_name_str);
-      arz_record_data_free(dbr);
+  g_map_items = items;
+  g_map_pairs = pairs;
+  g_map_strings = strings;
+  g_map_num_items = h->num_items;
+  return(true);
+}
+
+// Write a map image to the cache file, via a temporary file and rename.
+// @param cache_path  filesystem path of tqvc-affix-map.bin
+// @param image       serialized map
+// @param size        image size in bytes
+static void
+affix_map_save(const char *cache_path, const uint8_t *image, size_t size)
+{
+  if(!platform_write_file(cache_path, image, size))
+    fprintf(stderr, "affix_map_save: could not replace %s\n", cache_path);
+}
+
+// Build thread: map the persisted item map if it matches the current
+// resource index, otherwise build, save and use a fresh one. Wakes
+// affix_table_wait() callers when done.
+// @param user_data  unused
+// @return NULL
+static gpointer
+affix_build_thread(gpointer user_data)
+{
+  (void)user_data;
+
+  struct timespec t0;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  uint32_t generation = asset_index_generation();
+  char *cache_dir = tqvc_cache_dir_new();
+  char *cache_path = g_build_filename(cache_dir, "tqvc-affix-map.bin", NULL);
+  int tables_found = -1;
+
+  g_free(cache_dir);
+
+  g_map = platform_mmap_readonly(cache_path, &g_map_size);
+  g_map_mapped = (g_map != NULL);
+
+  if(g_map && !affix_map_attach(g_map, g_map_size, generation))
+  {
+    platform_munmap(g_map, g_map_size);
+    g_map = NULL;
+    g_map_size = 0;
+    g_map_mapped = false;
+  }
+
+  if(!g_map)
+  {
+    GHashTable *map = affix_map_build(&tables_found);
+
+    if(map)
+    {
+      g_map = affix_map_serialize(map, generation, &g_map_size);
+      g_hash_table_destroy(map);
+    }
+
+    if(g_map && affix_map_attach(g_map, g_map_size, generation))
+      affix_map_save(cache_path, g_map, g_map_size);
+    else
+    {
+      free(g_map);
+      g_map = NULL;
+      g_map_size = 0;
     }
   }
 
+  g_free(cache_path);
+
   struct timespec t1;
 
   clock_gettime(CLOCK_MONOTONIC, &t1);
   double ms = (t1.tv_sec - t0.tv_sec) * 1000.0 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
 
   if(tqvc_debug)
-    fprintf(stderr, "Affix table init: scanned %d loot records, found %d tables, "
-            "%d items mapped in %.1f ms\n",
-            records_scanned, tables_found,
-            g_hash_table_size(g_affix_map), ms);
+  {
+    if(tables_found < 0)
+      fprintf(stderr, "Affix table init: %u items mapped from cache in %.1f ms\n",
+              g_map_num_items, ms);
+    else
+      fprintf(stderr, "Affix table init: built from %d tables, %u items mapped in %.1f ms\n",
+              tables_found, g_map_num_items, ms);
+  }
+
+  g_mutex_lock(&g_ready_mutex);
+  g_affix_ready = true;
+  g_cond_broadcast(&g_ready_cond);
+  g_mutex_unlock(&g_ready_mutex);
+  return(NULL);
+}
+
+// Find an item in the attached map.
+// @param item_path  item DBR path (case and separators are ignored)
+// @return map item, or NULL if the item has no affix tables
+static const AffixMapItem *
+affix_map_find(const char *item_path)
+{
+  return(path_sorted_find(g_map_items, g_map_num_items, sizeof(AffixMapItem),
+                          offsetof(AffixMapItem, hash),
+                          offsetof(AffixMapItem, path_offset),
+                          g_map_strings, item_path));
+}
+
+// Start building the global affix table on a background thread. The item
+// map is read from the cache when it matches the resource index, so only
+// the first launch after a game data change decodes the loot tables.
+// Call once after asset_manager_init().
+// @param tr  translation table (unused at init time, reserved for future use)
+void
+affix_table_init(TQTranslation *tr)
+{
+  (void)tr;  // tr not needed at init time, only at resolve time
+
+  if(g_build_thread)
+    return;  // already initialized
+
+  g_affix_ready = false;
+  g_build_thread = g_thread_new("tqvc-affix-map", affix_build_thread, NULL);
 }
 
+// Check whether the background affix table build has finished.
+// @return true if affix_table_get() will not block
+bool
+affix_table_ready(void)
+{
+  g_mutex_lock(&g_ready_mutex);
+  bool ready = g_affix_ready;
+  g_mutex_unlock(&g_ready_mutex);
+  return(ready);
+}
+
+// Block until the background affix table build has finished.
+void
+affix_table_wait(void)
+{
+  if(!g_build_thread)
+    return;
+
+  g_mutex_lock(&g_ready_mutex);
+
+  while(!g_affix_ready)
+    g_cond_wait(&g_ready_cond, &g_ready_mutex);
+
+  g_mutex_unlock(&g_ready_mutex);
+}
+
+
 // -- Phase B: Resolve affix list on demand --
 
 // Compare two TQAffixEntry structs for qsort: by family, then tier, then translation.
@@ -693,28 +1155,214 @@ compare_affix_entries(const void *a, const void *b)
   return(strcasecmp(ea->translation, eb->translation));
 }
 
-// Resolve a single randomizer table DBR to a list of affix entries,
-// appending results to the provided output arrays.
-// @param table_path   path to the LootRandomizerTable DBR
-// @param tr           translation table for resolving affix display names
-// @param out_entries  pointer to entry array (may be reallocated)
-// @param out_count    pointer to current entry count (updated on return)
+// Display data for one affix record, resolved once and shared by every
+// table and item result that lists the affix. TQAffixEntry strings point
+// into these.
+typedef struct {
+  char *affix_path;
+  char *translation;
+  char *effect_family;
+  int tier;
+  char *stat_summary;
+  char *stat_category;
+  char *stat_values;
+} AffixInfo;
+
+// A randomizer table resolved to its distinct affixes and their weights
+typedef struct {
+  const AffixInfo **affixes;
+  float *weights;
+  int count;
+} ResolvedTable;
+
+// One randomizerName[N] / randomizerWeight[N] pair of a randomizer table
+typedef struct {
+  char *path;
+  float weight;
+} RandPair;
+
+// Free a RandPair (GHashTable value destroy callback).
+// @param data  gpointer to RandPair
+static void
+rand_pair_free(gpointer data)
+{
+  RandPair *rp = data;
+
+  free(rp->path);
+  g_free(rp);
+}
+
+// Free an AffixInfo (GHashTable value destroy callback).
+// @param data  gpointer to AffixInfo
+static void
+affix_info_free(gpointer data)
+{
+  AffixInfo *info = data;
+
+  free(info->affix_path);
+  free(info->translation);
+  free(info->effect_family);
+  free(info->stat_summary);
+  free(info->stat_category);
+  free(info->stat_values);
+  free(info);
+}
+
+// Free a ResolvedTable (GHashTable value destroy callback).
+// @param data  gpointer to ResolvedTable
+static void
+resolved_table_free(gpointer data)
+{
+  ResolvedTable *t = data;
+
+  free(t->affixes);
+  free(t->weights);
+  free(t);
+}
+
+// Free an AffixLangCache (GHashTable value destroy callback).
+// @param data  gpointer to AffixLangCache
 static void
-resolve_randomizer_table(const char *table_path, TQTranslation *tr,
-                         TQAffixEntry **out_entries, int *out_count)
+affix_lang_cache_free(gpointer data)
+{
+  AffixLangCache *lc = data;
+
+  // results and tables borrow the affix info strings, so it goes last
+  g_hash_table_destroy(lc->affix_cache);
+  g_hash_table_destroy(lc->table_cache);
+  g_hash_table_destroy(lc->affix_info);
+  g_free(lc);
+}
+
+// Get the caches for a translation table's language, creating them on
+// first use. Tables without a language code (and NULL) share one set.
+// @param tr  translation table for resolving affix display names
+// @return caches for the language (owned by g_lang_caches)
+static AffixLangCache *
+affix_lang_cache(TQTranslation *tr)
+{
+  const char *code = tr ? tr->language : "";
+
+  if(!g_lang_caches)
+    g_lang_caches = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, affix_lang_cache_free);
+
+  AffixLangCache *lc = g_hash_table_lookup(g_lang_caches, code);
+
+  if(lc)
+    return(lc);
+
+  lc = g_new0(AffixLangCache, 1);
+  lc->affix_cache = g_hash_table_new_full(path_key_hash, path_key_equal, g_free, affix_result_free_internal);
+  lc->table_cache = g_hash_table_new_full(path_key_hash, path_key_equal, g_free, resolved_table_free);
+  lc->affix_info = g_hash_table_new_full(path_key_hash, path_key_equal, NULL, affix_info_free);
+  g_hash_table_insert(g_lang_caches, g_strdup(code), lc);
+  return(lc);
+}
+
+// Resolve an affix record's translation, family/tier and stat summary, or
+// return the copy resolved earlier.
+// @param lc          caches of tr's language
+// @param affix_path  path to the affix DBR
+// @param tr          translation table for resolving affix display names
+// @return shared affix info (owned by lc->affix_info)
+static const AffixInfo *
+affix_info_get(AffixLangCache *lc, const char *affix_path, TQTranslation *tr)
+{
+  AffixInfo *info = g_hash_table_lookup(lc->affix_info, affix_path);
+
+  if(info)
+    return(info);
+
+  info = calloc(1, sizeof(AffixInfo));
+
+  if(!info)
+    return(NULL);
+
+  // Resolve translation
+  char *translation = NULL;
+  TQArzRecordData *affix_dbr = asset_get_dbr(affix_path);
+
+  if(affix_dbr)
+  {
+    char *tag = arz_record_get_string(affix_dbr, "lootRandomizerName", NULL);
+
+    if(tag && tag[0] && tr)
+    {
+      const char *trans = translation_get(tr, tag);
+
+      if(trans && trans[0])
+        translation = strdup(trans);
+    }
+
+    free(tag);
+
+    if(!translation)
+    {
+      char *fdesc = arz_record_get_string(affix_dbr, "FileDescription", NULL);
+
+      if(fdesc && fdesc[0])
+        translation = fdesc;
+      else
+        free(fdesc);
+    }
+  }
+
+  if(!translation)
+    translation = pretty_filename(affix_path);
+
+  // Extract family/tier from affix path
+  char *family = NULL;
+  int tier = 0;
+
+  extract_affix_family(affix_path, &family, &tier);
+
+  // Build stat summary from the affix DBR
+  char *summary = item_bonus_stat_summary(affix_path, tr);
+
+  if(!summary)
+    summary = family ? strdup(family) : pretty_filename(affix_path);
+
+  // Split summary into category (names) and compact values
+  char *category = NULL, *values = NULL;
+
+  split_stat_summary(summary, &category, &values);
+
+  info->affix_path = strdup(affix_path);
+  info->translation = translation;
+  info->effect_family = family;
+  info->tier = tier;
+  info->stat_summary = summary;
+  info->stat_category = category;
+  info->stat_values = values;
+  g_hash_table_insert(lc->affix_info, info->affix_path, info);
+  return(info);
+}
+
+// Resolve a randomizer table DBR to its distinct affixes and weights, or
+// return the copy resolved earlier. Many items share the same tables, so
+// each table is read and each affix summarized only once per session.
+// @param table_path  path to the LootRandomizerTable DBR
+// @param tr          translation table for resolving affix display names
+// @return shared resolved table (owned by the language's table cache), or NULL
+static const ResolvedTable *
+resolved_table_get(const char *table_path, TQTranslation *tr)
 {
   if(!table_path || !table_path[0])
-    return;
+    return(NULL);
+
+  AffixLangCache *lc = affix_lang_cache(tr);
+  ResolvedTable *t = g_hash_table_lookup(lc->table_cache, table_path);
+
+  if(t)
+    return(t);
 
   TQArzRecordData *dbr = asset_get_dbr(table_path);
 
   if(!dbr)
-    return;
+    return(NULL);
 
   // Collect randomizerName[N] / randomizerWeight[N] pairs
-  GHashTable *pairs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
-
-  typedef struct { char *path; float weight; } RandPair;
+  GHashTable *pairs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, rand_pair_free);
 
   for(uint32_t i = 0; i < dbr->num_vars; i++)
   {
@@ -774,19 +1422,28 @@ resolve_randomizer_table(const char *table_path, TQTranslation *tr,
     }
   }
 
-  // Convert valid pairs to affix entries
   int capacity = g_hash_table_size(pairs);
-  TQAffixEntry *entries = *out_entries;
-  int count = *out_count;
 
-  entries = realloc(entries, (count + capacity) * sizeof(TQAffixEntry));
+  t = calloc(1, sizeof(ResolvedTable));
 
-  if(!entries)
+  if(t)
   {
+    t->affixes = malloc((capacity ? capacity : 1) * sizeof(AffixInfo *));
+    t->weights = malloc((capacity ? capacity : 1) * sizeof(float));
+  }
+
+  if(!t || !t->affixes || !t->weights)
+  {
+    if(t)
+      resolved_table_free(t);
+
     g_hash_table_destroy(pairs);
-    return;
+    return(NULL);
   }
 
+  // Convert valid pairs to affix rows, summing the weights of an affix
+  // listed more than once (info pointer -> row + 1)
+  GHashTable *rows = g_hash_table_new(g_direct_hash, g_direct_equal);
   GHashTableIter iter;
   gpointer gkey, gval;
 
@@ -797,156 +1454,134 @@ resolve_randomizer_table(const char *table_path, TQTranslation *tr,
     RandPair *rp = gval;
 
     if(!rp->path || rp->weight <= 0)
-    {
-      free(rp->path);
-      rp->path = NULL;
       continue;
-    }
-
-    // Check if this affix path already exists (deduplicate, sum weights)
-    bool found_dup = false;
 
-    for(int j = 0; j < count; j++)
-    {
-      if(strcasecmp(entries[j].affix_path, rp->path) == 0)
-      {
-        entries[j].weight += rp->weight;
-        found_dup = true;
-        break;
-      }
-    }
+    const AffixInfo *info = affix_info_get(lc, rp->path, tr);
 
-    if(found_dup)
-    {
-      free(rp->path);
-      rp->path = NULL;
+    if(!info)
       continue;
-    }
 
-    // Resolve translation
-    char *translation = NULL;
-    TQArzRecordData *affix_dbr = asset_get_dbr(rp->path);
+    int row = GPOINTER_TO_INT(g_hash_table_lookup(rows, info)) - 1;
 
-    if(affix_dbr)
+    if(row >= 0)
     {
-      char *tag = arz_record_get_string(affix_dbr, "lootRandomizerName", NULL);
-
-      if(tag && tag[0] && tr)
-      {
-        const char *trans = translation_get(tr, tag);
-
-        if(trans && trans[0])
-          translation = strdup(trans);
-      }
-
-      free(tag);
-
-      if(!translation)
-      {
-        char *fdesc = arz_record_get_string(affix_dbr, "FileDescription", NULL);
-
-        if(fdesc && fdesc[0])
-          translation = fdesc;
-        else
-          free(fdesc);
-      }
+      t->weights[row] += rp->weight;
+      continue;
     }
 
-    if(!translation)
-      translation = pretty_filename(rp->path);
+    t->affixes[t->count] = info;
+    t->weights[t->count] = rp->weight;
+    t->count++;
+    g_hash_table_insert(rows, (gpointer)info, GINT_TO_POINTER(t->count));
+  }
 
-    // Extract family/tier from affix path
-    char *family = NULL;
-    int tier = 0;
+  g_hash_table_destroy(rows);
+  g_hash_table_destroy(pairs);
+  g_hash_table_insert(lc->table_cache, g_strdup(table_path), t);
+  return(t);
+}
 
-    extract_affix_family(rp->path, &family, &tier);
+// Append a resolved table's affixes to an entry list. An affix already in
+// the list (from another table) gets the weights summed instead.
+// @param t            resolved randomizer table
+// @param seen         AffixInfo pointer -> entry index + 1 for this list
+// @param out_entries  pointer to entry array (may be reallocated)
+// @param out_count    pointer to current entry count (updated on return)
+static void
+append_resolved_table(const ResolvedTable *t, GHashTable *seen,
+                      TQAffixEntry **out_entries, int *out_count)
+{
+  if(!t || t->count == 0)
+    return;
 
-    // Build stat summary from the affix DBR
-    char *summary = item_bonus_stat_summary(rp->path, tr);
+  TQAffixEntry *entries = realloc(*out_entries, (*out_count + t->count) * sizeof(TQAffixEntry));
+  int count = *out_count;
 
-    if(!summary)
-      summary = family ? strdup(family) : pretty_filename(rp->path);
+  if(!entries)
+    return;
 
-    // Split summary into category (names) and compact values
-    char *category = NULL, *values = NULL;
+  for(int i = 0; i < t->count; i++)
+  {
+    const AffixInfo *info = t->affixes[i];
+    int idx = GPOINTER_TO_INT(g_hash_table_lookup(seen, info)) - 1;
 
-    split_stat_summary(summary, &category, &values);
+    if(idx >= 0)
+    {
+      entries[idx].weight += t->weights[i];
+      continue;
+    }
 
-    entries[count].affix_path = rp->path;
-    entries[count].translation = translation;
-    entries[count].weight = rp->weight;
-    entries[count].effect_family = family;
-    entries[count].tier = tier;
-    entries[count].stat_summary = summary;
-    entries[count].stat_category = category;
-    entries[count].stat_values = values;
-    rp->path = NULL;  // ownership transferred
+    entries[count].affix_path = info->affix_path;
+    entries[count].translation = info->translation;
+    entries[count].weight = t->weights[i];
+    entries[count].effect_family = info->effect_family;
+    entries[count].tier = info->tier;
+    entries[count].stat_summary = info->stat_summary;
+    entries[count].stat_category = info->stat_category;
+    entries[count].stat_values = info->stat_values;
     count++;
+    g_hash_table_insert(seen, (gpointer)info, GINT_TO_POINTER(count));
   }
 
-  // Clean up any remaining rp->path that weren't transferred
-  g_hash_table_iter_init(&iter, pairs);
-
-  while(g_hash_table_iter_next(&iter, &gkey, &gval))
-  {
-    RandPair *rp = gval;
-
-    free(rp->path);
-    rp->path = NULL;
-  }
-
-  g_hash_table_destroy(pairs);
-
   *out_entries = entries;
   *out_count = count;
 }
 
 // Look up valid prefixes and suffixes for an item by its base_name.
-// Returns cached results on subsequent calls for the same item.
+// Returns cached results on subsequent calls for the same item and
+// language. Blocks until the background build started by
+// affix_table_init() has finished.
 // @param item_base_name  DBR path to the item record
 // @param tr              translation table for resolving affix display names
 // @return pointer to TQItemAffixes (owned by cache, do not free), or NULL
 TQItemAffixes *
 affix_table_get(const char *item_base_name, TQTranslation *tr)
 {
-  if(!item_base_name || !g_affix_map)
+  if(!item_base_name || !g_build_thread)
     return(NULL);
 
-  char *norm = normalize_path(item_base_name);
+  affix_table_wait();
+
+  if(!g_map)
+    return(NULL);
 
-  // Check cache
-  TQItemAffixes *cached = g_hash_table_lookup(g_affix_cache, norm);
+  // Both tables hash and compare paths case/separator-insensitively, so
+  // the raw path is probed directly without a normalized copy.
+  AffixLangCache *lc = affix_lang_cache(tr);
+  TQItemAffixes *cached = g_hash_table_lookup(lc->affix_cache, item_base_name);
 
   if(cached)
-  {
-    g_free(norm);
     return(cached);
-  }
 
   // Look up affix table list
-  AffixTableList *tbl = g_hash_table_lookup(g_affix_map, norm);
+  const AffixMapItem *item = affix_map_find(item_base_name);
 
-  if(!tbl || tbl->count == 0)
-  {
-    g_free(norm);
+  if(!item || item->num_pairs == 0)
     return(NULL);
-  }
 
   TQItemAffixes *result = calloc(1, sizeof(TQItemAffixes));
 
   if(!result)
-  {
-    g_free(norm);
     return(NULL);
-  }
 
-  // Track which randomizer tables we've already resolved (avoid duplicates)
-  GHashTable *resolved = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  // Track which randomizer tables we've already resolved (avoid duplicates);
+  // keys borrow the table paths owned by the map
+  GHashTable *resolved = g_hash_table_new(path_key_hash, path_key_equal);
+
+  // Affixes already listed, per list (AffixInfo pointer -> index + 1)
+  GHashTable *seen[2] = {
+    g_hash_table_new(g_direct_hash, g_direct_equal),
+    g_hash_table_new(g_direct_hash, g_direct_equal)
+  };
 
   // Resolve prefix and suffix tables from direct loot table references
-  for(int i = 0; i < tbl->count; i++)
+  for(uint32_t i = 0; i < item->num_pairs; i++)
   {
-    const char *tables[2] = { tbl->pairs[i].prefix_table, tbl->pairs[i].suffix_table };
+    const AffixMapPair *pair = &g_map_pairs[item->first_pair + i];
+    const char *tables[2] = {
+      pair->prefix_offset != AFFIX_MAP_NONE ? g_map_strings + pair->prefix_offset : NULL,
+      pair->suffix_offset != AFFIX_MAP_NONE ? g_map_strings + pair->suffix_offset : NULL
+    };
     TQAffixEntry **lists[2] = { &result->prefixes.entries, &result->suffixes.entries };
     int *counts[2] = { &result->prefixes.count, &result->suffixes.count };
 
@@ -955,19 +1590,18 @@ affix_table_get(const char *item_base_name, TQTranslation *tr)
       if(!tables[t] || !tables[t][0])
         continue;
 
-      char *tnorm = normalize_path(tables[t]);
-
-      if(!g_hash_table_contains(resolved, tnorm))
+      if(!g_hash_table_contains(resolved, tables[t]))
       {
-        g_hash_table_add(resolved, tnorm);
-        resolve_randomizer_table(tables[t], tr, lists[t], counts[t]);
+        g_hash_table_add(resolved, (gpointer)tables[t]);
+        append_resolved_table(resolved_table_get(tables[t], tr), seen[t],
+                              lists[t], counts[t]);
       }
-      else
-        g_free(tnorm);
     }
   }
 
   g_hash_table_destroy(resolved);
+  g_hash_table_destroy(seen[0]);
+  g_hash_table_destroy(seen[1]);
 
   // Sort by translation
   if(result->prefixes.count > 0)
@@ -982,12 +1616,11 @@ affix_table_get(const char *item_base_name, TQTranslation *tr)
   if(result->prefixes.count == 0 && result->suffixes.count == 0)
   {
     free(result);
-    g_free(norm);
     return(NULL);
   }
 
-  // Cache the result (cache takes ownership of norm key)
-  g_hash_table_insert(g_affix_cache, norm, result);
+  // Cache the result under a normalized copy of the path
+  g_hash_table_insert(lc->affix_cache, normalize_path(item_base_name), result);
   return(result);
 }
 
@@ -1230,6 +1863,9 @@ affix_table_get_forge(const char *item_base_name, TQTranslation *tr)
   if(!result)
     return(NULL);
 
+  GHashTable *seen_prefixes = g_hash_table_new(g_direct_hash, g_direct_equal);
+  GHashTable *seen_suffixes = g_hash_table_new(g_direct_hash, g_direct_equal);
+
   for(int t = 0; t < 3; t++)
   {
     // Prefix table variable: e.g. "ItemTable_IntDefensivePrefixNormal"
@@ -1244,14 +1880,17 @@ affix_table_get_forge(const char *item_base_name, TQTranslation *tr)
     const char *suffix_table = dbr_get_string_internal(durin, suffix_var);
 
     if(prefix_table && prefix_table[0])
-      resolve_randomizer_table(prefix_table, tr,
-                               &result->prefixes.entries, &result->prefixes.count);
+      append_resolved_table(resolved_table_get(prefix_table, tr), seen_prefixes,
+                            &result->prefixes.entries, &result->prefixes.count);
 
     if(suffix_table && suffix_table[0])
-      resolve_randomizer_table(suffix_table, tr,
-                               &result->suffixes.entries, &result->suffixes.count);
+      append_resolved_table(resolved_table_get(suffix_table, tr), seen_suffixes,
+                            &result->suffixes.entries, &result->suffixes.count);
   }
 
+  g_hash_table_destroy(seen_prefixes);
+  g_hash_table_destroy(seen_suffixes);
+
   // Sort by translation
   if(result->prefixes.count > 0)
     qsort(result->prefixes.entries, result->prefixes.count,
@@ -1272,7 +1911,8 @@ affix_table_get_forge(const char *item_base_name, TQTranslation *tr)
 
 // -- Cleanup --
 
-// Free a TQItemAffixes structure and all its entries.
+// Free a TQItemAffixes structure and its entry arrays. The entry strings
+// belong to the shared affix cache and are released by affix_table_free().
 // @param affixes  structure to free (NULL-safe)
 void
 affix_result_free(TQItemAffixes *affixes)
@@ -1280,28 +1920,8 @@ affix_result_free(TQItemAffixes *affixes)
   if(!affixes)
     return;
 
-  for(int i = 0; i < affixes->prefixes.count; i++)
-  {
-    free(affixes->prefixes.entries[i].affix_path);
-    free(affixes->prefixes.entries[i].translation);
-    free(affixes->prefixes.entries[i].effect_family);
-    free(affixes->prefixes.entries[i].stat_summary);
-    free(affixes->prefixes.entries[i].stat_category);
-    free(affixes->prefixes.entries[i].stat_values);
-  }
-
+  // entry strings are shared with the resolved-table cache
   free(affixes->prefixes.entries);
-
-  for(int i = 0; i < affixes->suffixes.count; i++)
-  {
-    free(affixes->suffixes.entries[i].affix_path);
-    free(affixes->suffixes.entries[i].translation);
-    free(affixes->suffixes.entries[i].effect_family);
-    free(affixes->suffixes.entries[i].stat_summary);
-    free(affixes->suffixes.entries[i].stat_category);
-    free(affixes->suffixes.entries[i].stat_values);
-  }
-
   free(affixes->suffixes.entries);
   free(affixes);
 }
@@ -1310,15 +1930,29 @@ affix_result_free(TQItemAffixes *affixes)
 void
 affix_table_free(void)
 {
-  if(g_affix_cache)
+  if(g_build_thread)
   {
-    g_hash_table_destroy(g_affix_cache);
-    g_affix_cache = NULL;
+    g_thread_join(g_build_thread);
+    g_build_thread = NULL;
   }
 
-  if(g_affix_map)
+  if(g_lang_caches)
   {
-    g_hash_table_destroy(g_affix_map);
-    g_affix_map = NULL;
+    g_hash_table_destroy(g_lang_caches);
+    g_lang_caches = NULL;
   }
+
+  if(g_map_mapped)
+    platform_munmap(g_map, g_map_size);
+  else
+    free(g_map);
+
+  g_map = NULL;
+  g_map_size = 0;
+  g_map_mapped = false;
+  g_map_items = NULL;
+  g_map_pairs = NULL;
+  g_map_strings = NULL;
+  g_map_num_items = 0;
+  g_affix_ready = false;
 }
@@ -4,6 +4,8 @@
 #include "translation.h"
 #include <stdbool.h>
 
+// Strings are shared between results and owned by the affix table; they
+// stay valid until affix_table_free().
 typedef struct {
     char *affix_path;       // DBR path to individual affix record
     char *translation;      // Resolved display name
@@ -25,17 +27,30 @@ typedef struct TQItemAffixes_tag {
     TQAffixList suffixes;
 } TQItemAffixes;
 
-// Build the global item->affix-table map by scanning all loot item table records.
-// Call once after asset_manager_init().
+// Start building the global item->affix-table map on a background thread,
+// from the cached map when it matches the resource index, otherwise by
+// scanning all loot item table records. Call once after asset_manager_init().
 // tr: translation table for resolving affix display names.
 void
 affix_table_init(TQTranslation *tr);
 
-// Get valid prefixes and suffixes for the given item base_name.
+// Check whether the background affix table build has finished.
+// Returns: true if affix_table_get() will not block.
+bool
+affix_table_ready(void);
+
+// Block until the background affix table build has finished. Returns at
+// once if affix_table_init() was never called.
+void
+affix_table_wait(void);
+
+// Get valid prefixes and suffixes for the given item base_name. Waits for
+// the background build if it has not finished yet. Results are cached per
+// language of tr, so switching languages keeps the others' results.
 // item_base_name: DBR path of the item base record.
 // tr: translation table for resolving affix display names.
-// Returns: allocated TQItemAffixes, or NULL if item has no affix tables.
-//          Caller must call affix_result_free() when done.
+// Returns: cached TQItemAffixes (owned by the affix table, do not free),
+//          or NULL if item has no affix tables.
 TQItemAffixes *
 affix_table_get(const char *item_base_name, TQTranslation *tr);
 
@@ -60,7 +75,8 @@ item_can_forge_affixes(const char *base_name);
 TQItemAffixes *
 affix_table_get_forge(const char *item_base_name, TQTranslation *tr);
 
-// Free an affix result returned by affix_table_get or affix_table_get_forge.
+// Free an affix result returned by affix_table_get_forge (the entry strings
+// are shared and not freed here).
 // affixes: the result to free (NULL-safe).
 void
 affix_result_free(TQItemAffixes *affixes);
@@ -1,5 +1,7 @@
 #include "arc.h"
 #include "platform_mmap.h"
+#include "path_hash.h"
+#include <glib.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -30,7 +32,15 @@ typedef struct {
 
 #pragma pack(pop)
 
-// arc_load -- load and parse an ARC archive file.
+// TQArcIndex - open-addressing hash table over the entry names
+struct TQArcIndex {
+  uint32_t mask;        // number of slots - 1 (a power of two)
+  uint32_t *slots;      // entry index + 1, or 0 for an empty slot
+  uint64_t *hashes;     // path_hash() of each entry name
+};
+
+// arc_load -- load and parse an ARC archive file. Entry names are not
+// copied: they point into the mapped file.
 // filepath: path to the .arc file.
 // returns: parsed TQArcFile, or NULL on failure.
 TQArcFile *
@@ -44,7 +54,17 @@ arc_load(const char *filepath)
 
   ArcHeader *header = (ArcHeader *)data;
 
-  if(memcmp(header->magic, "ARC\0", 4) != 0)
+  if(file_size < sizeof(ArcHeader) || memcmp(header->magic, "ARC\0", 4) != 0)
+  {
+    platform_munmap(data, file_size);
+    return(NULL);
+  }
+
+  uint64_t filenames_offset = (uint64_t)header->toc_offset +
+                              (uint64_t)header->num_parts * sizeof(TQArcPart);
+  uint64_t records_size = (uint64_t)header->num_files * sizeof(ArcFileRecord);
+
+  if(filenames_offset > file_size || records_size > file_size - filenames_offset)
   {
     platform_munmap(data, file_size);
     return(NULL);
@@ -62,34 +82,38 @@ arc_load(const char *filepath)
   arc->raw_data = data;
   arc->data_size = file_size;
   arc->num_files = header->num_files;
-  arc->entries = calloc(arc->num_files, sizeof(TQArcEntry));
+  arc->entries = calloc(arc->num_files ? arc->num_files : 1, sizeof(TQArcEntry));
   arc->num_parts = header->num_parts;
-  arc->parts = calloc(arc->num_parts, sizeof(TQArcPart));
+  arc->parts = calloc(arc->num_parts ? arc->num_parts : 1, sizeof(TQArcPart));
 
   if(!arc->entries || !arc->parts)
   {
-    free(arc->entries);
-    free(arc->parts);
-    free(arc->filepath);
-    platform_munmap(data, file_size);
-    free(arc);
+    arc_free(arc);
     return(NULL);
   }
 
   memcpy(arc->parts, data + header->toc_offset, arc->num_parts * sizeof(TQArcPart));
 
-  size_t filenames_offset = header->toc_offset + arc->num_parts * sizeof(TQArcPart);
-
   // Read records from end
-  ArcFileRecord *records = (ArcFileRecord *)(data + file_size - 44LL * header->num_files);
+  size_t records_offset = file_size - (size_t)records_size;
+  ArcFileRecord *records = (ArcFileRecord *)(data + records_offset);
 
-  // Read filenames sequentially
-  uint8_t *name_ptr = data + filenames_offset;
+  // Read filenames sequentially; each must end before the records
+  const char *name_ptr = (const char *)data + filenames_offset;
+  const char *names_end = (const char *)data + records_offset;
 
   for(uint32_t i = 0; i < header->num_files; i++)
   {
-    arc->entries[i].path = strdup((char *)name_ptr);
-    name_ptr += strlen((char *)name_ptr) + 1;
+    const char *nul = name_ptr < names_end ? memchr(name_ptr, '\0', names_end - name_ptr) : NULL;
+
+    if(!nul)
+    {
+      arc_free(arc);
+      return(NULL);
+    }
+
+    arc->entries[i].path = name_ptr;
+    name_ptr = nul + 1;
 
     arc->entries[i].real_size = records[i].real_size;
     arc->entries[i].num_parts = records[i].num_parts;
@@ -99,107 +123,506 @@ arc_load(const char *filepath)
   return(arc);
 }
 
-// decompress_part -- decompress a single compressed part.
-// src: pointer to compressed data.
-// comp_size: size of compressed data in bytes.
-// real_size: expected uncompressed size in bytes.
-// returns: malloc'd buffer with decompressed data, or NULL on failure.
-static uint8_t *
-decompress_part(const uint8_t *src, uint32_t comp_size, uint32_t real_size)
+// arc_index_build -- hash every entry name.
+// arc: the archive file.
+// returns: new index, or NULL on allocation failure.
+static TQArcIndex *
+arc_index_build(const TQArcFile *arc)
 {
-  uint8_t *dest = malloc(real_size);
+  // keep the table at most half full so probe runs stay short
+  uint32_t num_slots = 16;
+
+  while(num_slots < arc->num_files * 2ULL)
+    num_slots <<= 1;
+
+  TQArcIndex *index = malloc(sizeof(TQArcIndex));
 
-  if(!dest)
+  if(!index)
     return(NULL);
 
-  uLongf dest_len = real_size;
+  index->mask = num_slots - 1;
+  index->slots = calloc(num_slots, sizeof(uint32_t));
+  index->hashes = malloc((arc->num_files ? arc->num_files : 1) * sizeof(uint64_t));
 
-  if(uncompress(dest, &dest_len, src, comp_size) != Z_OK)
+  if(!index->slots || !index->hashes)
   {
-    if(comp_size == real_size)
-      memcpy(dest, src, real_size);
-    else
+    free(index->slots);
+    free(index->hashes);
+    free(index);
+    return(NULL);
+  }
+
+  // inserting in entry order keeps the first of any duplicate names first
+  // on its probe run, as the old linear scan found it
+  for(uint32_t i = 0; i < arc->num_files; i++)
+  {
+    uint64_t hash = path_hash(arc->entries[i].path);
+    uint32_t slot = (uint32_t)hash & index->mask;
+
+    while(index->slots[slot])
+      slot = (slot + 1) & index->mask;
+
+    index->slots[slot] = i + 1;
+    index->hashes[i] = hash;
+  }
+
+  return(index);
+}
+
+// arc_index_free -- free a name index.
+// index: index to free (NULL is safe).
+static void
+arc_index_free(TQArcIndex *index)
+{
+  if(!index)
+    return;
+
+  free(index->slots);
+  free(index->hashes);
+  free(index);
+}
+
+// arc_find -- find an entry by name, building the name index on first use.
+// arc: the archive file.
+// path: name to look up (case and separator style are ignored).
+// returns: entry index, or -1 if not found.
+int
+arc_find(TQArcFile *arc, const char *path)
+{
+  if(!arc || !path)
+    return(-1);
+
+  TQArcIndex *index = g_atomic_pointer_get(&arc->index);
+
+  if(!index)
+  {
+    index = arc_index_build(arc);
+
+    if(!index)
     {
-      free(dest);
-      return(NULL);
+      for(uint32_t i = 0; i < arc->num_files; i++)
+        if(path_equal(arc->entries[i].path, path))
+          return((int)i);
+
+      return(-1);
+    }
+
+    // another thread may have built it first; keep theirs
+    if(!g_atomic_pointer_compare_and_exchange(&arc->index, NULL, index))
+    {
+      arc_index_free(index);
+      index = g_atomic_pointer_get(&arc->index);
     }
   }
 
-  return(dest);
+  uint64_t hash = path_hash(path);
+
+  for(uint32_t slot = (uint32_t)hash & index->mask; ; slot = (slot + 1) & index->mask)
+  {
+    uint32_t v = index->slots[slot];
+
+    if(!v)
+      return(-1);
+
+    if(index->hashes[v - 1] == hash && path_equal(arc->entries[v - 1].path, path))
+      return((int)(v - 1));
+  }
 }
 
-// arc_extract_file_at -- extract a file from a specific offset and size.
+// looks_like_zlib -- check for a zlib stream header (deflate, valid check bits).
+// src: data to check.
+// size: size of src in bytes.
+// returns: true if src starts like a zlib stream.
+static bool
+looks_like_zlib(const uint8_t *src, uint32_t size)
+{
+  return(size >= 2 && (src[0] & 0x0f) == 8 && ((src[0] << 8) | src[1]) % 31 == 0);
+}
+
+// arc_view_at -- get a file's contents without copying stored data.
 // arc: the archive file.
 // offset: byte offset into the archive.
 // compressed_size: compressed data size.
 // real_size: uncompressed data size.
-// out_size: on success, set to the extracted data size.
-// returns: malloc'd buffer with extracted data, or NULL on failure.
-uint8_t *
-arc_extract_file_at(TQArcFile *arc, uint32_t offset, uint32_t compressed_size,
-                    uint32_t real_size, size_t *out_size)
+// buf: buffer to inflate compressed data into, or NULL.
+// buf_size: size of buf in bytes.
+// view: receives the contents.
+// returns: true on success.
+bool
+arc_view_at(TQArcFile *arc, uint32_t offset, uint32_t compressed_size,
+            uint32_t real_size, uint8_t *buf, size_t buf_size, TQArcView *view)
 {
+  memset(view, 0, sizeof(*view));
+
   if(!arc || !arc->raw_data)
-    return(NULL);
+    return(false);
 
   if((size_t)offset + compressed_size > arc->data_size)
-    return(NULL);
+    return(false);
 
-  uint8_t *data = decompress_part(arc->raw_data + offset, compressed_size, real_size);
+  const uint8_t *src = arc->raw_data + offset;
 
-  if(data)
-    *out_size = real_size;
+  // stored parts have equal sizes; a zlib header means it may still need
+  // inflating, so try that first
+  if(compressed_size == real_size && !looks_like_zlib(src, compressed_size))
+  {
+    view->data = src;
+    view->size = real_size;
+    return(true);
+  }
 
-  return(data);
+  uint8_t *dest = buf;
+
+  if(!buf || buf_size < real_size)
+  {
+    view->owned = malloc(real_size ? real_size : 1);
+    if(!view->owned)
+      return(false);
+    dest = view->owned;
+  }
+
+  uLongf dest_len = real_size;
+
+  if(uncompress(dest, &dest_len, src, compressed_size) != Z_OK)
+  {
+    free(view->owned);
+    view->owned = NULL;
+
+    if(compressed_size != real_size)
+      return(false);
+
+    dest = (uint8_t *)src;
+  }
+
+  view->data = dest;
+  view->size = real_size;
+  return(true);
 }
 
-// arc_extract_file -- extract a file from the archive by entry index.
+// Files at least this large are inflated on several threads when they
+// have more than one part; below it thread hand-off costs more than it saves.
+#define ARC_PARALLEL_MIN_SIZE (512u * 1024)
+#define ARC_MAX_INFLATE_THREADS 8
+
+// ArcInflateJob -- the parts of one file, claimed one at a time by the
+// calling thread and any pool helpers.
+typedef struct {
+  const TQArcFile *arc;
+  const TQArcPart *parts;     // first part of the run
+  const size_t *dest_offsets; // where each part goes in dest
+  uint8_t *dest;
+  uint32_t num_parts;
+  gint next;                  // next part to claim (atomic)
+  gint failed;                // set when a part cannot be read (atomic)
+  int helpers;                // helpers still running (under lock)
+  GMutex lock;
+  GCond done;
+} ArcInflateJob;
+
+static GThreadPool *g_inflate_pool = NULL;
+
+// inflate_part -- inflate (or copy, if stored) one part.
+// arc: the archive file.
+// part: part to read; its bounds have been checked.
+// dest: buffer of at least part->real_size bytes.
+// returns: true on success.
+static bool
+inflate_part(const TQArcFile *arc, const TQArcPart *part, uint8_t *dest)
+{
+  const uint8_t *src = arc->raw_data + part->file_offset;
+
+  if(part->compressed_size == part->real_size && !looks_like_zlib(src, part->compressed_size))
+  {
+    memcpy(dest, src, part->real_size);
+    return(true);
+  }
+
+  uLongf dest_len = part->real_size;
+
+  if(uncompress(dest, &dest_len, src, part->compressed_size) == Z_OK)
+    return(true);
+
+  if(part->compressed_size != part->real_size)
+    return(false);
+
+  memcpy(dest, src, part->real_size);
+  return(true);
+}
+
+// inflate_job_run -- claim and inflate parts until none are left.
+// job: shared job.
+static void
+inflate_job_run(ArcInflateJob *job)
+{
+  for(;;)
+  {
+    uint32_t i = (uint32_t)g_atomic_int_add(&job->next, 1);
+
+    if(i >= job->num_parts)
+      break;
+
+    if(!inflate_part(job->arc, &job->parts[i], job->dest + job->dest_offsets[i]))
+      g_atomic_int_set(&job->failed, 1);
+  }
+}
+
+// inflate_helper -- thread pool function: help with a job, then check out.
+// data: ArcInflateJob.
+// user_data: unused.
+static void
+inflate_helper(gpointer data, gpointer user_data)
+{
+  ArcInflateJob *job = data;
+
+  (void)user_data;
+
+  inflate_job_run(job);
+
+  g_mutex_lock(&job->lock);
+  if(--job->helpers == 0)
+    g_cond_signal(&job->done);
+  g_mutex_unlock(&job->lock);
+}
+
+// inflate_pool -- the shared helper pool, created on first use.
+// returns: thread pool, or NULL if it could not be created.
+static GThreadPool *
+inflate_pool(void)
+{
+  static gsize once = 0;
+
+  if(g_once_init_enter(&once))
+  {
+    int threads = (int)g_get_num_processors();
+
+    if(threads > ARC_MAX_INFLATE_THREADS)
+      threads = ARC_MAX_INFLATE_THREADS;
+
+    if(threads > 1)
+      g_inflate_pool = g_thread_pool_new(inflate_helper, NULL, threads - 1, FALSE, NULL);
+
+    g_once_init_leave(&once, 1);
+  }
+
+  return(g_inflate_pool);
+}
+
+// arc_read_parts -- inflate a run of parts into one buffer.
+// arc: the archive file.
+// first_part: index of the first part in arc->parts.
+// real_size: uncompressed size of the whole file.
+// dest: buffer of at least real_size bytes.
+// max_threads: threads to use at most (0 = pick automatically).
+// returns: true on success.
+bool
+arc_read_parts(TQArcFile *arc, uint32_t first_part, uint32_t real_size,
+               uint8_t *dest, int max_threads)
+{
+  if(!arc || !arc->raw_data || first_part >= arc->num_parts)
+    return(false);
+
+  // the run is the parts whose sizes add up to the file size
+  uint32_t num_parts = 0;
+  size_t total = 0;
+
+  while(total < real_size)
+  {
+    if(first_part + num_parts >= arc->num_parts)
+      return(false);
+
+    const TQArcPart *part = &arc->parts[first_part + num_parts];
+
+    if((size_t)part->file_offset + part->compressed_size > arc->data_size ||
+       total + part->real_size > real_size)
+      return(false);
+
+    total += part->real_size;
+    num_parts++;
+  }
+
+  size_t *dest_offsets = malloc((num_parts ? num_parts : 1) * sizeof(size_t));
+
+  if(!dest_offsets)
+    return(false);
+
+  total = 0;
+  for(uint32_t i = 0; i < num_parts; i++)
+  {
+    dest_offsets[i] = total;
+    total += arc->parts[first_part + i].real_size;
+  }
+
+  ArcInflateJob job = {
+    .arc = arc,
+    .parts = &arc->parts[first_part],
+    .dest_offsets = dest_offsets,
+    .dest = dest,
+    .num_parts = num_parts,
+  };
+
+  if(max_threads <= 0)
+    max_threads = real_size >= ARC_PARALLEL_MIN_SIZE ? ARC_MAX_INFLATE_THREADS : 1;
+
+  GThreadPool *pool = (max_threads > 1 && num_parts > 1) ? inflate_pool() : NULL;
+  int helpers = 0;
+
+  if(pool)
+  {
+    helpers = max_threads - 1;
+    if((uint32_t)helpers > num_parts - 1)
+      helpers = (int)num_parts - 1;
+  }
+
+  g_mutex_init(&job.lock);
+  g_cond_init(&job.done);
+  job.helpers = helpers;
+
+  for(int i = 0; i < helpers; i++)
+    g_thread_pool_push(pool, &job, NULL);
+
+  // the caller works too, so the job finishes even if every helper is busy
+  inflate_job_run(&job);
+
+  g_mutex_lock(&job.lock);
+  while(job.helpers > 0)
+    g_cond_wait(&job.done, &job.lock);
+  g_mutex_unlock(&job.lock);
+
+  g_mutex_clear(&job.lock);
+  g_cond_clear(&job.done);
+  free(dest_offsets);
+  return(!g_atomic_int_get(&job.failed));
+}
+
+// arc_view_parts -- get the contents of a multi-part file.
+// arc: the archive file.
+// first_part: index of the first part in arc->parts.
+// real_size: uncompressed size of the whole file.
+// buf: buffer to inflate into, or NULL.
+// buf_size: size of buf in bytes.
+// view: receives the contents.
+// returns: true on success.
+bool
+arc_view_parts(TQArcFile *arc, uint32_t first_part, uint32_t real_size,
+               uint8_t *buf, size_t buf_size, TQArcView *view)
+{
+  memset(view, 0, sizeof(*view));
+
+  uint8_t *dest = buf;
+
+  if(!buf || buf_size < real_size)
+  {
+    view->owned = malloc(real_size ? real_size : 1);
+    if(!view->owned)
+      return(false);
+    dest = view->owned;
+  }
+
+  if(!arc_read_parts(arc, first_part, real_size, dest, 0))
+  {
+    arc_view_release(view);
+    return(false);
+  }
+
+  view->data = dest;
+  view->size = real_size;
+  return(true);
+}
+
+// arc_view_file -- get the contents of an entry by index.
 // arc: the archive file.
 // entry_index: index into arc->entries.
-// out_size: on success, set to the extracted data size.
-// returns: malloc'd buffer with extracted data, or NULL on failure.
-uint8_t *
-arc_extract_file(TQArcFile *arc, uint32_t entry_index, size_t *out_size)
+// buf: buffer to inflate compressed data into, or NULL.
+// buf_size: size of buf in bytes.
+// view: receives the contents.
+// returns: true on success.
+bool
+arc_view_file(TQArcFile *arc, uint32_t entry_index, uint8_t *buf, size_t buf_size,
+              TQArcView *view)
 {
+  memset(view, 0, sizeof(*view));
+
   if(!arc || !arc->raw_data || entry_index >= arc->num_files)
-    return(NULL);
+    return(false);
 
   TQArcEntry *entry = &arc->entries[entry_index];
 
-  uint8_t *real_data = malloc(entry->real_size);
+  if(entry->num_parts == 1 && entry->first_part_index < arc->num_parts)
+  {
+    TQArcPart *part = &arc->parts[entry->first_part_index];
 
-  if(!real_data)
-    return(NULL);
+    if(part->real_size == entry->real_size)
+      return(arc_view_at(arc, part->file_offset, part->compressed_size,
+                         part->real_size, buf, buf_size, view));
+  }
+
+  return(arc_view_parts(arc, entry->first_part_index, entry->real_size, buf, buf_size, view));
+}
+
+// arc_view_release -- free the buffer a view allocated, if any.
+// view: view to release.
+void
+arc_view_release(TQArcView *view)
+{
+  free(view->owned);
+  memset(view, 0, sizeof(*view));
+}
 
-  size_t current_offset = 0;
+// view_take -- turn a view into a malloc'd buffer the caller owns.
+// view: filled-in view (consumed).
+// out_size: set to the data size.
+// returns: malloc'd buffer, or NULL on allocation failure.
+static uint8_t *
+view_take(TQArcView *view, size_t *out_size)
+{
+  uint8_t *data = view->owned;
 
-  for(uint32_t p = 0; p < entry->num_parts; p++)
+  if(!data)
   {
-    uint32_t part_idx = entry->first_part_index + p;
+    data = malloc(view->size ? view->size : 1);
+    if(data)
+      memcpy(data, view->data, view->size);
+  }
 
-    if(part_idx >= arc->num_parts)
-      break;
+  if(data)
+    *out_size = view->size;
 
-    TQArcPart *part = &arc->parts[part_idx];
+  return(data);
+}
 
-    if((size_t)part->file_offset + part->compressed_size > arc->data_size)
-      break;
+// arc_extract_file_at -- extract a file from a specific offset and size.
+// arc: the archive file.
+// offset: byte offset into the archive.
+// compressed_size: compressed data size.
+// real_size: uncompressed data size.
+// out_size: on success, set to the extracted data size.
+// returns: malloc'd buffer with extracted data, or NULL on failure.
+uint8_t *
+arc_extract_file_at(TQArcFile *arc, uint32_t offset, uint32_t compressed_size,
+                    uint32_t real_size, size_t *out_size)
+{
+  TQArcView view;
 
-    uLongf dest_len = part->real_size;
+  if(!arc_view_at(arc, offset, compressed_size, real_size, NULL, 0, &view))
+    return(NULL);
 
-    if(uncompress(real_data + current_offset, &dest_len,
-                  arc->raw_data + part->file_offset, part->compressed_size) != Z_OK)
-    {
-      if(part->compressed_size == part->real_size)
-        memcpy(real_data + current_offset,
-               arc->raw_data + part->file_offset, part->real_size);
-    }
+  return(view_take(&view, out_size));
+}
 
-    current_offset += part->real_size;
-  }
+// arc_extract_file -- extract a file from the archive by entry index.
+// arc: the archive file.
+// entry_index: index into arc->entries.
+// out_size: on success, set to the extracted data size.
+// returns: malloc'd buffer with extracted data, or NULL on failure.
+uint8_t *
+arc_extract_file(TQArcFile *arc, uint32_t entry_index, size_t *out_size)
+{
+  TQArcView view;
+
+  if(!arc_view_file(arc, entry_index, NULL, 0, &view))
+    return(NULL);
 
-  *out_size = entry->real_size;
-  return(real_data);
+  return(view_take(&view, out_size));
 }
 
 // arc_free -- free all resources associated with an ARC archive.
@@ -210,9 +633,7 @@ arc_free(TQArcFile *arc)
   if(!arc)
     return;
 
-  for(uint32_t i = 0; i < arc->num_files; i++)
-    free(arc->entries[i].path);
-
+  arc_index_free(arc->index);
   free(arc->entries);
   free(arc->parts);
   free(arc->filepath);
@@ -12,12 +12,15 @@ typedef struct {
 } TQArcPart;
 
 typedef struct {
-  char *path;
+  const char *path;   // name in the archive (points into raw_data)
   uint32_t real_size;
   uint32_t num_parts;
   uint32_t first_part_index;
 } TQArcEntry;
 
+// TQArcIndex - name lookup table, built on first use by arc_find()
+typedef struct TQArcIndex TQArcIndex;
+
 typedef struct {
   char *filepath;
   uint32_t num_files;
@@ -26,8 +29,18 @@ typedef struct {
   TQArcPart *parts;
   uint8_t *raw_data;  // mmap'd file data (or NULL)
   size_t data_size;   // size of mmap'd region
+  TQArcIndex *index;  // lazily built by arc_find() (NULL until then)
 } TQArcFile;
 
+// TQArcView - the contents of one archived file. Stored (uncompressed) data
+// is borrowed straight from the archive mapping; compressed data is inflated
+// into the caller's buffer when it fits, or into a malloc'd one.
+typedef struct {
+  const uint8_t *data;  // file contents (valid while the archive is loaded)
+  size_t size;          // size of data in bytes
+  uint8_t *owned;       // malloc'd buffer backing data, or NULL
+} TQArcView;
+
 // arc_load - load and parse an ARC archive file
 // filepath: path to the .arc file
 // returns: parsed archive, or NULL on failure
@@ -37,6 +50,14 @@ TQArcFile *arc_load(const char *filepath);
 // arc: archive to free
 void arc_free(TQArcFile *arc);
 
+// arc_find - find an entry by its name in the archive. The first call builds
+// a hash index over the entry names; later calls are a hash probe.
+// Safe to call from several threads.
+// arc: the archive file
+// path: name to look up (case and separator style are ignored)
+// returns: entry index, or -1 if the archive has no such entry
+int arc_find(TQArcFile *arc, const char *path);
+
 // arc_extract_file - extract a file from the archive by entry index
 // arc: the archive file
 // entry_index: index into arc->entries
@@ -55,4 +76,58 @@ uint8_t *arc_extract_file_at(TQArcFile *arc, uint32_t offset,
                              uint32_t compressed_size, uint32_t real_size,
                              size_t *out_size);
 
+// arc_view_at - get a file's contents from a specific offset and size
+// without copying stored data
+// arc: the archive file
+// offset: byte offset into the archive
+// compressed_size: compressed data size
+// real_size: uncompressed data size
+// buf: buffer to inflate compressed data into, or NULL
+// buf_size: size of buf in bytes
+// view: receives the contents; release with arc_view_release()
+// returns: true on success
+bool arc_view_at(TQArcFile *arc, uint32_t offset, uint32_t compressed_size,
+                 uint32_t real_size, uint8_t *buf, size_t buf_size, TQArcView *view);
+
+// arc_view_file - get the contents of an entry by index, like arc_view_at()
+// arc: the archive file
+// entry_index: index into arc->entries
+// buf: buffer to inflate compressed data into, or NULL
+// buf_size: size of buf in bytes
+// view: receives the contents; release with arc_view_release()
+// returns: true on success
+bool arc_view_file(TQArcFile *arc, uint32_t entry_index, uint8_t *buf, size_t buf_size,
+                   TQArcView *view);
+
+// arc_view_parts - get the contents of a file stored as a run of parts (as
+// recorded in the resource index), inflating the parts in parallel when
+// the file is large
+// arc: the archive file
+// first_part: index of the first part in arc->parts
+// real_size: uncompressed size of the whole file (the run is the parts whose
+//            sizes add up to it)
+// buf: buffer to inflate into, or NULL
+// buf_size: size of buf in bytes
+// view: receives the contents; release with arc_view_release()
+// returns: true on success
+bool arc_view_parts(TQArcFile *arc, uint32_t first_part, uint32_t real_size,
+                    uint8_t *buf, size_t buf_size, TQArcView *view);
+
+// arc_read_parts - inflate a run of parts into one buffer. Parts are
+// independent zlib streams, so they are spread over a shared thread pool
+// with the caller taking parts too.
+// arc: the archive file
+// first_part: index of the first part in arc->parts
+// real_size: uncompressed size of the whole file
+// dest: buffer of at least real_size bytes
+// max_threads: threads to use at most, including the caller (0 = one for
+//              small files, several for large ones)
+// returns: true on success
+bool arc_read_parts(TQArcFile *arc, uint32_t first_part, uint32_t real_size,
+                    uint8_t *dest, int max_threads);
+
+// arc_view_release - free the buffer a view allocated, if any
+// view: view filled in by arc_view_at() or arc_view_file()
+void arc_view_release(TQArcView *view);
+
 #endif
@@ -1,42 +1,107 @@
 #include "arz.h"
+#include "path_hash.h"
 #include "platform_mmap.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <strings.h>
 #include <zlib.h>
 
-// ── string intern table ───────────────────────────────────────────
-
-// lowercase string -> canonical pointer
-static GHashTable *g_intern_table = NULL;
+// ── symbol table ──────────────────────────────────────────────────
+
+// Every interned name is stored right after its 4-byte symbol id, so
+// arz_sym() maps a name pointer to its id without a lookup. Builtin names
+// live in a static table; others are allocated as SymName blocks.
+
+typedef struct {
+  TQArzSym id;
+  char name[];
+} SymName;
+
+// builtin names: one member per ARZ_SYMBOLS entry, id then string
+#define X(n) struct { TQArzSym id; char name[sizeof(#n)]; } n;
+static const struct { ARZ_SYMBOLS(X) } g_builtin_syms = {
+#undef X
+#define X(n) .n = { ARZ_SYM_##n, #n },
+  ARZ_SYMBOLS(X)
+#undef X
+};
+
+#define X(n) const char *const INT_##n = g_builtin_syms.n.name;
+ARZ_SYMBOLS(X)
+#undef X
+
+static GRWLock g_intern_lock;
+static GHashTable *g_intern_table = NULL;  // lowercase name -> canonical pointer
+static GPtrArray *g_sym_names = NULL;       // symbol id -> canonical pointer
+
+// intern_register -- add a canonical name under its lowercase key.
+// Called with g_intern_lock held for writing.
+// lower: lowercase key (copied).
+// canonical: interned pointer, preceded by its symbol id.
+static void
+intern_register(const char *lower, const char *canonical)
+{
+  g_hash_table_insert(g_intern_table, g_strdup(lower), (gpointer)canonical);
+  g_ptr_array_add(g_sym_names, (gpointer)canonical);
+}
 
-// arz_intern_init -- initialize the string interning system.
-// creates the global hash table if it does not already exist.
-void
-arz_intern_init(void)
+// intern_init_locked -- create the tables and register the builtin names.
+// Called with g_intern_lock held for writing.
+static void
+intern_init_locked(void)
 {
   if(g_intern_table)
     return;
 
   g_intern_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  g_sym_names = g_ptr_array_new();
+  g_ptr_array_add(g_sym_names, NULL);  // ARZ_SYM_NONE
+
+  // registered in enum order, so each builtin's index equals its id
+  static const char *const builtins[] = {
+#define X(n) g_builtin_syms.n.name,
+    ARZ_SYMBOLS(X)
+#undef X
+  };
+
+  for(size_t i = 0; i < G_N_ELEMENTS(builtins); i++)
+  {
+    char lower[128];
+    size_t j = 0;
+
+    for(; builtins[i][j] && j < sizeof(lower) - 1; j++)
+      lower[j] = g_ascii_tolower(builtins[i][j]);
+
+    lower[j] = '\0';
+    intern_register(lower, builtins[i]);
+  }
+}
+
+// arz_intern_init -- initialize the string interning system.
+// creates the symbol tables and registers the builtin symbols.
+void
+arz_intern_init(void)
+{
+  g_rw_lock_writer_lock(&g_intern_lock);
+  intern_init_locked();
+  g_rw_lock_writer_unlock(&g_intern_lock);
 }
 
 // arz_intern -- intern a variable name string (case-insensitive).
 // name: variable name to intern.
-// returns: canonical lowercased pointer for this name, or NULL if name is NULL.
+// returns: canonical pointer for this name (an INT_* constant for builtin
+//          names, otherwise a lowercased copy), or NULL if name is NULL.
 const char *
 arz_intern(const char *name)
 {
   if(!name)
     return(NULL);
 
-  if(!g_intern_table)
-    arz_intern_init();
-
-  // Lowercase the name for canonical form
+  // Lowercase the name for the lookup key; short names (all of them in
+  // practice) stay on the stack, so interning a known name never allocates
   size_t len = strlen(name);
-  char *lower = malloc(len + 1);
+  char stack_buf[256];
+  char *lower = len < sizeof(stack_buf) ? stack_buf : malloc(len + 1);
 
   if(!lower)
     return(NULL);
@@ -44,70 +109,126 @@ arz_intern(const char *name)
   for(size_t i = 0; i <= len; i++)
     lower[i] = (name[i] >= 'A' && name[i] <= 'Z') ? name[i] + 32 : name[i];
 
-  const char *existing = g_hash_table_lookup(g_intern_table, lower);
+  const char *existing = NULL;
+
+  g_rw_lock_reader_lock(&g_intern_lock);
 
-  if(existing)
+  if(g_intern_table)
+    existing = g_hash_table_lookup(g_intern_table, lower);
+
+  g_rw_lock_reader_unlock(&g_intern_lock);
+
+  if(!existing)
   {
-    free(lower);
-    return(existing);
+    g_rw_lock_writer_lock(&g_intern_lock);
+    intern_init_locked();
+
+    // another thread may have added it between the two locks
+    existing = g_hash_table_lookup(g_intern_table, lower);
+
+    if(!existing)
+    {
+      SymName *sn = malloc(sizeof(SymName) + len + 1);
+
+      if(sn)
+      {
+        sn->id = g_sym_names->len;
+        memcpy(sn->name, lower, len + 1);
+        intern_register(lower, sn->name);
+        existing = sn->name;
+      }
+    }
+
+    g_rw_lock_writer_unlock(&g_intern_lock);
   }
 
-  // lower becomes the canonical copy owned by the hash table
-  g_hash_table_insert(g_intern_table, lower, lower);
-  return(lower);
+  if(lower != stack_buf)
+    free(lower);
+
+  return(existing);
+}
+
+// arz_sym_name -- interned name of a symbol.
+// sym: symbol id.
+// returns: canonical interned pointer, or NULL if sym is unknown.
+const char *
+arz_sym_name(TQArzSym sym)
+{
+  const char *name = NULL;
+
+  g_rw_lock_reader_lock(&g_intern_lock);
+
+  if(g_sym_names && sym < g_sym_names->len)
+    name = g_sym_names->pdata[sym];
+
+  g_rw_lock_reader_unlock(&g_intern_lock);
+  return(name);
 }
 
 // arz_intern_free -- free the string interning system.
-// destroys the global hash table and sets it to NULL.
+// destroys the symbol tables; builtin INT_* pointers stay valid.
 void
 arz_intern_free(void)
 {
+  g_rw_lock_writer_lock(&g_intern_lock);
+
   if(g_intern_table)
   {
+    for(guint i = ARZ_NUM_BUILTIN_SYMS; i < g_sym_names->len; i++)
+    {
+      const char *name = g_sym_names->pdata[i];
+
+      free((uint8_t *)name - offsetof(SymName, name));
+    }
+
+    g_ptr_array_free(g_sym_names, TRUE);
+    g_sym_names = NULL;
     g_hash_table_destroy(g_intern_table);
     g_intern_table = NULL;
   }
+
+  g_rw_lock_writer_unlock(&g_intern_lock);
 }
 
-// ── var_index building ──────────────────────────────────────────
+// ── variable lookup ─────────────────────────────────────────────
 
-// arz_record_build_var_index -- build the var_index hash table for a record.
-// data: record data to index (NULL is safe, already-indexed is a no-op).
-void
-arz_record_build_var_index(TQArzRecordData *data)
+// arz_record_get_sym -- binary search a record's sorted keys for a symbol.
+// data: record data.
+// sym: symbol id.
+// returns: the first (record order) variable with that name, or NULL.
+TQVariable *
+arz_record_get_sym(const TQArzRecordData *data, TQArzSym sym)
 {
-  if(!data || data->var_index)
-    return;
+  if(!data || sym == ARZ_SYM_NONE)
+    return(NULL);
 
-  data->var_index = g_hash_table_new(g_direct_hash, g_direct_equal);
+  uint32_t low = 0;
+  uint32_t high = data->num_keys;
 
-  for(uint32_t i = 0; i < data->num_vars; i++)
+  while(low < high)
   {
-    if(!data->vars[i].name)
-      continue;
-
-    const char *interned = arz_intern(data->vars[i].name);
+    uint32_t mid = low + (high - low) / 2;
 
-    // Only insert the first occurrence (matches original linear scan behavior)
-    if(!g_hash_table_contains(data->var_index, interned))
-      g_hash_table_insert(data->var_index, (gpointer)interned, &data->vars[i]);
+    if(data->keys[mid].sym < sym)
+      low = mid + 1;
+    else
+      high = mid;
   }
+
+  if(low < data->num_keys && data->keys[low].sym == sym)
+    return(&data->vars[data->keys[low].var]);
+
+  return(NULL);
 }
 
-// arz_record_get_var -- O(1) variable lookup by interned name pointer.
-// data: record data (must have var_index built).
-// interned_name: MUST be an interned pointer from arz_intern().
+// arz_record_get_var -- variable lookup by interned name pointer.
+// data: record data.
+// interned_name: MUST be an interned pointer from arz_intern() or INT_*.
 // returns: pointer to the TQVariable, or NULL if not found.
 TQVariable *
 arz_record_get_var(TQArzRecordData *data, const char *interned_name)
 {
-  if(!data || !interned_name)
-    return(NULL);
-
-  if(!data->var_index)
-    return(NULL);
-
-  return(g_hash_table_lookup(data->var_index, interned_name));
+  return(arz_record_get_sym(data, arz_sym(interned_name)));
 }
 
 // ── low-level readers ─────────────────────────────────────────────
@@ -138,33 +259,6 @@ read_u16(const uint8_t *data, size_t offset)
   return(val);
 }
 
-// read_string_prefixed -- read a length-prefixed string from a byte buffer.
-// data: source buffer.
-// offset: byte offset where the 4-byte length prefix starts.
-// next_offset: if non-NULL, set to the offset after the string.
-// returns: malloc'd null-terminated string.
-static char *
-read_string_prefixed(const uint8_t *data, size_t offset, size_t *next_offset)
-{
-  uint32_t len = read_u32(data, offset);
-  char *str = malloc(len + 1);
-
-  if(!str)
-  {
-    if(next_offset)
-      *next_offset = offset + 4 + len;
-    return(NULL);
-  }
-
-  memcpy(str, data + offset + 4, len);
-  str[len] = '\0';
-
-  if(next_offset)
-    *next_offset = offset + 4 + len;
-
-  return(str);
-}
-
 // arz_load -- load and parse an ARZ database file.
 // filepath: path to the .arz file.
 // returns: parsed TQArzFile, or NULL on failure.
@@ -201,33 +295,58 @@ arz_load(const char *filepath)
   uint32_t record_count = read_u32(data, 12);
   uint32_t string_start = read_u32(data, 16);
 
-  arz->num_strings = read_u32(data, string_start);
-  arz->string_table = calloc(arz->num_strings, sizeof(char *));
+  arz->num_strings = string_start + 4 <= file_size ? read_u32(data, string_start) : 0;
+
+  // The table is a run of length-prefixed strings. Size it in one pass
+  // over the prefixes, then copy every string into a single arena with
+  // NUL terminators: two allocations per ARZ instead of one per string.
+  size_t s_off = (size_t)string_start + 4;
+  size_t arena_size = 0;
 
-  if(!arz->string_table)
+  for(uint32_t i = 0; i < arz->num_strings; i++)
   {
-    free(arz->filepath);
-    platform_munmap(data, file_size);
-    free(arz);
+    uint32_t len = s_off + 4 <= file_size ? read_u32(data, s_off) : UINT32_MAX;
+
+    if(len == UINT32_MAX || s_off + 4 + len > file_size)
+    {
+      arz->num_strings = i;  // truncated table: keep what is there
+      break;
+    }
+
+    arena_size += (size_t)len + 1;
+    s_off += 4 + (size_t)len;
+  }
+
+  arz->string_table = calloc(arz->num_strings ? arz->num_strings : 1, sizeof(char *));
+  arz->string_arena = malloc(arena_size ? arena_size : 1);
+
+  if(!arz->string_table || !arz->string_arena)
+  {
+    arz_free(arz);
     return(NULL);
   }
 
-  size_t s_off = string_start + 4;
+  char *dst = arz->string_arena;
+
+  s_off = (size_t)string_start + 4;
 
   for(uint32_t i = 0; i < arz->num_strings; i++)
-    arz->string_table[i] = read_string_prefixed(data, s_off, &s_off);
+  {
+    uint32_t len = read_u32(data, s_off);
+
+    memcpy(dst, data + s_off + 4, len);
+    dst[len] = '\0';
+    arz->string_table[i] = dst;
+    dst += (size_t)len + 1;
+    s_off += 4 + (size_t)len;
+  }
 
   arz->num_records = record_count;
   arz->records = calloc(record_count, sizeof(TQArzRecord));
 
   if(!arz->records)
   {
-    for(uint32_t i = 0; i < arz->num_strings; i++)
-      free(arz->string_table[i]);
-    free(arz->string_table);
-    free(arz->filepath);
-    platform_munmap(data, file_size);
-    free(arz);
+    arz_free(arz);
     return(NULL);
   }
 
@@ -246,167 +365,398 @@ arz_load(const char *filepath)
     r_off += 16;
   }
 
-  // Pre-intern all string table entries so var_index lookups work
-  for(uint32_t i = 0; i < arz->num_strings; i++)
+  // Symbols are resolved when a record first names a string (see
+  // string_sym), so loading an ARZ interns nothing
+  arz->syms = calloc(arz->num_strings ? arz->num_strings : 1, sizeof(TQArzSym));
+
+  if(!arz->syms)
   {
-    if(arz->string_table[i])
-      arz_intern(arz->string_table[i]);
+    arz_free(arz);
+    return(NULL);
   }
 
   return(arz);
 }
 
-// arz_read_record_at -- read and decompress a record at a specific offset.
-// arz: the database file.
-// offset: byte offset into the raw data.
-// compressed_size: size of the compressed record data.
-// returns: parsed TQArzRecordData with var_index built, or NULL on failure.
-TQArzRecordData *
-arz_read_record_at(TQArzFile *arz, uint32_t offset, uint32_t compressed_size)
+// string_sym -- symbol of a string-table entry, interned on first use.
+// arz: database file.
+// idx: string table index (must be < num_strings).
+// returns: symbol id of the string.
+static TQArzSym
+string_sym(TQArzFile *arz, uint32_t idx)
 {
-  if(!arz || offset + compressed_size > arz->data_size)
-    return(NULL);
+  TQArzSym sym = (TQArzSym)g_atomic_int_get((gint *)&arz->syms[idx]);
 
-  uLong uncompressed_size = 1024 * 1024; // 1MB initial
-  uint8_t *uncompressed = malloc(uncompressed_size);
-
-  if(!uncompressed)
-    return(NULL);
+  // racing threads resolve the same name to the same id, so a plain
+  // publish is enough
+  if(sym == ARZ_SYM_NONE)
+  {
+    sym = arz_sym(arz_intern(arz->string_table[idx]));
+    g_atomic_int_set((gint *)&arz->syms[idx], (gint)sym);
+  }
 
-  int res = uncompress(uncompressed, &uncompressed_size, arz->raw_data + offset, compressed_size);
+  return(sym);
+}
 
-  if(res == Z_BUF_ERROR)
+// sort_keys -- sort record keys by symbol, then record order.
+// keys: keys to sort in place.
+// n: number of keys.
+static void
+sort_keys(TQArzVarKey *keys, uint32_t n)
+{
+  // records have tens of variables; insertion sort beats qsort here and
+  // keeps equal symbols in record order without comparing var
+  for(uint32_t i = 1; i < n; i++)
   {
-    uncompressed_size = 4 * 1024 * 1024; // 4MB
-    uint8_t *new_buf = realloc(uncompressed, uncompressed_size);
+    TQArzVarKey k = keys[i];
+    uint32_t j = i;
 
-    if(!new_buf)
+    while(j > 0 && keys[j - 1].sym > k.sym)
     {
-      free(uncompressed);
-      return(NULL);
+      keys[j] = keys[j - 1];
+      j--;
     }
 
-    uncompressed = new_buf;
-    res = uncompress(uncompressed, &uncompressed_size, arz->raw_data + offset, compressed_size);
+    keys[j] = k;
   }
+}
 
-  if(res != Z_OK)
-  {
-    free(uncompressed);
+// arz_record_parse -- build a TQArzRecordData over decoded record bytes.
+// arz: the database file whose string table the record references.
+// buf: decoded record bytes (ARZ var layout: type, count, name index, values).
+// size: number of bytes in buf.
+// copy: true to copy buf into the record's allocation, false to borrow buf
+//       (it must outlive the record, e.g. an mmap'd cache file).
+// returns: parsed TQArzRecordData in a single allocation, or NULL on failure.
+TQArzRecordData *
+arz_record_parse(TQArzFile *arz, const uint8_t *buf, size_t size, bool copy)
+{
+  if(!arz || !buf || size > UINT32_MAX)
     return(NULL);
-  }
 
   uint32_t num_vars = 0;
+  uint32_t num_keys = 0;
   size_t off = 0;
-  size_t data_pool_size = 0;
+  size_t str_pool_size = 0;
 
-  while(off + 8 <= (size_t)uncompressed_size)
+  while(off + 8 <= size)
   {
-    uint16_t count = read_u16(uncompressed, off + 2);
+    uint16_t type = read_u16(buf, off);
+    uint16_t count = read_u16(buf, off + 2);
+    uint32_t key_idx = read_u32(buf, off + 4);
+
+    if(type == 2)
+      str_pool_size += (size_t)count * sizeof(char *);
+
+    if(key_idx < arz->num_strings)
+      num_keys++;
 
-    data_pool_size += count * 8;
     off += 8 + 4 * (size_t)count;
     num_vars++;
   }
 
-  TQArzRecordData *data = calloc(1, sizeof(TQArzRecordData));
+  // A truncated trailing var would point values past the end of buf
+  if(off > size)
+    return(NULL);
 
-  if(!data)
-  {
-    free(uncompressed);
+  // header | vars | keys | string pointers | raw copy (8-byte aligned, so
+  // numeric values inside it stay 4-byte aligned)
+  size_t vars_off = (sizeof(TQArzRecordData) + 7) & ~(size_t)7;
+  size_t keys_off = vars_off + (size_t)num_vars * sizeof(TQVariable);
+  size_t pool_off = (keys_off + (size_t)num_keys * sizeof(TQArzVarKey) + 7) & ~(size_t)7;
+  size_t raw_off = (pool_off + str_pool_size + 7) & ~(size_t)7;
+  size_t total = raw_off + (copy ? size : 0);
+  uint8_t *block = malloc(total);
+
+  if(!block)
     return(NULL);
-  }
 
+  TQArzRecordData *data = (TQArzRecordData *)block;
+  const char **pool = (const char **)(block + pool_off);
+
+  data->vars = (TQVariable *)(block + vars_off);
   data->num_vars = num_vars;
-  data->vars = calloc(num_vars, sizeof(TQVariable));
-  data->buffer_to_free = uncompressed;
-  data->pool_to_free = malloc(data_pool_size);
-  data->var_index = NULL;
+  data->keys = (TQArzVarKey *)(block + keys_off);
+  data->num_keys = num_keys;
+  data->raw_size = (uint32_t)size;
+  data->bytes = total;
 
-  if(!data->vars || (data_pool_size > 0 && !data->pool_to_free))
+  if(copy)
   {
-    free(data->vars);
-    free(data->pool_to_free);
-    free(uncompressed);
-    free(data);
-    return(NULL);
+    memcpy(block + raw_off, buf, size);
+    buf = block + raw_off;
   }
 
-  size_t pool_off = 0;
+  data->raw = buf;
+
+  uint32_t k = 0;
 
   off = 0;
 
   for(uint32_t i = 0; i < num_vars; i++)
   {
-    uint16_t type = read_u16(uncompressed, off);
-    uint16_t count = read_u16(uncompressed, off + 2);
-    uint32_t key_idx = read_u32(uncompressed, off + 4);
+    uint16_t type = read_u16(buf, off);
+    uint16_t count = read_u16(buf, off + 2);
+    uint32_t key_idx = read_u32(buf, off + 4);
+    TQVariable *v = &data->vars[i];
 
     off += 8;
 
-    data->vars[i].name = (key_idx < arz->num_strings) ? arz->string_table[key_idx] : NULL;
-    data->vars[i].count = count;
+    v->name = (key_idx < arz->num_strings) ? arz->string_table[key_idx] : NULL;
+    v->sym = (key_idx < arz->num_strings) ? string_sym(arz, key_idx) : ARZ_SYM_NONE;
+    v->count = count;
+
+    if(v->sym != ARZ_SYM_NONE)
+    {
+      data->keys[k].sym = v->sym;
+      data->keys[k].var = i;
+      k++;
+    }
 
     if(type == 0 || type == 1 || type == 3)
     {
-      // type 3 = Boolean (4-byte int per ARZ format), treat as INT
-      data->vars[i].type = (type == 1) ? TQ_VAR_FLOAT : TQ_VAR_INT;
-      data->vars[i].value.i32 = (int32_t *)(data->pool_to_free + pool_off);
-      memcpy(data->vars[i].value.i32, uncompressed + off, (size_t)count * 4);
-      pool_off += (size_t)count * 4;
+      // type 3 = Boolean (4-byte int per ARZ format), treat as INT.
+      // Numeric values are 4-byte aligned within buf, so point straight
+      // at them instead of copying into a pool.
+      v->type = (type == 1) ? TQ_VAR_FLOAT : TQ_VAR_INT;
+      v->value.i32 = (int32_t *)(buf + off);
     }
     else if(type == 2)
     {
-      data->vars[i].type = TQ_VAR_STRING;
-      data->vars[i].value.str = (const char **)(data->pool_to_free + pool_off);
+      v->type = TQ_VAR_STRING;
+      v->value.str = pool;
 
       for(uint32_t j = 0; j < count; j++)
       {
-        uint32_t val_idx = read_u32(uncompressed, off + 4 * j);
+        uint32_t val_idx = read_u32(buf, off + 4 * j);
 
-        data->vars[i].value.str[j] = (val_idx < arz->num_strings) ? arz->string_table[val_idx] : NULL;
+        pool[j] = (val_idx < arz->num_strings) ? arz->string_table[val_idx] : NULL;
       }
 
-      pool_off += (size_t)count * sizeof(char *);
+      pool += count;
+    }
+    else
+    {
+      v->type = TQ_VAR_UNKNOWN;
+      v->value.i32 = NULL;
     }
 
     off += 4 * (size_t)count;
   }
 
-  // Build var_index for O(1) lookups
-  arz_record_build_var_index(data);
-
+  sort_keys(data->keys, num_keys);
   return(data);
 }
 
-// arz_read_record -- read a record by its path from the database.
+// InflateScratch -- per-thread decompression buffer, reused across records.
+typedef struct {
+  uint8_t *buf;
+  size_t cap;
+} InflateScratch;
+
+// scratch_free -- GPrivate destructor for a thread's InflateScratch.
+// p: scratch to free.
+static void
+scratch_free(gpointer p)
+{
+  InflateScratch *s = p;
+
+  free(s->buf);
+  free(s);
+}
+
+static GPrivate g_inflate_scratch = G_PRIVATE_INIT(scratch_free);
+
+// arz_read_record_at -- read and decompress a record at a specific offset.
 // arz: the database file.
-// record_path: path of the record to read (case-insensitive, / or \ separators).
-// returns: parsed TQArzRecordData, or NULL if not found.
+// offset: byte offset into the raw data.
+// compressed_size: size of the compressed record data.
+// returns: parsed TQArzRecordData, or NULL on failure.
 TQArzRecordData *
-arz_read_record(TQArzFile *arz, const char *record_path)
+arz_read_record_at(TQArzFile *arz, uint32_t offset, uint32_t compressed_size)
 {
-  if(!arz || !record_path)
+  if(!arz || (size_t)offset + compressed_size > arz->data_size)
+    return(NULL);
+
+  InflateScratch *s = g_private_get(&g_inflate_scratch);
+
+  if(!s)
+  {
+    s = calloc(1, sizeof(InflateScratch));
+
+    if(!s)
+      return(NULL);
+
+    g_private_set(&g_inflate_scratch, s);
+  }
+
+  // ARZ record headers carry no uncompressed size, so inflate into the
+  // thread's scratch buffer, growing it only when a record outgrows it.
+  // Records typically inflate to a few times their compressed size.
+  size_t want = (size_t)compressed_size * 8;
+
+  if(want < 64 * 1024)
+    want = 64 * 1024;
+
+  if(s->cap < want)
+  {
+    uint8_t *nb = realloc(s->buf, want);
+
+    if(!nb)
+      return(NULL);
+
+    s->buf = nb;
+    s->cap = want;
+  }
+
+  z_stream zs;
+
+  memset(&zs, 0, sizeof(zs));
+
+  if(inflateInit(&zs) != Z_OK)
     return(NULL);
 
-  char normalized_path[1024];
+  zs.next_in = arz->raw_data + offset;
+  zs.avail_in = compressed_size;
+  zs.next_out = s->buf;
+  zs.avail_out = (uInt)s->cap;
 
-  strncpy(normalized_path, record_path, sizeof(normalized_path));
-  normalized_path[sizeof(normalized_path) - 1] = '\0';
+  int res;
 
-  for(int i = 0; normalized_path[i]; i++)
+  while((res = inflate(&zs, Z_FINISH)) != Z_STREAM_END)
   {
-    if(normalized_path[i] == '/')
-      normalized_path[i] = '\\';
+    // out of room: double the scratch and keep inflating where we stopped
+    if(res != Z_BUF_ERROR && res != Z_OK)
+      break;
+
+    if(zs.avail_out != 0 || s->cap >= 256 * 1024 * 1024)
+      break;
+
+    size_t used = s->cap - zs.avail_out;
+    uint8_t *nb = realloc(s->buf, s->cap * 2);
+
+    if(!nb)
+      break;
+
+    s->buf = nb;
+    s->cap *= 2;
+    zs.next_out = s->buf + used;
+    zs.avail_out = (uInt)(s->cap - used);
   }
 
+  size_t out_size = zs.total_out;
+
+  inflateEnd(&zs);
+
+  if(res != Z_STREAM_END)
+    return(NULL);
+
+  // copy the exact decoded size into the record's single allocation
+  return(arz_record_parse(arz, s->buf, out_size, true));
+}
+
+// build_path_index -- build the record path hash index.
+// arz: database file.
+// mask: set to the slot mask of the returned table.
+// returns: open-addressed table of (hash top bits << 32 | index + 1), or NULL.
+static uint64_t *
+build_path_index(const TQArzFile *arz, uint32_t *mask)
+{
+  // at most half full, so probe runs stay short
+  uint32_t cap = 16;
+
+  while(cap < arz->num_records * 2u && cap < (1u << 31))
+    cap <<= 1;
+
+  uint64_t *slots = calloc(cap, sizeof(uint64_t));
+
+  if(!slots)
+    return(NULL);
+
   for(uint32_t i = 0; i < arz->num_records; i++)
   {
-    if(arz->records[i].path && strcasecmp(arz->records[i].path, normalized_path) == 0)
-      return(arz_read_record_at(arz, arz->records[i].offset, arz->records[i].compressed_size));
+    if(!arz->records[i].path)
+      continue;
+
+    uint64_t h = path_hash(arz->records[i].path);
+    uint32_t pos = (uint32_t)h & (cap - 1);
+
+    while(slots[pos])
+      pos = (pos + 1) & (cap - 1);
+
+    slots[pos] = (h & 0xffffffff00000000ULL) | (uint64_t)(i + 1);
   }
 
-  return(NULL);
+  *mask = cap - 1;
+  return(slots);
+}
+
+// arz_find_record -- find a record's index by path via the hash index.
+// arz: the database file.
+// record_path: path to find (case-insensitive, / or \ separators).
+// returns: index into arz->records, or -1 if not found. The index is
+//          built on the first call; when a path occurs more than once the
+//          first record in file order is returned, as the old scan did.
+int64_t
+arz_find_record(TQArzFile *arz, const char *record_path)
+{
+  // stands in for the index if it cannot be allocated
+  static uint64_t no_index[1];
+
+  if(!arz || !record_path)
+    return(-1);
+
+  if(g_once_init_enter(&arz->path_index))
+  {
+    uint32_t mask = 0;
+    uint64_t *slots = build_path_index(arz, &mask);
+
+    arz->path_index_mask = mask;
+    g_once_init_leave(&arz->path_index, slots ? slots : no_index);
+  }
+
+  if(arz->path_index == no_index)
+  {
+    for(uint32_t i = 0; i < arz->num_records; i++)
+    {
+      if(arz->records[i].path && path_equal(arz->records[i].path, record_path))
+        return(i);
+    }
+
+    return(-1);
+  }
+
+  uint64_t h = path_hash(record_path);
+  uint64_t tag = h & 0xffffffff00000000ULL;
+  uint32_t mask = arz->path_index_mask;
+
+  // duplicates share a home slot and were inserted in file order, so the
+  // first match along the probe run is the first record in the file
+  for(uint32_t pos = (uint32_t)h & mask; arz->path_index[pos]; pos = (pos + 1) & mask)
+  {
+    uint64_t slot = arz->path_index[pos];
+    uint32_t idx = (uint32_t)(slot & 0xffffffffu) - 1;
+
+    if((slot & 0xffffffff00000000ULL) == tag && path_equal(arz->records[idx].path, record_path))
+      return(idx);
+  }
+
+  return(-1);
+}
+
+// arz_read_record -- read a record by its path from the database.
+// arz: the database file.
+// record_path: path of the record to read (case-insensitive, / or \ separators).
+// returns: parsed TQArzRecordData, or NULL if not found.
+TQArzRecordData *
+arz_read_record(TQArzFile *arz, const char *record_path)
+{
+  int64_t idx = arz_find_record(arz, record_path);
+
+  if(idx < 0)
+    return(NULL);
+
+  return(arz_read_record_at(arz, arz->records[idx].offset, arz->records[idx].compressed_size));
 }
 
 // arz_record_get_string -- get a string variable value from a record.
@@ -423,35 +773,13 @@ arz_record_get_string(TQArzRecordData *data, const char *var_name, bool *found)
   if(!data || !var_name)
     return(NULL);
 
-  // Try fast path via var_index with interned name
-  if(data->var_index)
-  {
-    const char *interned = arz_intern(var_name);
-    TQVariable *v = g_hash_table_lookup(data->var_index, interned);
-
-    if(v && v->type == TQ_VAR_STRING && v->count > 0)
-    {
-      if(found)
-        *found = true;
-      return(v->value.str[0] ? strdup(v->value.str[0]) : NULL);
-    }
-
-    return(NULL);
-  }
+  TQVariable *v = arz_record_get_sym(data, arz_sym(arz_intern(var_name)));
 
-  // Fallback: linear scan
-  for(uint32_t i = 0; i < data->num_vars; i++)
+  if(v && v->type == TQ_VAR_STRING && v->count > 0)
   {
-    if(data->vars[i].name && strcasecmp(data->vars[i].name, var_name) == 0)
-    {
-      if(data->vars[i].type == TQ_VAR_STRING && data->vars[i].count > 0)
-      {
-        if(found)
-          *found = true;
-        return(data->vars[i].value.str[0] ? strdup(data->vars[i].value.str[0]) : NULL);
-      }
-      break;
-    }
+    if(found)
+      *found = true;
+    return(v->value.str[0] ? strdup(v->value.str[0]) : NULL);
   }
 
   return(NULL);
@@ -473,54 +801,32 @@ arz_record_get_int(TQArzRecordData *data, const char *var_name, int default_val,
   if(!data || !var_name)
     return(default_val);
 
-  // Try fast path via var_index
-  if(data->var_index)
-  {
-    const char *interned = arz_intern(var_name);
-    TQVariable *v = g_hash_table_lookup(data->var_index, interned);
-
-    if(v && v->type == TQ_VAR_INT && v->count > 0)
-    {
-      if(found)
-        *found = true;
-      return(v->value.i32[0]);
-    }
+  TQVariable *v = arz_record_get_sym(data, arz_sym(arz_intern(var_name)));
 
-    return(default_val);
-  }
-
-  // Fallback: linear scan
-  for(uint32_t i = 0; i < data->num_vars; i++)
+  if(v && v->type == TQ_VAR_INT && v->count > 0)
   {
-    if(data->vars[i].name && strcasecmp(data->vars[i].name, var_name) == 0)
-    {
-      if(data->vars[i].type == TQ_VAR_INT && data->vars[i].count > 0)
-      {
-        if(found)
-          *found = true;
-        return(data->vars[i].value.i32[0]);
-      }
-      break;
-    }
+    if(found)
+      *found = true;
+    return(v->value.i32[0]);
   }
 
   return(default_val);
 }
 
-// arz_record_data_free -- free a parsed record and all its resources.
+// arz_record_data_bytes -- heap footprint of a parsed record.
+// data: record data (NULL is safe).
+// returns: bytes owned by the record, for cache budgeting.
+size_t
+arz_record_data_bytes(const TQArzRecordData *data)
+{
+  return(data ? data->bytes : 0);
+}
+
+// arz_record_data_free -- free a parsed record (one allocation).
 // data: record data to free (NULL is safe).
 void
 arz_record_data_free(TQArzRecordData *data)
 {
-  if(!data)
-    return;
-
-  if(data->var_index)
-    g_hash_table_destroy(data->var_index);
-
-  free(data->vars);
-  free(data->pool_to_free);
-  free(data->buffer_to_free);
   free(data);
 }
 
@@ -537,14 +843,15 @@ arz_free(TQArzFile *arz)
   if(arz->raw_data)
     platform_munmap(arz->raw_data, arz->data_size);
 
-  if(arz->string_table)
-  {
-    for(uint32_t i = 0; i < arz->num_strings; i++)
-      free(arz->string_table[i]);
-
-    free(arz->string_table);
-  }
+  free(arz->string_table);
+  free(arz->string_arena);
 
+  free(arz->syms);
   free(arz->records);
+
+  // the mask is 0 only for the shared stand-in used when allocation failed
+  if(arz->path_index && arz->path_index_mask)
+    free(arz->path_index);
+
   free(arz);
 }
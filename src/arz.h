@@ -4,7 +4,27 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <string.h>
 #include <glib.h>
+#include "arz_syms.h"
+
+// TQArzSym - dense integer id of an interned variable name (0 = none).
+// Builtin symbols from arz_syms.h have fixed ids; other names get ids
+// as they are first interned.
+typedef uint32_t TQArzSym;
+
+enum {
+  ARZ_SYM_NONE = 0,
+#define X(n) ARZ_SYM_##n,
+  ARZ_SYMBOLS(X)
+#undef X
+  ARZ_NUM_BUILTIN_SYMS
+};
+
+// Constant interned name pointers for the builtin symbols (INT_name)
+#define X(n) extern const char *const INT_##n;
+ARZ_SYMBOLS(X)
+#undef X
 
 typedef struct {
   char *path;
@@ -19,11 +39,18 @@ typedef struct {
   uint8_t *raw_data;
   size_t data_size;
 
-  char **string_table;
+  char **string_table;     // NUL-terminated copies, all in string_arena
+  char *string_arena;
+  TQArzSym *syms;          // symbol of string_table[i], 0 until first use
   uint32_t num_strings;
 
   TQArzRecord *records;
   uint32_t num_records;
+
+  // path -> record hash index, built on first arz_find_record(); each slot
+  // holds the path hash's top 32 bits and record index + 1 (0 = empty)
+  uint64_t *path_index;
+  uint32_t path_index_mask;
 } TQArzFile;
 
 typedef enum {
@@ -35,6 +62,7 @@ typedef enum {
 
 typedef struct {
   const char *name; // pointer to string in arz->string_table
+  TQArzSym sym;     // symbol of name (ARZ_SYM_NONE if unnamed)
   TQVarType type;
   uint32_t count;
   union {
@@ -44,12 +72,22 @@ typedef struct {
   } value;
 } TQVariable;
 
+// TQArzVarKey - lookup key for one variable of a record
+typedef struct {
+  TQArzSym sym;            // symbol of the variable name
+  uint32_t var;            // index into TQArzRecordData.vars
+} TQArzVarKey;
+
+// TQArzRecordData - a decoded record. The struct, its vars, keys, string
+// pointers and (unless borrowed) the raw record bytes share one allocation.
 typedef struct {
-  TQVariable *vars;
+  TQVariable *vars;        // in record order
   uint32_t num_vars;
-  uint8_t *buffer_to_free; // the uncompressed buffer
-  uint8_t *pool_to_free;   // the data pool
-  GHashTable *var_index;   // interned name ptr -> TQVariable*, O(1) lookup
+  TQArzVarKey *keys;       // sorted by sym, then var; named vars only
+  uint32_t num_keys;
+  const uint8_t *raw;      // decoded record bytes; numeric values point here
+  uint32_t raw_size;       // size of raw in bytes
+  size_t bytes;            // size of the allocation
 } TQArzRecordData;
 
 // arz_load - load and parse an ARZ database file
@@ -61,6 +99,12 @@ TQArzFile *arz_load(const char *filepath);
 // arz: database to free
 void arz_free(TQArzFile *arz);
 
+// arz_find_record - find a record's index by path in O(1)
+// arz: database file
+// record_path: record path (case and separator style are ignored)
+// returns: index into arz->records, or -1 if not found
+int64_t arz_find_record(TQArzFile *arz, const char *record_path);
+
 // arz_read_record - read a record by its path from the database
 // arz: database file
 // record_path: path of the record to read
@@ -75,6 +119,16 @@ TQArzRecordData *arz_read_record(TQArzFile *arz, const char *record_path);
 TQArzRecordData *arz_read_record_at(TQArzFile *arz, uint32_t offset,
                                     uint32_t compressed_size);
 
+// arz_record_parse - build a record over already-decoded record bytes
+// arz: database file whose string table the record references
+// buf: decoded record bytes
+// size: number of bytes in buf
+// copy: true to copy buf into the record, false to borrow it (buf must
+//       then outlive the record)
+// returns: parsed record data (free with arz_record_data_free), or NULL
+TQArzRecordData *arz_record_parse(TQArzFile *arz, const uint8_t *buf,
+                                  size_t size, bool copy);
+
 // arz_record_get_string - get a string variable value from a record
 // data: record data
 // var_name: variable name to look up
@@ -92,13 +146,25 @@ char *arz_record_get_string(TQArzRecordData *data, const char *var_name,
 int arz_record_get_int(TQArzRecordData *data, const char *var_name,
                        int default_val, bool *found);
 
-// arz_record_get_var - O(1) variable lookup by interned name pointer
+// arz_record_get_var - variable lookup by interned name pointer
 // data: record data
 // interned_name: MUST be an interned pointer from arz_intern()
 // returns: pointer to variable, or NULL if not found
 TQVariable *arz_record_get_var(TQArzRecordData *data,
                                const char *interned_name);
 
+// arz_record_get_sym - variable lookup by symbol (binary search over the
+// record's sorted keys)
+// data: record data
+// sym: symbol id from arz_sym() or ARZ_SYM_*
+// returns: first variable with that name, or NULL if not found
+TQVariable *arz_record_get_sym(const TQArzRecordData *data, TQArzSym sym);
+
+// arz_record_data_bytes - approximate heap footprint of a parsed record
+// data: record data (NULL is safe)
+// returns: bytes owned by the record, for cache budgeting
+size_t arz_record_data_bytes(const TQArzRecordData *data);
+
 // arz_record_data_free - free a parsed record and all its resources
 // data: record data to free
 void arz_record_data_free(TQArzRecordData *data);
@@ -106,7 +172,8 @@ void arz_record_data_free(TQArzRecordData *data);
 // arz_intern_init - initialize the string interning system
 void arz_intern_init(void);
 
-// arz_intern - intern a variable name string
+// arz_intern - intern a variable name string (thread-safe; allocation-free
+// when the name is already known)
 // name: variable name to intern
 // returns: canonical pointer for this name
 const char *arz_intern(const char *name);
@@ -114,10 +181,24 @@ const char *arz_intern(const char *name);
 // arz_intern_free - free the string interning system
 void arz_intern_free(void);
 
-// arz_record_build_var_index - build the var_index hash table for a record
-// data: record data to index
-// called automatically by arz_read_record_at(), but can be called manually
-// for records constructed by the cache loader
-void arz_record_build_var_index(TQArzRecordData *data);
+// arz_sym - symbol id of an interned name
+// interned: pointer returned by arz_intern() or an INT_* constant
+// returns: its symbol id (read from just before the string, no lookup)
+static inline TQArzSym
+arz_sym(const char *interned)
+{
+  TQArzSym sym;
+
+  if(!interned)
+    return(ARZ_SYM_NONE);
+
+  memcpy(&sym, interned - sizeof(TQArzSym), sizeof(sym));
+  return(sym);
+}
+
+// arz_sym_name - interned name of a symbol
+// sym: symbol id
+// returns: canonical interned pointer, or NULL if sym is unknown
+const char *arz_sym_name(TQArzSym sym);
 
 #endif
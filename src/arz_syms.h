@@ -0,0 +1,163 @@
+#ifndef ARZ_SYMS_H
+#define ARZ_SYMS_H
+
+// Well-known ARZ variable names. Each entry X(name) becomes a builtin
+// symbol with a fixed id (ARZ_SYM_name) and a constant interned name
+// pointer (INT_name) usable directly with arz_record_get_var(). Names are
+// matched case-insensitively like every other interned name.
+#define ARZ_SYMBOLS(X) \
+  X(offensivePhysicalMin) X(offensivePhysicalMax) X(offensivePhysicalChance) \
+  X(offensiveFireMin) X(offensiveFireMax) X(offensiveFireChance) \
+  X(offensiveColdMin) X(offensiveColdMax) X(offensiveColdChance) \
+  X(offensiveLightningMin) X(offensiveLightningMax) X(offensiveLightningChance) \
+  X(offensivePoisonMin) X(offensivePoisonMax) X(offensivePoisonChance) \
+  X(offensivePierceMin) X(offensivePierceMax) X(offensivePierceChance) \
+  X(offensiveElementalMin) X(offensiveElementalMax) X(offensiveElementalChance) \
+  X(offensiveConvertChance) \
+  X(offensiveManaLeechMin) X(offensiveManaLeechMax) \
+  X(offensiveBasePhysicalMin) X(offensiveBasePhysicalMax) \
+  X(offensiveBaseColdMin) X(offensiveBaseColdMax) \
+  X(offensiveBaseFireMin) X(offensiveBaseFireMax) \
+  X(offensiveBaseLightningMin) X(offensiveBaseLightningMax) \
+  X(offensiveBasePoisonMin) X(offensiveBasePoisonMax) \
+  X(offensiveBaseLifeMin) X(offensiveBaseLifeMax) \
+  X(offensiveLifeMin) X(offensiveLifeMax) X(offensiveLifeChance) \
+  X(offensiveBonusPhysicalMin) X(offensiveBonusPhysicalMax) X(offensiveBonusPhysicalChance) \
+  X(offensiveLifeLeechMin) X(offensiveLifeLeechMax) \
+  X(offensiveSlowFireMin) X(offensiveSlowFireMax) X(offensiveSlowFireDurationMin) X(offensiveSlowFireChance) \
+  X(offensiveSlowLightningMin) X(offensiveSlowLightningMax) X(offensiveSlowLightningDurationMin) X(offensiveSlowLightningChance) \
+  X(offensiveSlowColdMin) X(offensiveSlowColdMax) X(offensiveSlowColdDurationMin) X(offensiveSlowColdChance) \
+  X(offensiveSlowPoisonMin) X(offensiveSlowPoisonMax) X(offensiveSlowPoisonDurationMin) X(offensiveSlowPoisonChance) \
+  X(offensiveSlowLifeLeachMin) X(offensiveSlowLifeLeachMax) X(offensiveSlowLifeLeachDurationMin) X(offensiveSlowLifeLeachChance) \
+  X(offensiveSlowLifeMin) X(offensiveSlowLifeMax) X(offensiveSlowLifeDurationMin) X(offensiveSlowLifeChance) \
+  X(offensiveSlowManaLeachMin) X(offensiveSlowManaLeachMax) X(offensiveSlowManaLeachDurationMin) X(offensiveSlowManaLeachChance) \
+  X(offensiveSlowBleedingMin) X(offensiveSlowBleedingMax) X(offensiveSlowBleedingDurationMin) X(offensiveSlowBleedingChance) \
+  X(offensiveSlowBleedingModifier) X(offensiveSlowBleedingModifierChance) \
+  X(offensiveSlowFireModifier) X(offensiveSlowFireModifierChance) \
+  X(offensiveSlowColdModifier) X(offensiveSlowColdModifierChance) \
+  X(offensiveSlowLightningModifier) X(offensiveSlowLightningModifierChance) \
+  X(offensiveSlowPoisonModifier) X(offensiveSlowPoisonModifierChance) \
+  X(offensiveSlowLifeModifier) X(offensiveSlowLifeModifierChance) \
+  X(offensiveSlowLifeLeachModifier) X(offensiveSlowLifeLeachModifierChance) \
+  X(offensiveSlowDefensiveReductionMin) X(offensiveSlowDefensiveReductionDurationMin) \
+  X(offensiveSlowAttackSpeedMin) X(offensiveSlowAttackSpeedDurationMin) \
+  X(offensiveSlowRunSpeedMin) X(offensiveSlowRunSpeedDurationMin) \
+  X(offensiveStunMin) X(offensiveStunDurationMin) X(offensiveStunChance) \
+  X(offensiveFumbleMin) X(offensiveFumbleDurationMin) X(offensiveFumbleChance) \
+  X(offensiveProjectileFumbleMin) X(offensiveProjectileFumbleDurationMin) X(offensiveProjectileFumbleChance) \
+  X(offensiveFreezeMin) X(offensiveFreezeDurationMin) X(offensiveFreezeChance) \
+  X(offensivePetrifyMin) X(offensivePetrifyDurationMin) X(offensivePetrifyChance) \
+  X(offensiveConfusionMin) X(offensiveConfusionDurationMin) X(offensiveConfusionChance) \
+  X(offensiveFearMin) X(offensiveFearMax) X(offensiveFearChance) \
+  X(offensiveConvertMin) \
+  X(retaliationPhysicalMin) X(retaliationPhysicalChance) \
+  X(retaliationFireMin) X(retaliationFireChance) \
+  X(retaliationColdMin) X(retaliationColdChance) \
+  X(retaliationLightningMin) X(retaliationLightningChance) \
+  X(retaliationPierceMin) X(retaliationPierceChance) \
+  X(retaliationSlowFireMin) X(retaliationSlowFireMax) X(retaliationSlowFireDurationMin) X(retaliationSlowFireChance) \
+  X(retaliationSlowColdMin) X(retaliationSlowColdMax) X(retaliationSlowColdDurationMin) X(retaliationSlowColdChance) \
+  X(retaliationSlowLightningMin) X(retaliationSlowLightningMax) X(retaliationSlowLightningDurationMin) X(retaliationSlowLightningChance) \
+  X(retaliationSlowPoisonMin) X(retaliationSlowPoisonMax) X(retaliationSlowPoisonDurationMin) X(retaliationSlowPoisonChance) \
+  X(retaliationSlowLifeMin) X(retaliationSlowLifeMax) X(retaliationSlowLifeDurationMin) X(retaliationSlowLifeChance) \
+  X(retaliationSlowBleedingMin) X(retaliationSlowBleedingMax) X(retaliationSlowBleedingDurationMin) X(retaliationSlowBleedingChance) \
+  X(retaliationSlowLifeLeachMin) X(retaliationSlowLifeLeachMax) X(retaliationSlowLifeLeachDurationMin) X(retaliationSlowLifeLeachChance) \
+  X(retaliationSlowManaLeachMax) \
+  X(retaliationSlowRunSpeedMin) X(retaliationSlowRunSpeedMax) X(retaliationSlowRunSpeedDurationMin) X(retaliationSlowRunSpeedChance) \
+  X(retaliationSlowDefensiveAbilityMin) X(retaliationSlowDefensiveAbilityMax) X(retaliationSlowDefensiveAbilityDurationMin) X(retaliationSlowDefensiveAbilityChance) \
+  X(retaliationSlowOffensiveAbilityMin) X(retaliationSlowOffensiveAbilityMax) X(retaliationSlowOffensiveAbilityDurationMin) X(retaliationSlowOffensiveAbilityChance) \
+  X(retaliationSlowOffensiveReductionMin) X(retaliationSlowOffensiveReductionMax) X(retaliationSlowOffensiveReductionDurationMin) X(retaliationSlowOffensiveReductionChance) \
+  X(offensivePhysicalModifier) X(offensivePhysicalModifierChance) \
+  X(offensiveFireModifier) X(offensiveFireModifierChance) \
+  X(offensiveColdModifier) X(offensiveColdModifierChance) \
+  X(offensiveLightningModifier) X(offensiveLightningModifierChance) \
+  X(offensivePoisonModifier) X(offensivePoisonModifierChance) \
+  X(offensiveLifeModifier) X(offensiveLifeModifierChance) \
+  X(offensivePierceModifier) X(offensivePierceModifierChance) \
+  X(offensiveElementalModifier) X(offensiveElementalModifierChance) \
+  X(offensiveTotalDamageModifier) X(offensiveTotalDamageModifierChance) \
+  X(defensivePhysical) X(defensivePhysicalChance) \
+  X(defensiveFire) X(defensiveFireChance) \
+  X(defensiveCold) X(defensiveColdChance) \
+  X(defensiveLightning) X(defensiveLightningChance) \
+  X(defensivePoison) X(defensivePoisonChance) \
+  X(defensivePierce) X(defensivePierceChance) \
+  X(defensiveLife) X(defensiveLifeChance) \
+  X(defensiveBleeding) X(defensiveBleedingChance) \
+  X(defensiveElementalResistance) X(defensiveElementalResistanceChance) \
+  X(offensivePercentCurrentLifeMin) X(offensivePercentCurrentLifeChance) \
+  X(offensiveTotalDamageReductionPercentMin) X(offensiveTotalDamageReductionPercentChance) \
+  X(offensiveTotalDamageReductionPercentDurationMin) \
+  X(offensiveManaBurnDrainMin) X(offensiveManaBurnDrainMax) X(offensiveManaBurnDrainRatioMin) X(offensiveManaBurnDamageRatio) \
+  X(offensiveManaBurnChance) X(offensiveManaBurnRatioAdder) X(offensiveManaBurnRatioAdderChance) \
+  X(retaliationPhysicalModifier) X(retaliationPhysicalModifierChance) \
+  X(retaliationColdModifier) X(retaliationColdModifierChance) \
+  X(retaliationFireModifier) X(retaliationFireModifierChance) \
+  X(retaliationLightningModifier) X(retaliationLightningModifierChance) \
+  X(retaliationPoisonModifier) X(retaliationPoisonModifierChance) \
+  X(retaliationPierceModifier) X(retaliationPierceModifierChance) \
+  X(retaliationLifeModifier) X(retaliationLifeModifierChance) \
+  X(retaliationStunModifier) X(retaliationStunModifierChance) \
+  X(retaliationElementalModifier) X(retaliationElementalModifierChance) \
+  X(racialBonusPercentDamage) X(racialBonusPercentDefense) X(racialBonusRace) \
+  X(petBonusName) \
+  X(skillCooldownTime) X(refreshTime) \
+  X(skillCooldownReduction) X(skillCooldownReductionChance) \
+  X(skillManaCostReduction) X(skillManaCostReductionChance) \
+  X(skillTargetNumber) X(skillActiveDuration) X(skillTargetRadius) \
+  X(offensiveGlobalChance) \
+  X(offensiveDisruptionMin) \
+  X(offensiveSlowLightningDurationMax) X(offensiveSlowFireDurationMax) \
+  X(offensiveSlowColdDurationMax) X(offensiveSlowPoisonDurationMax) \
+  X(defensiveDisruption) X(defensiveDisruptionDuration) \
+  X(offensiveTotalResistanceReductionAbsoluteMin) X(offensiveTotalResistanceReductionAbsoluteDurationMin) \
+  X(offensiveTotalResistanceReductionAbsoluteChance) X(offensiveTotalResistanceReductionAbsoluteMax) \
+  X(offensiveTotalResistanceReductionPercentMin) X(offensiveTotalResistanceReductionPercentDurationMin) \
+  X(offensiveTotalResistanceReductionPercentChance) \
+  X(offensiveSlowOffensiveAbilityModifier) X(offensiveSlowOffensiveAbilityDurationMin) \
+  X(offensiveSlowPhysicalMin) X(offensiveSlowPhysicalMax) X(offensiveSlowPhysicalDurationMin) X(offensiveSlowPhysicalChance) \
+  X(offensiveSlowDefensiveAbilityMin) X(offensiveSlowDefensiveAbilityMax) X(offensiveSlowDefensiveAbilityDurationMin) X(offensiveSlowDefensiveAbilityChance) \
+  X(offensiveSlowOffensiveAbilityMin) X(offensiveSlowOffensiveAbilityMax) X(offensiveSlowOffensiveAbilityChance) \
+  X(offensiveSlowOffensiveReductionModifier) X(offensiveSlowOffensiveReductionDurationMin) \
+  X(offensiveSlowTotalSpeedMin) X(offensiveSlowTotalSpeedChance) X(offensiveSlowTotalSpeedDurationMin) \
+  X(offensivePercentCurrentLifeMax) X(offensiveConfusionMax) \
+  X(racialBonusAbsoluteDamage) X(racialBonusAbsoluteDefense) \
+  X(retaliationSlowAttackSpeedMin) X(retaliationSlowAttackSpeedDurationMin) \
+  X(retaliationSlowManaLeachMin) X(retaliationSlowManaLeachDurationMin) X(retaliationSlowManaLeachChance) \
+  X(retaliationPierceMax) \
+  X(retaliationFireMax) X(retaliationColdMax) X(retaliationLightningMax) X(retaliationPhysicalMax) \
+  X(retaliationLifeMin) X(retaliationLifeMax) X(retaliationLifeChance) \
+  X(retaliationPoisonMin) X(retaliationPoisonMax) X(retaliationPoisonChance) \
+  X(retaliationStunMin) X(retaliationStunMax) X(retaliationStunChance) \
+  X(retaliationElementalMin) X(retaliationElementalMax) X(retaliationElementalChance) \
+  X(retaliationPercentCurrentLifeMin) X(retaliationPercentCurrentLifeMax) X(retaliationPercentCurrentLifeChance) \
+  X(retaliationGlobalChance) \
+  X(defensiveBlock) X(defensiveBlockChance) X(defensiveAbsorption) X(defensivePetrify) \
+  X(offensivePierceRatioMin) X(offensivePierceRatioMax) X(offensivePierceRatioChance) \
+  X(offensivePierceRatioModifier) X(offensivePierceRatioModifierChance) \
+  X(offensiveSlowRunSpeedMax) \
+  X(offensiveStunMax) X(offensiveStunModifier) \
+  X(offensiveFreezeMax) \
+  X(offensiveSleepMin) X(offensiveSleepMax) X(offensiveSleepChance) \
+  X(offensiveSleepDurationMin) X(offensiveSleepModifier) \
+  X(offensiveDisruptionMax) X(offensiveDisruptionChance) \
+  X(offensiveBaseFireChance) X(offensiveBaseColdChance) X(offensiveBaseLightningChance) \
+  X(offensiveSlowLifeLeachDurationMax) X(offensiveSlowManaLeachDurationMax) \
+  X(offensiveSlowBleedingDurationMax) \
+  X(defensiveSlowLifeLeach) X(defensiveSlowLifeLeachChance) \
+  X(defensiveSlowManaLeach) X(defensiveSlowManaLeachChance) \
+  X(defensivePoisonDuration) X(defensivePoisonDurationChance) \
+  X(defensiveReflect) X(defensiveReflectChance) \
+  X(itemNameTag) X(description) X(lootRandomizerName) X(FileDescription) \
+  X(itemClassification) X(itemText) \
+  X(characterBaseAttackSpeedTag) X(artifactClassification) \
+  X(itemSkillName) X(buffSkillName) X(skillDisplayName) \
+  X(itemSkillAutoController) X(triggerType) X(itemSkillLevel) \
+  X(skillBaseDescription) X(petSkillName) X(skillChanceWeight) \
+  X(itemSetName) X(setName) X(setMembers) \
+  X(completedRelicLevel) \
+  X(dexterityRequirement) X(intelligenceRequirement) \
+  X(strengthRequirement) X(levelRequirement) \
+  X(itemLevel) X(itemCostName) X(Class)
+
+#endif
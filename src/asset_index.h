@@ -3,31 +3,127 @@
 
 #include <stdint.h>
 
+// ASSET_INDEX_VERSION - TQIndexHeader.version written and accepted
+#define ASSET_INDEX_VERSION 7
+
+// TQAssetEntry.flags values
+#define ASSET_FLAG_ARC 1      // ARC file (0 = ARZ record)
+
 #pragma pack(push, 1)
 
-// TQAssetEntry - represents a single asset (record or file) in the game archives
-// size: 16 bytes
+// TQAssetEntry - represents a single asset (record or file) in the game archives.
+// Entries are sorted by hash, then by descending file_id. A path shipped by
+// several containers keeps one entry per container; lookups verify the
+// stored path and serve the first match of an equal-hash run (the latest
+// container).
+// size: 32 bytes
 typedef struct {
-  uint32_t hash;      // CRC32 of the normalized path
-  uint16_t file_id;   // index into the game_files array
-  uint16_t flags;     // reserved
-  uint32_t offset;    // offset in the source file
-  uint32_t size;      // compressed size
-  uint32_t real_size; // uncompressed size
+  uint64_t hash;        // FNV-1a 64 of the normalized path
+  uint32_t path_offset; // normalized path, relative to paths_offset
+  uint16_t file_id;     // index into the game_files array
+  uint16_t flags;       // ASSET_FLAG_ARC for an ARC file, 0 for an ARZ record
+  uint32_t offset;      // offset in the source file
+  uint32_t size;        // compressed size
+  uint32_t real_size;   // uncompressed size
+  uint32_t aux;         // ARZ record: class id + 1 (0 = no Class value)
+                        // ARC file: first part index + 1 if the file is
+                        // stored as several parts, 0 if it is one part at
+                        // offset/size
 } TQAssetEntry;
 
+// TQIndexFile - file table entry for one ARC/ARZ container
+// size: 24 bytes
+typedef struct {
+  uint64_t size;        // container size in bytes when it was scanned
+  int64_t mtime;        // container mtime when it was scanned
+  uint32_t path_offset; // relative path, relative to string_table_offset
+  uint32_t reserved;
+} TQIndexFile;
+
+// TQIndexDir - one directory of the path-ordered view. Every directory that
+// holds an asset at any depth has one record, in the order its first asset
+// appears in the path-ordered array, so a directory's subdirectories follow
+// it directly. The assets under a directory occupy [first, end) of that array.
+// size: 16 bytes
+typedef struct {
+  uint32_t path_offset; // first path under the directory, relative to paths_offset
+  uint32_t len;         // directory length within that path (no trailing separator)
+  uint32_t first;       // first position in the path-ordered array
+  uint32_t end;         // one past the last position in the path-ordered array
+} TQIndexDir;
+
+// TQIndexClass - one distinct record Class value. The records of the class
+// occupy [first, first + count) of the class-ordered entry index array, in
+// path order.
+// size: 12 bytes
+typedef struct {
+  uint32_t name_offset; // class name, relative to string_table_offset
+  uint32_t first;       // first position in the class-ordered array
+  uint32_t count;       // number of records with this class
+} TQIndexClass;
+
 // TQIndexHeader - header for the binary resource index file
-// size: 32 bytes
+// size: 80 bytes
 typedef struct {
   char magic[4];               // "TQVI"
-  uint32_t version;            // index version (1)
+  uint32_t version;            // ASSET_INDEX_VERSION
   uint32_t num_files;          // number of ARC/ARZ containers
   uint32_t num_entries;        // total number of assets
   uint32_t string_table_offset; // offset to null-terminated string table
   uint32_t entries_offset;      // offset to TQAssetEntry array
-  uint32_t reserved[2];
+  uint32_t files_offset;        // offset to TQIndexFile array
+  uint32_t generation;          // bumped every time the index is rewritten
+  uint32_t paths_offset;        // offset to the normalized asset path pool
+  uint32_t paths_size;          // size of the asset path pool in bytes
+  uint32_t keys_offset;         // offset to dense uint64_t key array (entry order)
+  uint32_t buckets_offset;      // offset to uint32_t bucket directory
+  uint32_t bucket_bits;         // top hash bits selecting a bucket
+  uint32_t sorted_offset;       // offset to uint32_t entry indices in path order
+  uint32_t dirs_offset;         // offset to TQIndexDir array
+  uint32_t num_dirs;            // number of TQIndexDir records
+  uint32_t classes_offset;      // offset to TQIndexClass array (class id order)
+  uint32_t num_classes;         // number of TQIndexClass records
+  uint32_t class_entries_offset; // offset to uint32_t entry indices in class order
+  uint32_t reserved;
 } TQIndexHeader;
 
 #pragma pack(pop)
 
+// asset_index_probe - find the first entry whose hash equals a key, using the
+// bucket directory and the dense key array. Bucket b spans the keys whose
+// top bucket_bits bits equal b, i.e. [buckets[b], buckets[b + 1]), so a
+// lookup touches one directory line and usually one line of keys.
+// keys: dense key array (TQAssetEntry.hash in entry order)
+// buckets: bucket directory with (1 << bucket_bits) + 1 slots
+// bucket_bits: number of top hash bits selecting a bucket (1..31)
+// hash: key to find
+// returns: index of the first matching entry, or UINT32_MAX if absent
+static inline uint32_t
+asset_index_probe(const uint64_t *keys, const uint32_t *buckets,
+                  uint32_t bucket_bits, uint64_t hash)
+{
+  uint64_t b = hash >> (64 - bucket_bits);
+  uint32_t low = buckets[b];
+  uint32_t high = buckets[b + 1];
+
+  // oversized buckets only happen with skewed hashes; narrow them first
+  while(high - low > 16)
+  {
+    uint32_t mid = low + (high - low) / 2;
+
+    if(keys[mid] < hash)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  for(uint32_t i = low; i < buckets[b + 1]; i++)
+  {
+    if(keys[i] >= hash)
+      return(keys[i] == hash ? i : UINT32_MAX);
+  }
+
+  return(UINT32_MAX);
+}
+
 #endif
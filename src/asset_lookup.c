@@ -1,4 +1,7 @@
 #include "asset_lookup.h"
+#include "record_cache.h"
+#include "dbr_cache.h"
+#include "path_hash.h"
 #include "platform_mmap.h"
 #include "config.h"
 #include <string.h>
@@ -7,49 +10,32 @@
 #include <errno.h>
 #include <zlib.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 
 static char *g_game_path = NULL;
 static TQArzFile **g_arz_cache = NULL;
 static TQArcFile **g_arc_cache = NULL;
-static GHashTable *g_dbr_cache = NULL;
+static GMutex g_arc_load_lock;
 static int g_num_files = 0;
-static GMutex g_dbr_mutex;
 
 static void *g_index_mmap = NULL;
 static size_t g_index_size = 0;
 static TQIndexHeader *g_index_header = NULL;
 static TQAssetEntry *g_index_entries = NULL;
+static const TQIndexFile *g_index_files = NULL;
+static const char *g_index_paths = NULL;
+static const uint64_t *g_index_keys = NULL;
+static const uint32_t *g_index_buckets = NULL;
+static const uint32_t *g_index_sorted = NULL;
+static const TQIndexDir *g_index_dirs = NULL;
+static const TQIndexClass *g_index_classes = NULL;
+static const uint32_t *g_index_class_entries = NULL;
+static const char *g_index_strings = NULL;
 static const char **g_game_files = NULL;
 
-// calculate_hash - compute a CRC32 hash of a normalized game path
-// path: asset path to hash (backslash-normalized, lowercased)
-// returns: CRC32 hash value, or 0 if path is NULL
-static uint32_t
-calculate_hash(const char *path)
-{
-  if(!path)
-    return(0);
-
-  char normalized[1024];
-  size_t len = strlen(path);
-
-  if(len >= sizeof(normalized))
-    len = sizeof(normalized) - 1;
-
-  memcpy(normalized, path, len);
-  normalized[len] = '\0';
-
-  for(int i = 0; normalized[i]; i++)
-  {
-    if(normalized[i] == '/')
-      normalized[i] = '\\';
-
-    if(normalized[i] >= 'A' && normalized[i] <= 'Z')
-      normalized[i] += 32;
-  }
-
-  return((uint32_t)crc32(0, (const Bytef *)normalized, (uInt)strlen(normalized)));
-}
+// path pool and entries seen by compare_path_order (qsort has no context)
+static const char *s_order_paths = NULL;
+static const TQAssetEntry *s_order_entries = NULL;
 
 // compare_entries - qsort comparator for TQAssetEntry by hash then file_id
 // a: pointer to first TQAssetEntry
@@ -77,159 +63,354 @@ compare_entries(const void *a, const void *b)
 }
 
 typedef struct {
-  char *path;
+  char *path;               // relative to the game directory (index file table)
+  char *full_path;          // filesystem path used while scanning
+  uint64_t size;            // container size (platform_file_info)
+  int64_t mtime;            // container mtime (platform_file_info)
+  bool is_arz;
 } BuildGameFile;
 
 typedef struct {
   TQAssetEntry *entries;
   int num_entries;
   int max_entries;
+  char *paths;              // normalized path pool, indexed by path_offset
+  size_t paths_len;
+  size_t paths_max;
+  uint8_t *scratch;         // partial record inflate buffer (Class lookup)
+  size_t scratch_size;
+} EntryBuffer;
+
+typedef struct {
+  TQAssetEntry *entries;
+  int num_entries;
+  char *paths;              // normalized path pool for entries; entries'
+                            // aux holds the pool offset + 1 of their class
+  size_t paths_len;
   BuildGameFile *files;
   int num_files;
   int max_files;
 } IndexBuilder;
 
+typedef struct {
+  const IndexBuilder *b;
+  const int *scan_ids;      // file ids to scan
+  int num_scan;
+  gint next_file;           // next scan_ids slot to claim (atomic)
+  int files_done;           // files finished, guarded by mutex
+  GMutex mutex;
+  GCond cond;               // signalled each time a file finishes
+} BuildShared;
+
+typedef struct {
+  BuildShared *shared;
+  EntryBuffer buf;
+  GThread *thread;
+} BuildWorker;
+
+// entry_buffer_add - append an entry for a path to a per-thread buffer
+// buf: buffer to grow
+// path: asset path (need not be NUL-terminated)
+// len: path length in bytes
+// returns: pointer to the new entry with hash and path_offset filled in and
+//          all other fields zeroed, or NULL on allocation failure
+static TQAssetEntry *
+entry_buffer_add(EntryBuffer *buf, const char *path, size_t len)
+{
+  if(buf->num_entries >= buf->max_entries)
+  {
+    int new_max = buf->max_entries ? buf->max_entries * 2 : 16384;
+    TQAssetEntry *grown = realloc(buf->entries, (size_t)new_max * sizeof(TQAssetEntry));
+
+    if(!grown)
+      return(NULL);
+
+    buf->entries = grown;
+    buf->max_entries = new_max;
+  }
+
+  if(buf->paths_len + 1024 > buf->paths_max)
+  {
+    size_t new_max = buf->paths_max ? buf->paths_max * 2 : 1024 * 1024;
+    char *grown = realloc(buf->paths, new_max);
+
+    if(!grown)
+      return(NULL);
+
+    buf->paths = grown;
+    buf->paths_max = new_max;
+  }
+
+  char *dst = buf->paths + buf->paths_len;
+  size_t norm_len = path_normalize(path, len, dst, 1024);
+  TQAssetEntry *e = &buf->entries[buf->num_entries++];
+
+  memset(e, 0, sizeof(*e));
+  e->hash = path_hash_len(dst, norm_len);
+  e->path_offset = (uint32_t)buf->paths_len;
+  buf->paths_len += norm_len + 1;
+  return(e);
+}
+
+// entry_buffer_add_string - append a string to a per-thread path pool
+// buf: buffer to grow
+// str: string bytes (need not be NUL-terminated)
+// len: string length in bytes
+// returns: pool offset of the copy, or UINT32_MAX on allocation failure
+static uint32_t
+entry_buffer_add_string(EntryBuffer *buf, const char *str, size_t len)
+{
+  if(buf->paths_len + len + 1 > buf->paths_max)
+  {
+    size_t new_max = buf->paths_max ? buf->paths_max * 2 : 1024 * 1024;
+
+    while(buf->paths_len + len + 1 > new_max)
+      new_max *= 2;
+
+    char *grown = realloc(buf->paths, new_max);
+
+    if(!grown)
+      return(UINT32_MAX);
+
+    buf->paths = grown;
+    buf->paths_max = new_max;
+  }
+
+  uint32_t off = (uint32_t)buf->paths_len;
+
+  memcpy(buf->paths + off, str, len);
+  buf->paths[off + len] = '\0';
+  buf->paths_len += len + 1;
+  return(off);
+}
+
+// record_class_index - find the string index of a record's Class value.
+// The record is inflated only until its Class variable has been seen,
+// which is normally within the first few variables.
+// buf: per-thread buffer whose scratch space is used for inflating
+// data: compressed record bytes
+// size: compressed size
+// class_idx: string index of "Class" in this ARZ
+// returns: string index of the Class value, or UINT32_MAX if absent
+static uint32_t
+record_class_index(EntryBuffer *buf, const uint8_t *data, uint32_t size,
+                   uint32_t class_idx)
+{
+  z_stream zs;
+  uint32_t found = UINT32_MAX;
+  size_t have = 0;
+  size_t parsed = 0;
+  int ret = Z_OK;
+
+  memset(&zs, 0, sizeof(zs));
+
+  if(inflateInit(&zs) != Z_OK)
+    return(UINT32_MAX);
+
+  zs.next_in = (Bytef *)data;
+  zs.avail_in = size;
+
+  while(found == UINT32_MAX && ret == Z_OK)
+  {
+    if(have + 16384 > buf->scratch_size)
+    {
+      size_t new_size = buf->scratch_size ? buf->scratch_size * 2 : 65536;
+      uint8_t *grown = realloc(buf->scratch, new_size);
+
+      if(!grown)
+        break;
+
+      buf->scratch = grown;
+      buf->scratch_size = new_size;
+    }
+
+    zs.next_out = buf->scratch + have;
+    zs.avail_out = (uInt)(buf->scratch_size - have);
+    ret = inflate(&zs, Z_NO_FLUSH);
+
+    if(ret != Z_OK && ret != Z_STREAM_END)
+      break;
+
+    have = buf->scratch_size - zs.avail_out;
+
+    // variables: type (u16), count (u16), name index (u32), count values
+    while(parsed + 8 <= have)
+    {
+      uint16_t type, count;
+      uint32_t name;
+
+      memcpy(&type, buf->scratch + parsed, 2);
+      memcpy(&count, buf->scratch + parsed + 2, 2);
+      memcpy(&name, buf->scratch + parsed + 4, 4);
+
+      size_t need = 8 + (size_t)count * 4;
+
+      if(parsed + need > have)
+        break;
+
+      if(name == class_idx && type == 2 && count > 0)
+      {
+        memcpy(&found, buf->scratch + parsed + 8, 4);
+        break;
+      }
+
+      parsed += need;
+    }
+  }
+
+  inflateEnd(&zs);
+  return(found);
+}
+
 // builder_process_arz - scan an ARZ file and add its records to the index
-// b: index builder to populate
+// buf: per-thread entry buffer to populate
 // path: filesystem path to the ARZ file
 // file_id: file table index for this ARZ
 static void
-builder_process_arz(IndexBuilder *b, const char *path, int file_id)
+builder_process_arz(EntryBuffer *buf, const char *path, int file_id)
 {
-  FILE *fp = fopen(path, "rb");
+  size_t size = 0;
+  const uint8_t *data = platform_mmap_readonly(path, &size);
 
-  if(!fp)
+  if(!data)
     return;
 
-  uint32_t header[5];
-
-  if(fread(header, 4, 5, fp) != 5)
+  if(size < 20)
   {
-    fclose(fp);
+    platform_munmap((void *)data, size);
     return;
   }
 
+  uint32_t header[5];
+
+  memcpy(header, data, sizeof(header));
+
   uint32_t record_start = header[1];
   uint32_t record_count = header[3];
   uint32_t string_start = header[4];
 
-  if(record_count > 1000000)
+  if(record_count > 1000000 || (uint64_t)string_start + 4 > size)
   {
-    fclose(fp);
+    platform_munmap((void *)data, size);
     return;
   }
 
-  fseek(fp, string_start, SEEK_SET);
   uint32_t num_strings;
 
-  if(fread(&num_strings, 4, 1, fp) != 1)
-  {
-    fclose(fp);
-    return;
-  }
+  memcpy(&num_strings, data + string_start, 4);
 
-  char **strings = malloc(num_strings * sizeof(char *));
+  // string table as (offset, length) views into the mapping
+  uint32_t *views = (uint64_t)num_strings * 4 <= size ? malloc((size_t)num_strings * 2 * sizeof(uint32_t)) : NULL;
 
-  if(!strings)
+  if(!views)
   {
-    fclose(fp);
+    platform_munmap((void *)data, size);
     return;
   }
 
+  size_t pos = (size_t)string_start + 4;
+
   for(uint32_t i = 0; i < num_strings; i++)
   {
-    uint32_t len;
+    uint32_t len = 0;
+
+    if(pos + 4 <= size)
+      memcpy(&len, data + pos, 4);
 
-    if(fread(&len, 4, 1, fp) != 1)
+    if(pos + 4 + (uint64_t)len > size)
     {
-      strings[i] = NULL;
-      continue;
+      // truncated table: mark the remaining strings missing
+      for(; i < num_strings; i++)
+        views[i * 2] = 0;
+      break;
     }
 
-    strings[i] = malloc(len + 1);
-
-    if(!strings[i])
-      continue;
+    views[i * 2] = (uint32_t)(pos + 4);
+    views[i * 2 + 1] = len;
+    pos += 4 + (size_t)len;
+  }
 
-    if(fread(strings[i], 1, len, fp) != len)
-    {
-      free(strings[i]);
-      strings[i] = NULL;
-      continue;
-    }
+  // records refer to their Class variable by this string index
+  uint32_t class_idx = UINT32_MAX;
 
-    strings[i][len] = '\0';
+  for(uint32_t i = 0; i < num_strings && class_idx == UINT32_MAX; i++)
+  {
+    if(views[i * 2] != 0 && views[i * 2 + 1] == 5 &&
+       memcmp(data + views[i * 2], "Class", 5) == 0)
+      class_idx = i;
   }
 
-  fseek(fp, record_start, SEEK_SET);
+  // pool offset + 1 of each class name already copied, by string index
+  uint32_t *class_names = class_idx != UINT32_MAX ? calloc(num_strings, sizeof(uint32_t)) : NULL;
+
+  pos = record_start;
 
   for(uint32_t i = 0; i < record_count; i++)
   {
-    uint32_t name_idx;
+    uint32_t name_idx, type_len, offset, compressed_size;
 
-    if(fread(&name_idx, 4, 1, fp) != 1)
+    if(pos + 8 > size)
       break;
 
-    uint32_t type_len;
+    memcpy(&name_idx, data + pos, 4);
+    memcpy(&type_len, data + pos + 4, 4);
+    pos += 8 + (size_t)type_len;
 
-    if(fread(&type_len, 4, 1, fp) != 1)
+    if(pos + 16 > size)
       break;
 
-    fseek(fp, type_len, SEEK_CUR);
-    uint32_t offset, compressed_size;
+    memcpy(&offset, data + pos, 4);
+    memcpy(&compressed_size, data + pos + 4, 4);
+    pos += 16;
 
-    if(fread(&offset, 4, 1, fp) != 1)
-      break;
+    if(name_idx >= num_strings || views[name_idx * 2] == 0)
+      continue;
 
-    if(fread(&compressed_size, 4, 1, fp) != 1)
+    TQAssetEntry *e = entry_buffer_add(buf, (const char *)data + views[name_idx * 2],
+                                       views[name_idx * 2 + 1]);
+
+    if(!e)
       break;
 
-    fseek(fp, 8, SEEK_CUR);
+    e->file_id = (uint16_t)file_id;
+    e->offset = offset + 24;
+    e->size = compressed_size;
+
+    if(!class_names || (uint64_t)e->offset + compressed_size > size)
+      continue;
+
+    uint32_t cls = record_class_index(buf, data + e->offset, compressed_size, class_idx);
 
-    if(name_idx >= num_strings || !strings[name_idx])
+    if(cls >= num_strings || views[cls * 2] == 0)
       continue;
 
-    if(b->num_entries >= b->max_entries)
+    if(class_names[cls] == 0)
     {
-      b->max_entries *= 2;
-      b->entries = realloc(b->entries, b->max_entries * sizeof(TQAssetEntry));
+      uint32_t off = entry_buffer_add_string(buf, (const char *)data + views[cls * 2],
+                                             views[cls * 2 + 1]);
 
-      if(!b->entries)
-        break;
-    }
+      if(off == UINT32_MAX)
+        continue;
 
-    b->entries[b->num_entries].hash = calculate_hash(strings[name_idx]);
-    b->entries[b->num_entries].file_id = (uint16_t)file_id;
-    b->entries[b->num_entries].offset = offset + 24;
-    b->entries[b->num_entries].size = compressed_size;
-    b->entries[b->num_entries].real_size = 0;
-    b->entries[b->num_entries].flags = 0;
-    b->num_entries++;
-  }
+      class_names[cls] = off + 1;
+    }
 
-  for(uint32_t i = 0; i < num_strings; i++)
-  {
-    if(strings[i])
-      free(strings[i]);
+    e->aux = class_names[cls];
   }
 
-  free(strings);
-  fclose(fp);
+  free(class_names);
+  free(views);
+  platform_munmap((void *)data, size);
 }
 
 // builder_process_arc - scan an ARC archive and add its entries to the index
-// b: index builder to populate
+// buf: per-thread entry buffer to populate
 // path: filesystem path to the ARC file
 // rel_path: relative path within the game directory
 // file_id: file table index for this ARC
 static void
-builder_process_arc(IndexBuilder *b, const char *path, const char *rel_path, int file_id)
+builder_process_arc(EntryBuffer *buf, const char *path, const char *rel_path, int file_id)
 {
-  FILE *fp = fopen(path, "rb");
-
-  if(!fp)
-    return;
-
   char prefix[512] = "";
   const char *p = rel_path;
 
@@ -265,94 +446,85 @@ builder_process_arc(IndexBuilder *b, const char *path, const char *rel_path, int
     prefix[sizeof(prefix) - 1] = '\0';
   }
 
-  char magic[4];
+  size_t size = 0;
+  const uint8_t *data = platform_mmap_readonly(path, &size);
 
-  if(fread(magic, 1, 4, fp) != 4)
-  {
-    fclose(fp);
+  if(!data)
     return;
-  }
 
-  if(memcmp(magic, "ARC\0", 4) != 0)
+  if(size < 28 || memcmp(data, "ARC\0", 4) != 0)
   {
-    fclose(fp);
+    platform_munmap((void *)data, size);
     return;
   }
 
   uint32_t header[6];
 
-  if(fread(header, 4, 6, fp) != 6)
-  {
-    fclose(fp);
-    return;
-  }
+  memcpy(header, data + 4, sizeof(header));
 
   uint32_t arc_num_files = header[1];
   uint32_t toc_offset = header[5];
+  uint64_t names_start = (uint64_t)toc_offset + (uint64_t)header[2] * 12;
+  uint64_t records_size = (uint64_t)arc_num_files * 44;
 
-  fseek(fp, toc_offset, SEEK_SET);
-  fseek(fp, header[2] * 12, SEEK_CUR);
-
-  char **filenames = malloc(arc_num_files * sizeof(char *));
-
-  if(!filenames)
+  if(names_start > size || records_size > size)
   {
-    fclose(fp);
+    platform_munmap((void *)data, size);
     return;
   }
 
+  size_t prefix_len = strlen(prefix);
+  size_t name_pos = (size_t)names_start;
+  size_t rec_pos = size - (size_t)records_size;
+  char full_internal_path[1024];
+
+  memcpy(full_internal_path, prefix, prefix_len);
+
   for(uint32_t i = 0; i < arc_num_files; i++)
   {
-    char buf[1024];
-    int c, j = 0;
+    // filenames are consecutive NUL-terminated strings after the part table
+    const uint8_t *name = data + name_pos;
+    const uint8_t *end = name_pos < size ? memchr(name, '\0', size - name_pos) : NULL;
+    size_t name_len = end ? (size_t)(end - name) : size - name_pos;
 
-    while((c = fgetc(fp)) != EOF && c != '\0' && j < 1023)
-      buf[j++] = (char)c;
+    name_pos += name_len + (end ? 1 : 0);
 
-    buf[j] = '\0';
-    filenames[i] = strdup(buf);
-  }
+    if(name_len > 1023)
+      name_len = 1023;
 
-  fseek(fp, -44LL * arc_num_files, SEEK_END);
+    size_t full_len = prefix_len + name_len;
 
-  for(uint32_t i = 0; i < arc_num_files; i++)
-  {
-    uint32_t rec[11];
+    if(full_len >= sizeof(full_internal_path))
+      full_len = sizeof(full_internal_path) - 1;
 
-    if(fread(rec, 4, 11, fp) != 11)
-      break;
+    memcpy(full_internal_path + prefix_len, name, full_len - prefix_len);
 
-    if(b->num_entries >= b->max_entries)
-    {
-      b->max_entries *= 2;
-      b->entries = realloc(b->entries, b->max_entries * sizeof(TQAssetEntry));
+    uint32_t rec[11];
 
-      if(!b->entries)
-        break;
-    }
+    memcpy(rec, data + rec_pos + (size_t)i * 44, sizeof(rec));
 
-    char full_internal_path[1024];
+    TQAssetEntry *e = entry_buffer_add(buf, full_internal_path, full_len);
 
-    snprintf(full_internal_path, sizeof(full_internal_path), "%s%s", prefix, filenames[i]);
+    if(!e)
+      break;
 
-    b->entries[b->num_entries].hash = calculate_hash(full_internal_path);
-    b->entries[b->num_entries].file_id = (uint16_t)file_id;
-    b->entries[b->num_entries].offset = rec[1];
-    b->entries[b->num_entries].size = rec[2];
-    b->entries[b->num_entries].real_size = rec[3];
-    b->entries[b->num_entries].flags = 1;
-    b->num_entries++;
-  }
+    e->file_id = (uint16_t)file_id;
+    e->offset = rec[1];
+    e->size = rec[2];
+    e->real_size = rec[3];
+    e->flags = ASSET_FLAG_ARC;
 
-  for(uint32_t i = 0; i < arc_num_files; i++)
-    free(filenames[i]);
+    // rec[7..8]: part count and first part; a file of several parts is
+    // several zlib streams and must be read part by part
+    if(rec[7] > 1)
+      e->aux = rec[8] + 1;
+  }
 
-  free(filenames);
-  fclose(fp);
+  platform_munmap((void *)data, size);
 }
 
-// builder_scan_dir - recursively scan a directory for ARZ/ARC files
-// b: index builder to populate
+// builder_scan_dir - recursively collect the ARZ/ARC files under a directory
+// b: index builder whose file table is populated
 // base_path: root game directory
 // sub_path: subdirectory to scan relative to base_path
 static void
@@ -396,27 +568,29 @@ builder_scan_dir(IndexBuilder *b, const char *base_path, const char *sub_path)
       {
         if(b->num_files >= b->max_files)
         {
-          b->max_files *= 2;
-          b->files = realloc(b->files, b->max_files * sizeof(BuildGameFile));
+          BuildGameFile *grown = realloc(b->files, (size_t)b->max_files * 2 * sizeof(BuildGameFile));
 
-          if(!b->files)
+          if(!grown)
           {
             g_free(full_path);
             break;
           }
+
+          b->files = grown;
+          b->max_files *= 2;
         }
 
         char *rel_path = g_build_filename(sub_path, name, NULL);
 
         b->files[b->num_files].path = strdup(rel_path);
-
-        if(strcasecmp(ext, ".arz") == 0)
-          builder_process_arz(b, full_path, b->num_files);
-        else
-          builder_process_arc(b, full_path, rel_path, b->num_files);
-
-        g_free(rel_path);
+        b->files[b->num_files].full_path = strdup(full_path);
+        b->files[b->num_files].is_arz = (strcasecmp(ext, ".arz") == 0);
+        b->files[b->num_files].size = 0;
+        b->files[b->num_files].mtime = 0;
+        platform_file_info(full_path, &b->files[b->num_files].size,
+                           &b->files[b->num_files].mtime);
         b->num_files++;
+        g_free(rel_path);
       }
     }
 
@@ -427,155 +601,920 @@ builder_scan_dir(IndexBuilder *b, const char *base_path, const char *sub_path)
   g_free(full_dir);
 }
 
-// asset_index_build - build and write the asset index to disk
-// game_path: root path to the game installation
-// index_path: filesystem path to write the index file
-static void
-asset_index_build(const char *game_path, const char *index_path)
+// builder_worker - scan containers claimed from the shared file counter
+// user_data: BuildWorker for this thread
+// returns: NULL
+static gpointer
+builder_worker(gpointer user_data)
 {
-  IndexBuilder b;
-
-  b.max_entries = 200000;
-  b.entries = malloc(b.max_entries * sizeof(TQAssetEntry));
-  b.num_entries = 0;
-  b.max_files = 512;
-  b.files = malloc(b.max_files * sizeof(BuildGameFile));
-  b.num_files = 0;
+  BuildWorker *w = user_data;
+  BuildShared *s = w->shared;
+  const IndexBuilder *b = s->b;
+  int slot;
 
-  if(!b.entries || !b.files)
+  while((slot = g_atomic_int_add(&s->next_file, 1)) < s->num_scan)
   {
-    free(b.entries);
-    free(b.files);
-    return;
+    int fid = s->scan_ids[slot];
+    const BuildGameFile *f = &b->files[fid];
+
+    if(f->is_arz)
+      builder_process_arz(&w->buf, f->full_path, fid);
+    else
+      builder_process_arc(&w->buf, f->full_path, f->path, fid);
+
+    g_mutex_lock(&s->mutex);
+    s->files_done++;
+    g_cond_signal(&s->cond);
+    g_mutex_unlock(&s->mutex);
   }
 
-  builder_scan_dir(&b, game_path, "Database");
-  builder_scan_dir(&b, game_path, "Resources");
+  return(NULL);
+}
+
+// builder_scan_files - scan the selected containers on a worker pool
+// b: index builder with its file table populated; entries are filled in
+// scan_ids: file ids to scan
+// num_scan: number of file ids
+// progress: optional callback, invoked on the calling thread
+// user_data: passed through to progress
+static void
+builder_scan_files(IndexBuilder *b, const int *scan_ids, int num_scan,
+                   AssetIndexProgressFunc progress, void *user_data)
+{
+  int num_threads = (int)g_get_num_processors();
+
+  if(num_threads > 16)
+    num_threads = 16;
+
+  if(num_threads > num_scan)
+    num_threads = num_scan;
 
-  fprintf(stderr, "asset_index_build: scan of %s found %d files, %d entries\n",
-          game_path, b.num_files, b.num_entries);
+  if(num_threads < 1)
+    num_threads = 1;
 
-  if(b.num_entries == 0)
+  BuildShared s;
+
+  s.b = b;
+  s.scan_ids = scan_ids;
+  s.num_scan = num_scan;
+  s.next_file = 0;
+  s.files_done = 0;
+  g_mutex_init(&s.mutex);
+  g_cond_init(&s.cond);
+
+  BuildWorker *workers = calloc((size_t)num_threads, sizeof(BuildWorker));
+
+  if(!workers)
   {
-    fprintf(stderr, "asset_index_build: no entries — game_path is wrong or "
-            "Database/Resources subdirs not found. Aborting (no index written).\n");
-    free(b.entries);
-    free(b.files);
+    g_mutex_clear(&s.mutex);
+    g_cond_clear(&s.cond);
     return;
   }
 
-  qsort(b.entries, b.num_entries, sizeof(TQAssetEntry), compare_entries);
+  for(int i = 0; i < num_threads; i++)
+  {
+    workers[i].shared = &s;
+    workers[i].thread = g_thread_new("tqvc-index", builder_worker, &workers[i]);
+  }
 
-  int write_idx = 1;
+  // report progress from this thread so UI callers can pump their main loop
+  g_mutex_lock(&s.mutex);
 
-  for(int read_idx = 1; read_idx < b.num_entries; read_idx++)
+  while(s.files_done < num_scan)
   {
-    if(b.entries[read_idx].hash != b.entries[write_idx - 1].hash)
-      b.entries[write_idx++] = b.entries[read_idx];
+    int done = s.files_done;
+
+    if(progress)
+    {
+      g_mutex_unlock(&s.mutex);
+      progress(done, num_scan, user_data);
+      g_mutex_lock(&s.mutex);
+    }
+
+    while(s.files_done == done)
+      g_cond_wait(&s.cond, &s.mutex);
   }
 
-  b.num_entries = write_idx;
+  g_mutex_unlock(&s.mutex);
 
-  FILE *fp = fopen(index_path, "wb");
+  if(progress)
+    progress(num_scan, num_scan, user_data);
 
-  if(!fp)
+  int total = 0;
+  size_t total_paths = 0;
+
+  for(int i = 0; i < num_threads; i++)
   {
-    fprintf(stderr, "asset_index_build: fopen(%s, wb) failed: %s\n",
-            index_path, strerror(errno));
-    return;
+    g_thread_join(workers[i].thread);
+    total += workers[i].buf.num_entries;
+    total_paths += workers[i].buf.paths_len;
   }
 
-  TQIndexHeader header;
+  b->entries = malloc((size_t)(total ? total : 1) * sizeof(TQAssetEntry));
+  b->paths = malloc(total_paths ? total_paths : 1);
+  b->num_entries = 0;
+  b->paths_len = 0;
 
-  memcpy(header.magic, "TQVI", 4);
-  header.version = 1;
-  header.num_files = b.num_files;
-  header.num_entries = b.num_entries;
-  header.entries_offset = sizeof(TQIndexHeader);
-  header.string_table_offset = header.entries_offset + (b.num_entries * sizeof(TQAssetEntry));
-  header.reserved[0] = 0;
-  header.reserved[1] = 0;
+  // concatenate the per-thread buffers, rebasing path offsets into one pool
+  for(int i = 0; i < num_threads; i++)
+  {
+    EntryBuffer *wb = &workers[i].buf;
 
-  fwrite(&header, sizeof(header), 1, fp);
-  fwrite(b.entries, sizeof(TQAssetEntry), b.num_entries, fp);
+    if(b->entries && b->paths && wb->num_entries > 0)
+    {
+      for(int j = 0; j < wb->num_entries; j++)
+      {
+        b->entries[b->num_entries] = wb->entries[j];
+        b->entries[b->num_entries].path_offset += (uint32_t)b->paths_len;
 
-  for(int i = 0; i < b.num_files; i++)
-    fwrite(b.files[i].path, 1, strlen(b.files[i].path) + 1, fp);
+        if(b->entries[b->num_entries].flags == 0 && b->entries[b->num_entries].aux)
+          b->entries[b->num_entries].aux += (uint32_t)b->paths_len;
 
-  fclose(fp);
+        b->num_entries++;
+      }
 
-  for(int i = 0; i < b.num_files; i++)
-    free(b.files[i].path);
+      memcpy(b->paths + b->paths_len, wb->paths, wb->paths_len);
+      b->paths_len += wb->paths_len;
+    }
 
-  free(b.files);
-  free(b.entries);
+    free(wb->entries);
+    free(wb->paths);
+    free(wb->scratch);
+  }
+
+  free(workers);
+  g_mutex_clear(&s.mutex);
+  g_cond_clear(&s.cond);
 }
 
-// asset_index_load - memory-map and validate the pre-built asset index
-// index_path: filesystem path to the index file
-// returns: true if the index was loaded successfully, false otherwise
-static bool
-asset_index_load(const char *index_path)
+// builder_free - release the builder's file table and entries
+// b: index builder to clean up
+static void
+builder_free(IndexBuilder *b)
 {
-  g_index_mmap = platform_mmap_readonly(index_path, &g_index_size);
-
-  if(!g_index_mmap)
-    return(false);
+  for(int i = 0; i < b->num_files; i++)
+  {
+    free(b->files[i].path);
+    free(b->files[i].full_path);
+  }
 
-  g_index_header = (TQIndexHeader *)g_index_mmap;
+  free(b->files);
+  free(b->entries);
+  free(b->paths);
+}
 
-  if(memcmp(g_index_header->magic, "TQVI", 4) != 0 || g_index_header->version != 1)
-  {
+// asset_index_unload - drop the currently mapped index
+static void
+asset_index_unload(void)
+{
+  if(g_index_mmap)
     platform_munmap(g_index_mmap, g_index_size);
-    g_index_mmap = NULL;
-    return(false);
-  }
 
-  g_index_entries = (TQAssetEntry *)((char *)g_index_mmap + g_index_header->entries_offset);
+  free(g_game_files);
+  g_index_mmap = NULL;
+  g_index_size = 0;
+  g_index_header = NULL;
+  g_index_entries = NULL;
+  g_index_files = NULL;
+  g_index_paths = NULL;
+  g_index_keys = NULL;
+  g_index_buckets = NULL;
+  g_index_sorted = NULL;
+  g_index_dirs = NULL;
+  g_index_classes = NULL;
+  g_index_class_entries = NULL;
+  g_index_strings = NULL;
+  g_game_files = NULL;
+  g_num_files = 0;
+}
 
-  g_num_files = g_index_header->num_files;
+// compare_path_order - qsort comparator for entry indices by normalized
+// path, then by entry order (a path shipped by several containers keeps
+// the latest container first)
+// a: pointer to first entry index
+// b: pointer to second entry index
+// returns: negative if a < b, positive if a > b, 0 if equal
+static int
+compare_path_order(const void *a, const void *b)
+{
+  uint32_t ia = *(const uint32_t *)a;
+  uint32_t ib = *(const uint32_t *)b;
+  int cmp = strcmp(s_order_paths + s_order_entries[ia].path_offset,
+                   s_order_paths + s_order_entries[ib].path_offset);
 
-  if(g_game_files)
-    free(g_game_files);
+  if(cmp != 0)
+    return(cmp);
 
-  g_game_files = malloc((size_t)g_num_files * sizeof(char *));
+  return(ia < ib ? -1 : (ia > ib ? 1 : 0));
+}
 
-  if(!g_game_files)
-    return(false);
+// build_path_order - sort the entries by path and collect the directory
+// table over the sorted order. Every string prefix is a contiguous run of
+// the sorted array, so a directory's assets (at any depth) are one range.
+// entries: hash-sorted entries
+// num_entries: number of entries
+// paths: normalized path pool the entries' path_offset values index into
+// dirs_out: receives the TQIndexDir records (caller frees with g_array_free)
+// returns: newly allocated entry indices in path order, or NULL on failure
+static uint32_t *
+build_path_order(const TQAssetEntry *entries, int num_entries,
+                 const char *paths, GArray **dirs_out)
+{
+  uint32_t *sorted = malloc((size_t)(num_entries ? num_entries : 1) * sizeof(uint32_t));
 
-  const char *str = (const char *)g_index_mmap + g_index_header->string_table_offset;
+  if(!sorted)
+    return(NULL);
 
-  for(int i = 0; i < g_num_files; i++)
+  for(int i = 0; i < num_entries; i++)
+    sorted[i] = (uint32_t)i;
+
+  s_order_paths = paths;
+  s_order_entries = entries;
+  qsort(sorted, num_entries, sizeof(uint32_t), compare_path_order);
+  s_order_paths = NULL;
+  s_order_entries = NULL;
+
+  GArray *dirs = g_array_new(FALSE, FALSE, sizeof(TQIndexDir));
+  uint32_t open[512];  // dirs enclosing the current path, outermost first
+  int depth = 0;
+
+  for(uint32_t i = 0; i < (uint32_t)num_entries; i++)
   {
-    g_game_files[i] = str;
-    str += strlen(str) + 1;
+    uint32_t off = entries[sorted[i]].path_offset;
+    const char *path = paths + off;
+
+    // close the directories this path is not under
+    while(depth > 0)
+    {
+      TQIndexDir *d = &g_array_index(dirs, TQIndexDir, open[depth - 1]);
+
+      if(strncmp(paths + d->path_offset, path, d->len) == 0 && path[d->len] == '\\')
+        break;
+
+      d->end = i;
+      depth--;
+    }
+
+    // open the directories below the innermost one still open
+    size_t start = depth > 0 ? g_array_index(dirs, TQIndexDir, open[depth - 1]).len + 1 : 0;
+
+    for(const char *sep = strchr(path + start, '\\'); sep && depth < 512;
+        sep = strchr(sep + 1, '\\'))
+    {
+      TQIndexDir d = { off, (uint32_t)(sep - path), i, 0 };
+
+      open[depth++] = dirs->len;
+      g_array_append_val(dirs, d);
+    }
   }
 
-  return(true);
+  while(depth > 0)
+    g_array_index(dirs, TQIndexDir, open[--depth]).end = (uint32_t)num_entries;
+
+  *dirs_out = dirs;
+  return(sorted);
 }
 
-// asset_manager_init - initialize the asset manager with the game path
-// game_path: root path to the game installation
-void
-asset_manager_init(const char *game_path)
+// build_class_order - group the classified entries by class id, each group
+// in path order
+// entries: hash-sorted entries (aux = class id + 1, or 0)
+// num_entries: number of entries
+// sorted: entry indices in path order (from build_path_order)
+// num_classes: number of class ids
+// classes: receives first/count for every class id (name_offset untouched)
+// num_classified_out: receives the length of the returned array
+// returns: newly allocated entry indices in class order, or NULL on failure
+static uint32_t *
+build_class_order(const TQAssetEntry *entries, int num_entries, const uint32_t *sorted,
+                  uint32_t num_classes, TQIndexClass *classes,
+                  uint32_t *num_classified_out)
 {
-  g_game_path = strdup(game_path);
+  uint32_t *next = calloc(num_classes ? num_classes : 1, sizeof(uint32_t));
+  uint32_t num_classified = 0;
 
-  char *cache_subdir = tqvc_cache_dir_new();
-  char *index_path = g_build_filename(cache_subdir, "tqvc-resource-index.bin", NULL);
+  if(!next)
+    return(NULL);
 
-  g_free(cache_subdir);
+  for(uint32_t c = 0; c < num_classes; c++)
+  {
+    classes[c].first = 0;
+    classes[c].count = 0;
+  }
 
-  if(!asset_index_load(index_path))
+  for(int i = 0; i < num_entries; i++)
   {
-    fprintf(stderr, "asset_manager_init: building index at %s\n", index_path);
-    asset_index_build(game_path, index_path);
-    asset_index_load(index_path);
+    if(entries[i].flags == 0 && entries[i].aux > 0 && entries[i].aux <= num_classes)
+    {
+      classes[entries[i].aux - 1].count++;
+      num_classified++;
+    }
   }
 
-  fprintf(stderr, "asset_manager_init: game_path=%s, index has %d files, %u entries\n",
-          game_path, g_num_files,
-          g_index_header ? g_index_header->num_entries : 0);
+  for(uint32_t c = 0, first = 0; c < num_classes; c++)
+  {
+    classes[c].first = first;
+    next[c] = first;
+    first += classes[c].count;
+  }
+
+  uint32_t *by_class = malloc((size_t)(num_classified ? num_classified : 1) * sizeof(uint32_t));
+
+  if(by_class)
+  {
+    for(int i = 0; i < num_entries; i++)
+    {
+      uint32_t aux = entries[sorted[i]].aux;
+
+      if(entries[sorted[i]].flags == 0 && aux > 0 && aux <= num_classes)
+        by_class[next[aux - 1]++] = sorted[i];
+    }
+  }
+
+  free(next);
+  *num_classified_out = num_classified;
+  return(by_class);
+}
+
+// asset_index_write - write an index file and move it into place
+// index_path: filesystem path of the index file
+// b: builder holding the current file table
+// entries: sorted entries to write
+// num_entries: number of entries
+// paths: normalized path pool the entries' path_offset values index into
+// paths_len: size of the path pool in bytes
+// class_names: record Class values by class id (entries' aux is id + 1)
+// num_classes: number of class names
+// generation: generation number to record in the header
+// returns: true on success
+static bool
+asset_index_write(const char *index_path, const IndexBuilder *b,
+                  const TQAssetEntry *entries, int num_entries,
+                  const char *paths, size_t paths_len,
+                  const char *const *class_names, uint32_t num_classes,
+                  uint32_t generation)
+{
+  GArray *dirs = NULL;
+  uint32_t *sorted = build_path_order(entries, num_entries, paths, &dirs);
+  TQIndexClass *classes = calloc(num_classes ? num_classes : 1, sizeof(TQIndexClass));
+  uint32_t num_classified = 0;
+  uint32_t *by_class = sorted && classes ?
+    build_class_order(entries, num_entries, sorted, num_classes, classes, &num_classified) : NULL;
+
+  if(!by_class)
+  {
+    if(dirs)
+      g_array_free(dirs, TRUE);
+
+    free(sorted);
+    free(classes);
+    return(false);
+  }
+
+  char *tmp_path = g_strconcat(index_path, ".tmp", NULL);
+  FILE *fp = fopen(tmp_path, "wb");
+
+  if(!fp)
+  {
+    fprintf(stderr, "asset_index_write: fopen(%s, wb) failed: %s\n",
+            tmp_path, strerror(errno));
+    g_free(tmp_path);
+    g_array_free(dirs, TRUE);
+    free(sorted);
+    free(classes);
+    free(by_class);
+    return(false);
+  }
+
+  // about four entries per bucket keeps a probe within one line of keys
+  uint32_t bucket_bits = 8;
+
+  while(bucket_bits < 24 && ((uint32_t)num_entries >> (bucket_bits + 2)) > 0)
+    bucket_bits++;
+
+  uint32_t num_buckets = 1u << bucket_bits;
+  TQIndexHeader header;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "TQVI", 4);
+  header.version = ASSET_INDEX_VERSION;
+  header.num_files = b->num_files;
+  header.num_entries = num_entries;
+  header.files_offset = sizeof(TQIndexHeader);
+  header.entries_offset = header.files_offset + (b->num_files * sizeof(TQIndexFile));
+  header.keys_offset = header.entries_offset + (num_entries * sizeof(TQAssetEntry));
+  header.buckets_offset = header.keys_offset + (num_entries * sizeof(uint64_t));
+  header.bucket_bits = bucket_bits;
+  header.sorted_offset = header.buckets_offset + ((num_buckets + 1) * sizeof(uint32_t));
+  header.dirs_offset = header.sorted_offset + (num_entries * sizeof(uint32_t));
+  header.num_dirs = dirs->len;
+  header.classes_offset = header.dirs_offset + (dirs->len * sizeof(TQIndexDir));
+  header.num_classes = num_classes;
+  header.class_entries_offset = header.classes_offset + (num_classes * sizeof(TQIndexClass));
+  header.string_table_offset = header.class_entries_offset + (num_classified * sizeof(uint32_t));
+  header.generation = generation;
+
+  // the string table holds the file paths, then the class names
+  uint32_t strings_len = 0;
+
+  for(int i = 0; i < b->num_files; i++)
+    strings_len += (uint32_t)strlen(b->files[i].path) + 1;
+
+  for(uint32_t c = 0; c < num_classes; c++)
+  {
+    classes[c].name_offset = strings_len;
+    strings_len += (uint32_t)strlen(class_names[c]) + 1;
+  }
+
+  header.paths_offset = header.string_table_offset + strings_len;
+  header.paths_size = (uint32_t)paths_len;
+
+  fwrite(&header, sizeof(header), 1, fp);
+
+  uint32_t path_offset = 0;
+
+  for(int i = 0; i < b->num_files; i++)
+  {
+    TQIndexFile f;
+
+    f.size = b->files[i].size;
+    f.mtime = b->files[i].mtime;
+    f.path_offset = path_offset;
+    f.reserved = 0;
+    fwrite(&f, sizeof(f), 1, fp);
+    path_offset += (uint32_t)strlen(b->files[i].path) + 1;
+  }
+
+  fwrite(entries, sizeof(TQAssetEntry), num_entries, fp);
+
+  for(int i = 0; i < num_entries; i++)
+    fwrite(&entries[i].hash, sizeof(uint64_t), 1, fp);
+
+  // buckets[k] = first entry whose top bucket_bits bits are >= k
+  uint32_t e = 0;
+
+  for(uint32_t k = 0; k <= num_buckets; k++)
+  {
+    while(e < (uint32_t)num_entries && (entries[e].hash >> (64 - bucket_bits)) < k)
+      e++;
+
+    fwrite(&e, sizeof(uint32_t), 1, fp);
+  }
+
+  fwrite(sorted, sizeof(uint32_t), num_entries, fp);
+  fwrite(dirs->data, sizeof(TQIndexDir), dirs->len, fp);
+  fwrite(classes, sizeof(TQIndexClass), num_classes, fp);
+  fwrite(by_class, sizeof(uint32_t), num_classified, fp);
+  g_array_free(dirs, TRUE);
+  free(sorted);
+  free(classes);
+  free(by_class);
+
+  for(int i = 0; i < b->num_files; i++)
+    fwrite(b->files[i].path, 1, strlen(b->files[i].path) + 1, fp);
+
+  for(uint32_t c = 0; c < num_classes; c++)
+    fwrite(class_names[c], 1, strlen(class_names[c]) + 1, fp);
+
+  fwrite(paths, 1, paths_len, fp);
+
+  bool ok = (fclose(fp) == 0);
+
+  if(!ok || g_rename(tmp_path, index_path) != 0)
+  {
+    fprintf(stderr, "asset_index_write: could not replace %s\n", index_path);
+    g_unlink(tmp_path);
+    ok = false;
+  }
+
+  g_free(tmp_path);
+  return(ok);
+}
+
+// sort_equal_hash_runs - restore descending file_id order inside runs of
+// equal hash after file ids were remapped (the array stays hash-sorted)
+// entries: hash-sorted entries
+// n: number of entries
+static void
+sort_equal_hash_runs(TQAssetEntry *entries, int n)
+{
+  for(int i = 1; i < n; i++)
+  {
+    TQAssetEntry e = entries[i];
+    int j = i - 1;
+
+    while(j >= 0 && compare_entries(&entries[j], &e) > 0)
+    {
+      entries[j + 1] = entries[j];
+      j--;
+    }
+
+    entries[j + 1] = e;
+  }
+}
+
+// intern_class - number a record class for the index being written
+// ids: class name -> id + 1 (keys borrowed from names)
+// names: class names by id (owns the strings)
+// name: class name to look up or add
+// returns: class id + 1 (the TQAssetEntry.aux value)
+static uint32_t
+intern_class(GHashTable *ids, GPtrArray *names, const char *name)
+{
+  uint32_t id = GPOINTER_TO_UINT(g_hash_table_lookup(ids, name));
+
+  if(id == 0)
+  {
+    char *copy = g_strdup(name);
+
+    g_ptr_array_add(names, copy);
+    id = names->len;
+    g_hash_table_insert(ids, copy, GUINT_TO_POINTER(id));
+  }
+
+  return(id);
+}
+
+// asset_index_update - bring the on-disk index in line with the install.
+// Containers whose size and mtime match the loaded index keep their
+// entries; new or changed ones are rescanned and spliced into the sorted
+// array. Builds from scratch when no valid index is loaded.
+// game_path: root path to the game installation
+// index_path: filesystem path of the index file
+// progress: optional callback, invoked on the calling thread
+// user_data: passed through to progress
+static void
+asset_index_update(const char *game_path, const char *index_path,
+                   AssetIndexProgressFunc progress, void *user_data)
+{
+  IndexBuilder b;
+
+  b.entries = NULL;
+  b.num_entries = 0;
+  b.paths = NULL;
+  b.paths_len = 0;
+  b.max_files = 512;
+  b.files = malloc(b.max_files * sizeof(BuildGameFile));
+  b.num_files = 0;
+
+  if(!b.files)
+    return;
+
+  builder_scan_dir(&b, game_path, "Database");
+  builder_scan_dir(&b, game_path, "Resources");
+
+  // match the install against the loaded file table by relative path
+  int *old_to_new = calloc((size_t)(g_num_files ? g_num_files : 1), sizeof(int));
+  int *scan_ids = malloc((size_t)(b.num_files ? b.num_files : 1) * sizeof(int));
+  int num_scan = 0;
+  bool unchanged = (b.num_files == g_num_files);
+  GHashTable *old_ids = g_hash_table_new(g_str_hash, g_str_equal);
+
+  if(!old_to_new || !scan_ids)
+  {
+    free(old_to_new);
+    free(scan_ids);
+    g_hash_table_destroy(old_ids);
+    builder_free(&b);
+    return;
+  }
+
+  for(int i = 0; i < g_num_files; i++)
+  {
+    old_to_new[i] = -1;
+    g_hash_table_insert(old_ids, (gpointer)g_game_files[i], GINT_TO_POINTER(i + 1));
+  }
+
+  for(int i = 0; i < b.num_files; i++)
+  {
+    int old = GPOINTER_TO_INT(g_hash_table_lookup(old_ids, b.files[i].path)) - 1;
+
+    if(old >= 0 && g_index_files[old].size == b.files[i].size &&
+       g_index_files[old].mtime == b.files[i].mtime)
+    {
+      old_to_new[old] = i;
+
+      if(old != i)
+        unchanged = false;
+    }
+    else
+    {
+      scan_ids[num_scan++] = i;
+      unchanged = false;
+    }
+  }
+
+  g_hash_table_destroy(old_ids);
+
+  if(unchanged)
+  {
+    free(old_to_new);
+    free(scan_ids);
+    builder_free(&b);
+    return;
+  }
+
+  if(g_index_mmap)
+    fprintf(stderr, "asset_index_update: %d of %d containers new or changed, "
+            "refreshing %s\n", num_scan, b.num_files, index_path);
+  else
+    fprintf(stderr, "asset_manager_init: building index at %s\n", index_path);
+
+  builder_scan_files(&b, scan_ids, num_scan, progress, user_data);
+  qsort(b.entries, b.num_entries, sizeof(TQAssetEntry), compare_entries);
+
+  // entries of unchanged containers, remapped to their new file ids
+  int num_kept = 0;
+  uint32_t old_count = g_index_header ? g_index_header->num_entries : 0;
+
+  for(uint32_t i = 0; i < old_count; i++)
+  {
+    if(old_to_new[g_index_entries[i].file_id] >= 0)
+      num_kept++;
+  }
+
+  TQAssetEntry *kept = malloc((size_t)(num_kept ? num_kept : 1) * sizeof(TQAssetEntry));
+  TQAssetEntry *merged = malloc((size_t)(num_kept + b.num_entries + 1) * sizeof(TQAssetEntry));
+
+  if(!kept || !merged)
+  {
+    free(kept);
+    free(merged);
+    free(old_to_new);
+    free(scan_ids);
+    builder_free(&b);
+    return;
+  }
+
+  int k = 0;
+
+  for(uint32_t i = 0; i < old_count; i++)
+  {
+    int fid = old_to_new[g_index_entries[i].file_id];
+
+    if(fid >= 0)
+    {
+      kept[k] = g_index_entries[i];
+      kept[k].file_id = (uint16_t)fid;
+      k++;
+    }
+  }
+
+  sort_equal_hash_runs(kept, num_kept);
+
+  // splice the rescanned entries into the kept ones, rebuilding the path
+  // pool as we go (a path shipped by several containers is stored once)
+  // and renumbering the record classes
+  GString *pool = g_string_new(NULL);
+  GHashTable *class_ids = g_hash_table_new(g_str_hash, g_str_equal);
+  GPtrArray *class_names = g_ptr_array_new_with_free_func(g_free);
+  const char *prev_path = NULL;
+  int ki = 0, ni = 0, mi = 0;
+
+  while(ki < num_kept || ni < b.num_entries)
+  {
+    const char *path;
+    const char *class_name = NULL;
+
+    if(ni >= b.num_entries ||
+       (ki < num_kept && compare_entries(&kept[ki], &b.entries[ni]) <= 0))
+    {
+      path = g_index_paths + kept[ki].path_offset;
+
+      if(kept[ki].flags == 0 && kept[ki].aux)
+        class_name = g_index_strings + g_index_classes[kept[ki].aux - 1].name_offset;
+
+      merged[mi] = kept[ki++];
+    }
+    else
+    {
+      path = b.paths + b.entries[ni].path_offset;
+
+      if(b.entries[ni].flags == 0 && b.entries[ni].aux)
+        class_name = b.paths + b.entries[ni].aux - 1;
+
+      merged[mi] = b.entries[ni++];
+    }
+
+    if(merged[mi].flags == 0)
+      merged[mi].aux = class_name ? intern_class(class_ids, class_names, class_name) : 0;
+
+    if(mi > 0 && merged[mi - 1].hash == merged[mi].hash && strcmp(prev_path, path) == 0)
+      merged[mi].path_offset = merged[mi - 1].path_offset;
+    else
+    {
+      merged[mi].path_offset = (uint32_t)pool->len;
+      g_string_append_len(pool, path, (gssize)strlen(path) + 1);
+    }
+
+    prev_path = path;
+    mi++;
+  }
+
+  fprintf(stderr, "asset_index_update: scan of %s found %d files, %d entries "
+          "(%d kept, %d rescanned)\n",
+          game_path, b.num_files, mi, num_kept, b.num_entries);
+
+  if(mi == 0)
+  {
+    fprintf(stderr, "asset_index_update: no entries — game_path is wrong or "
+            "Database/Resources subdirs not found. Aborting (no index written).\n");
+  }
+  else
+  {
+    // a fresh build starts from the clock so it never reuses the generation
+    // of a deleted index that derived caches may still be keyed on
+    uint32_t generation = g_index_header ? g_index_header->generation + 1 :
+                          (uint32_t)(g_get_real_time() / G_USEC_PER_SEC);
+
+    // the old mapping must be gone before the rename on Windows
+    asset_index_unload();
+    asset_index_write(index_path, &b, merged, mi, pool->str, pool->len,
+                      (const char *const *)class_names->pdata, class_names->len,
+                      generation);
+  }
+
+  g_string_free(pool, TRUE);
+  g_hash_table_destroy(class_ids);
+  g_ptr_array_free(class_names, TRUE);
+  free(kept);
+  free(merged);
+  free(old_to_new);
+  free(scan_ids);
+  builder_free(&b);
+}
+
+// asset_index_load - memory-map and validate the pre-built asset index
+// index_path: filesystem path to the index file
+// returns: true if the index was loaded successfully, false otherwise
+static bool
+asset_index_load(const char *index_path)
+{
+  asset_index_unload();
+
+  g_index_mmap = platform_mmap_readonly(index_path, &g_index_size);
+
+  if(!g_index_mmap)
+    return(false);
+
+  g_index_header = (TQIndexHeader *)g_index_mmap;
+
+  const TQIndexHeader *h = g_index_header;
+
+  if(g_index_size < sizeof(TQIndexHeader) ||
+     memcmp(h->magic, "TQVI", 4) != 0 || h->version != ASSET_INDEX_VERSION ||
+     h->bucket_bits < 1 || h->bucket_bits > 24 ||
+     (uint64_t)h->keys_offset + (uint64_t)h->num_entries * sizeof(uint64_t) > g_index_size ||
+     (uint64_t)h->buckets_offset + ((1ull << h->bucket_bits) + 1) * sizeof(uint32_t) > g_index_size ||
+     (uint64_t)h->files_offset + (uint64_t)h->num_files * sizeof(TQIndexFile) > g_index_size ||
+     (uint64_t)h->entries_offset + (uint64_t)h->num_entries * sizeof(TQAssetEntry) > g_index_size ||
+     (uint64_t)h->sorted_offset + (uint64_t)h->num_entries * sizeof(uint32_t) > g_index_size ||
+     (uint64_t)h->dirs_offset + (uint64_t)h->num_dirs * sizeof(TQIndexDir) > g_index_size ||
+     (uint64_t)h->classes_offset + (uint64_t)h->num_classes * sizeof(TQIndexClass) > g_index_size ||
+     h->class_entries_offset > g_index_size ||
+     h->string_table_offset > g_index_size ||
+     (uint64_t)h->paths_offset + h->paths_size > g_index_size ||
+     h->paths_size == 0 || ((const char *)g_index_mmap)[h->paths_offset + h->paths_size - 1] != '\0')
+  {
+    asset_index_unload();
+    return(false);
+  }
+
+  g_index_entries = (TQAssetEntry *)((char *)g_index_mmap + h->entries_offset);
+  g_index_files = (const TQIndexFile *)((char *)g_index_mmap + h->files_offset);
+  g_index_paths = (const char *)g_index_mmap + h->paths_offset;
+  g_index_keys = (const uint64_t *)((char *)g_index_mmap + h->keys_offset);
+  g_index_buckets = (const uint32_t *)((char *)g_index_mmap + h->buckets_offset);
+  g_index_sorted = (const uint32_t *)((char *)g_index_mmap + h->sorted_offset);
+  g_index_dirs = (const TQIndexDir *)((char *)g_index_mmap + h->dirs_offset);
+  g_index_classes = (const TQIndexClass *)((char *)g_index_mmap + h->classes_offset);
+  g_index_class_entries = (const uint32_t *)((char *)g_index_mmap + h->class_entries_offset);
+  g_index_strings = (const char *)g_index_mmap + h->string_table_offset;
+
+  if(g_index_buckets[1u << h->bucket_bits] != h->num_entries)
+  {
+    asset_index_unload();
+    return(false);
+  }
+
+  // aux is a class id only for ARZ records; an ARC entry's first part is
+  // checked against its archive by arc_read_parts()
+  for(uint32_t i = 0; i < h->num_entries; i++)
+  {
+    if(g_index_sorted[i] >= h->num_entries ||
+       g_index_entries[i].file_id >= h->num_files ||
+       g_index_entries[i].path_offset >= h->paths_size ||
+       (g_index_entries[i].flags == 0 && g_index_entries[i].aux > h->num_classes))
+    {
+      asset_index_unload();
+      return(false);
+    }
+  }
+
+  for(uint32_t i = 0; i < h->num_dirs; i++)
+  {
+    const TQIndexDir *d = &g_index_dirs[i];
+
+    if((uint64_t)d->path_offset + d->len >= h->paths_size ||
+       d->first >= d->end || d->end > h->num_entries)
+    {
+      asset_index_unload();
+      return(false);
+    }
+  }
+
+  g_game_files = malloc((size_t)(h->num_files ? h->num_files : 1) * sizeof(char *));
+
+  if(!g_game_files)
+  {
+    asset_index_unload();
+    return(false);
+  }
+
+  const char *strings = (const char *)g_index_mmap + h->string_table_offset;
+  size_t strings_size = g_index_size - h->string_table_offset;
+
+  for(uint32_t i = 0; i < h->num_files; i++)
+  {
+    uint32_t off = g_index_files[i].path_offset;
+
+    if(off >= strings_size || !memchr(strings + off, '\0', strings_size - off))
+    {
+      asset_index_unload();
+      return(false);
+    }
+
+    g_game_files[i] = strings + off;
+  }
+
+  // class groups must tile the class-ordered array
+  uint64_t num_classified = 0;
+
+  for(uint32_t c = 0; c < h->num_classes; c++)
+  {
+    const TQIndexClass *cls = &g_index_classes[c];
+
+    if(cls->first != num_classified || cls->name_offset >= strings_size ||
+       !memchr(strings + cls->name_offset, '\0', strings_size - cls->name_offset))
+    {
+      asset_index_unload();
+      return(false);
+    }
+
+    num_classified += cls->count;
+  }
+
+  if((uint64_t)h->class_entries_offset + num_classified * sizeof(uint32_t) > g_index_size)
+  {
+    asset_index_unload();
+    return(false);
+  }
+
+  for(uint64_t i = 0; i < num_classified; i++)
+  {
+    if(g_index_class_entries[i] >= h->num_entries)
+    {
+      asset_index_unload();
+      return(false);
+    }
+  }
+
+  g_num_files = (int)h->num_files;
+  return(true);
+}
+
+// asset_manager_init - initialize the asset manager with the game path
+// game_path: root path to the game installation
+void
+asset_manager_init(const char *game_path)
+{
+  asset_manager_init_with_progress(game_path, NULL, NULL);
+}
+
+// asset_manager_init_with_progress - initialize the asset manager, reporting
+// progress if the resource index has to be built
+// game_path: root path to the game installation
+// progress: optional callback, invoked on the calling thread
+// user_data: passed through to progress
+void
+asset_manager_init_with_progress(const char *game_path,
+                                 AssetIndexProgressFunc progress, void *user_data)
+{
+  g_game_path = strdup(game_path);
+
+  char *cache_subdir = tqvc_cache_dir_new();
+  char *index_path = g_build_filename(cache_subdir, "tqvc-resource-index.bin", NULL);
+
+  // Validate the index against the install, refreshing it if containers
+  // were added, removed or patched since it was written.
+  asset_index_load(index_path);
+  asset_index_update(game_path, index_path, progress, user_data);
+
+  if(!g_index_mmap)
+    asset_index_load(index_path);
+
+  fprintf(stderr, "asset_manager_init: game_path=%s, index has %d files, %u entries\n",
+          game_path, g_num_files,
+          g_index_header ? g_index_header->num_entries : 0);
 
   // Sanity-check the index with a known asset that ships with every TQ install.
   const char *probe = "Items\\AnimalRelics\\AnimalPart07B_L.tex";
@@ -585,9 +1524,18 @@ asset_manager_init(const char *game_path)
 
   g_free(index_path);
 
+  char *record_cache_path = g_build_filename(cache_subdir, "tqvc-dbr-cache.bin", NULL);
+
+  record_cache_open(record_cache_path, game_path);
+  g_free(record_cache_path);
+  g_free(cache_subdir);
+
   g_arz_cache = calloc((size_t)g_num_files, sizeof(TQArzFile *));
   g_arc_cache = calloc((size_t)g_num_files, sizeof(TQArcFile *));
-  g_dbr_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)arz_record_data_free);
+
+  size_t dbr_budget = (global_config.dbr_cache_mb > 0 ? (size_t)global_config.dbr_cache_mb : 256) * 1024 * 1024;
+
+  dbr_cache_init(dbr_budget);
 
   // Pre-load all ARZ file handles (mmap only, fast) so background
   // prefetch threads don't race on lazy arz_load().
@@ -620,7 +1568,7 @@ asset_get_arz(uint16_t file_id)
   return(g_arz_cache[file_id]);
 }
 
-// asset_get_arc - get a cached TQArcFile for a given file_id
+// asset_get_arc - get a cached TQArcFile for a given file_id (thread-safe)
 // file_id: index into the file table
 // returns: cached ARC file handle, or NULL on failure
 TQArcFile *
@@ -629,14 +1577,75 @@ asset_get_arc(uint16_t file_id)
   if(file_id >= g_num_files)
     return(NULL);
 
-  if(g_arc_cache[file_id])
-    return(g_arc_cache[file_id]);
+  TQArcFile *arc = g_atomic_pointer_get(&g_arc_cache[file_id]);
 
-  char *full_path = g_build_filename(g_game_path, g_game_files[file_id], NULL);
+  if(arc)
+    return(arc);
 
-  g_arc_cache[file_id] = arc_load(full_path);
-  g_free(full_path);
-  return(g_arc_cache[file_id]);
+  // texture workers open archives too; load each one exactly once
+  g_mutex_lock(&g_arc_load_lock);
+  arc = g_arc_cache[file_id];
+
+  if(!arc)
+  {
+    char *full_path = g_build_filename(g_game_path, g_game_files[file_id], NULL);
+
+    arc = arc_load(full_path);
+    g_free(full_path);
+    g_atomic_pointer_set(&g_arc_cache[file_id], arc);
+  }
+
+  g_mutex_unlock(&g_arc_load_lock);
+  return(arc);
+}
+
+// asset_view_file - get the contents of an indexed ARC file (thread-safe)
+// entry: index entry with ASSET_FLAG_ARC
+// buf: buffer to inflate into, or NULL
+// buf_size: size of buf in bytes
+// view: receives the contents; release with arc_view_release()
+// returns: true on success
+bool
+asset_view_file(const TQAssetEntry *entry, uint8_t *buf, size_t buf_size, TQArcView *view)
+{
+  memset(view, 0, sizeof(*view));
+
+  if(!entry || !(entry->flags & ASSET_FLAG_ARC))
+    return(false);
+
+  TQArcFile *arc = asset_get_arc(entry->file_id);
+
+  if(!arc)
+    return(false);
+
+  if(entry->aux)
+    return(arc_view_parts(arc, entry->aux - 1, entry->real_size, buf, buf_size, view));
+
+  return(arc_view_at(arc, entry->offset, entry->size, entry->real_size, buf, buf_size, view));
+}
+
+// load_dbr_entry - decode a record for the DBR cache
+// Reads mmap'd data and allocates fresh memory. ARZ files are pre-loaded in
+// asset_manager_init(), so this is safe to call from prefetch threads.
+// entry: index entry of the record
+// returns: newly allocated record data, or NULL on failure
+static TQArzRecordData *
+load_dbr_entry(const TQAssetEntry *entry)
+{
+  TQArzFile *arz = g_arz_cache[entry->file_id];
+
+  if(!arz)
+    return(NULL);
+
+  TQArzRecordData *data = record_cache_get(arz, entry->file_id, entry->offset);
+
+  if(!data)
+  {
+    data = arz_read_record_at(arz, entry->offset, entry->size);
+    record_cache_note(entry->file_id, entry->offset, data);
+  }
+
+  return(data);
 }
 
 // asset_get_dbr - get a cached TQArzRecordData for a given record path
@@ -648,86 +1657,82 @@ asset_get_dbr(const char *record_path)
   if(!record_path)
     return(NULL);
 
-  char *key = strdup(record_path);
+  const TQAssetEntry *entry = asset_lookup(record_path);
 
-  if(!key)
+  if(!entry)
     return(NULL);
 
-  for(int i = 0; key[i]; i++)
-  {
-    if(key[i] == '/')
-      key[i] = '\\';
+  return(dbr_cache_get(entry, load_dbr_entry));
+}
 
-    if(key[i] >= 'A' && key[i] <= 'Z')
-      key[i] += 32;
-  }
+// asset_read_record - read a record by location, via the persistent cache
+// file_id: index file table id of the ARZ
+// offset: record offset within the ARZ (TQAssetEntry.offset)
+// size: compressed record size (TQAssetEntry.size)
+// returns: newly allocated record data (caller frees), or NULL on failure
+TQArzRecordData *
+asset_read_record(uint16_t file_id, uint32_t offset, uint32_t size)
+{
+  TQArzFile *arz = asset_get_arz(file_id);
+
+  if(!arz)
+    return(NULL);
 
-  g_mutex_lock(&g_dbr_mutex);
-  TQArzRecordData *data = g_hash_table_lookup(g_dbr_cache, key);
-  g_mutex_unlock(&g_dbr_mutex);
+  TQArzRecordData *data = record_cache_get(arz, file_id, offset);
 
   if(data)
-  {
-    free(key);
     return(data);
-  }
-
-  // Decompress from ARZ -- reads mmap'd data, allocates fresh memory.
-  // ARZ files are pre-loaded in asset_manager_init(), so this is safe
-  // to call from the background prefetch thread.
-  const TQAssetEntry *entry = asset_lookup(key);
 
-  if(entry)
-  {
-    TQArzFile *arz = g_arz_cache[entry->file_id];
-
-    if(arz)
-    {
-      data = arz_read_record_at(arz, entry->offset, entry->size);
-
-      if(data)
-      {
-        g_mutex_lock(&g_dbr_mutex);
-        // Double-check: another thread may have inserted while we decompressed
-        TQArzRecordData *existing = g_hash_table_lookup(g_dbr_cache, key);
-
-        if(existing)
-        {
-          g_mutex_unlock(&g_dbr_mutex);
-          arz_record_data_free(data);
-          free(key);
-          return(existing);
-        }
+  data = arz_read_record_at(arz, offset, size);
+  record_cache_note(file_id, offset, data);
+  return(data);
+}
 
-        g_hash_table_insert(g_dbr_cache, key, data);
-        g_mutex_unlock(&g_dbr_mutex);
-        return(data);
-      }
-    }
-  }
+// asset_dbr_acquire - keep records returned by asset_get_dbr() alive on a
+// worker thread until asset_dbr_release()
+// returns: token for asset_dbr_release()
+int
+asset_dbr_acquire(void)
+{
+  return(dbr_cache_read_begin());
+}
 
-  free(key);
-  return(NULL);
+// asset_dbr_release - end a section started by asset_dbr_acquire()
+// token: value returned by asset_dbr_acquire()
+void
+asset_dbr_release(int token)
+{
+  dbr_cache_read_end(token);
 }
 
 // asset_cache_insert - insert a pre-built record into the DBR cache
-// key: malloc'd normalized path (ownership transferred to cache)
-// data: record data (ownership transferred to cache)
+// record_path: game-relative path of the record (must be in the index)
+// data: record data (ownership transferred; freed if the path is unknown)
 void
-asset_cache_insert(char *key, TQArzRecordData *data)
+asset_cache_insert(const char *record_path, TQArzRecordData *data)
 {
-  if(!g_dbr_cache || !key || !data)
+  const TQAssetEntry *entry = record_path ? asset_lookup(record_path) : NULL;
+
+  if(!entry)
+  {
+    arz_record_data_free(data);
     return;
+  }
 
-  g_mutex_lock(&g_dbr_mutex);
-  g_hash_table_insert(g_dbr_cache, key, data);
-  g_mutex_unlock(&g_dbr_mutex);
+  dbr_cache_insert(entry, data);
 }
 
 // asset_manager_free - free all cached resources and the asset manager state
 void
 asset_manager_free(void)
 {
+  if(tqvc_debug)
+    dbr_cache_print_stats();
+
+  // cached records may borrow the record cache mapping
+  dbr_cache_free();
+  record_cache_close();
+
   for(int i = 0; i < g_num_files; i++)
   {
     if(g_arz_cache[i])
@@ -737,53 +1742,204 @@ asset_manager_free(void)
       arc_free(g_arc_cache[i]);
   }
 
-  if(g_dbr_cache)
-    g_hash_table_destroy(g_dbr_cache);
-
   free(g_arz_cache);
   free(g_arc_cache);
   free(g_game_path);
-
-  if(g_game_files)
-    free(g_game_files);
-
-  if(g_index_mmap)
-    platform_munmap(g_index_mmap, g_index_size);
+  asset_index_unload();
 }
 
-// asset_lookup - find an asset entry by its path using binary search
+// asset_lookup - find an asset entry by its path via the bucket directory
 // path: game-relative asset path to look up
-// returns: pointer to the matching asset entry, or NULL if not found
+// returns: pointer to the matching asset entry, or NULL if not found.
+//          Hashing and verification fold case and separators on the fly,
+//          so the lookup never copies or allocates. The hit is verified
+//          against the stored path, so a hash collision never returns
+//          another asset. When several containers ship the path, the
+//          latest container's entry (first in the run) is returned.
 const TQAssetEntry *
 asset_lookup(const char *path)
 {
   if(!path || !g_index_entries || g_index_header->num_entries == 0)
     return(NULL);
 
-  uint32_t target_hash = calculate_hash(path);
+  uint64_t target_hash = path_hash(path);
+  uint32_t n = g_index_header->num_entries;
+  uint32_t first = asset_index_probe(g_index_keys, g_index_buckets,
+                                     g_index_header->bucket_bits, target_hash);
 
-  int low = 0;
-  int high = (int)g_index_header->num_entries - 1;
-
-  while(low <= high)
+  // probe the equal-hash run for the exact path
+  for(uint32_t i = first; i < n && g_index_keys[i] == target_hash; i++)
   {
-    int mid = low + (high - low) / 2;
+    uint32_t off = g_index_entries[i].path_offset;
 
-    if(mid < 0 || mid >= (int)g_index_header->num_entries)
-      break;
+    if(off < g_index_header->paths_size && path_equal(g_index_paths + off, path))
+      return(&g_index_entries[i]);
+  }
+
+  return(NULL);
+}
+
+// asset_foreach_prefix - visit every entry whose path starts with a prefix
+// prefix: path prefix (case and separator style are ignored)
+// fn: callback; returning false stops the iteration
+// user_data: passed through to fn
+// returns: number of entries visited
+int
+asset_foreach_prefix(const char *prefix, AssetPathFunc fn, void *user_data)
+{
+  if(!prefix || !fn || !g_index_sorted)
+    return(0);
 
-    uint32_t mid_hash = g_index_entries[mid].hash;
+  char folded[1024];
+  size_t len = path_normalize(prefix, strlen(prefix), folded, sizeof(folded));
+  uint32_t low = 0;
+  uint32_t high = g_index_header->num_entries;
 
-    if(mid_hash == target_hash)
-      return(&g_index_entries[mid]);
+  // first path >= prefix; the paths starting with it follow contiguously
+  while(low < high)
+  {
+    uint32_t mid = low + (high - low) / 2;
+    const char *path = g_index_paths + g_index_entries[g_index_sorted[mid]].path_offset;
 
-    if(mid_hash < target_hash)
+    if(strcmp(path, folded) < 0)
       low = mid + 1;
     else
-      high = mid - 1;
+      high = mid;
   }
 
-  return(NULL);
+  int visited = 0;
+
+  for(uint32_t i = low; i < g_index_header->num_entries; i++)
+  {
+    const TQAssetEntry *e = &g_index_entries[g_index_sorted[i]];
+    const char *path = g_index_paths + e->path_offset;
+
+    if(strncmp(path, folded, len) != 0)
+      break;
+
+    visited++;
+
+    if(!fn(e, path, user_data))
+      break;
+  }
+
+  return(visited);
+}
+
+// asset_foreach_component - visit every entry under a directory whose name
+// contains a fragment. Only the directory table is scanned; each matching
+// directory contributes one contiguous range of the path-ordered entries,
+// and its subdirectories are skipped so no entry is visited twice.
+// fragment: text to find in a directory name (case is ignored)
+// fn: callback; returning false stops the iteration
+// user_data: passed through to fn
+// returns: number of entries visited
+int
+asset_foreach_component(const char *fragment, AssetPathFunc fn, void *user_data)
+{
+  if(!fragment || !*fragment || !fn || !g_index_sorted)
+    return(0);
+
+  char folded[256];
+  size_t frag_len = path_normalize(fragment, strlen(fragment), folded, sizeof(folded));
+  uint32_t num_dirs = g_index_header->num_dirs;
+  int visited = 0;
+
+  for(uint32_t j = 0; j < num_dirs; )
+  {
+    const TQIndexDir *d = &g_index_dirs[j];
+    const char *dir = g_index_paths + d->path_offset;
+    const char *name = dir + d->len;
+    bool match = false;
+
+    while(name > dir && name[-1] != '\\')
+      name--;
+
+    for(const char *p = name; p + frag_len <= dir + d->len && !match; p++)
+      match = (memcmp(p, folded, frag_len) == 0);
+
+    if(!match)
+    {
+      j++;
+      continue;
+    }
+
+    for(uint32_t i = d->first; i < d->end; i++)
+    {
+      const TQAssetEntry *e = &g_index_entries[g_index_sorted[i]];
+
+      visited++;
+
+      if(!fn(e, g_index_paths + e->path_offset, user_data))
+        return(visited);
+    }
+
+    // subdirectories start inside this range
+    uint32_t end = d->end;
+
+    for(j++; j < num_dirs && g_index_dirs[j].first < end; j++)
+      ;
+  }
+
+  return(visited);
+}
+
+// asset_foreach_class - visit every ARZ record whose Class value matches,
+// in path order, without decoding any record. The class table is scanned,
+// then each matching class contributes one range of entries.
+// class_name: Class value to match (case is ignored)
+// fn: callback; returning false stops the iteration
+// user_data: passed through to fn
+// returns: number of records visited
+int
+asset_foreach_class(const char *class_name, AssetPathFunc fn, void *user_data)
+{
+  if(!class_name || !fn || !g_index_classes)
+    return(0);
+
+  int visited = 0;
+
+  for(uint32_t c = 0; c < g_index_header->num_classes; c++)
+  {
+    const TQIndexClass *cls = &g_index_classes[c];
+
+    if(strcasecmp(g_index_strings + cls->name_offset, class_name) != 0)
+      continue;
+
+    for(uint32_t i = cls->first; i < cls->first + cls->count; i++)
+    {
+      const TQAssetEntry *e = &g_index_entries[g_index_class_entries[i]];
+
+      visited++;
+
+      if(!fn(e, g_index_paths + e->path_offset, user_data))
+        return(visited);
+    }
+  }
+
+  return(visited);
+}
+
+// asset_entry_class - get the Class value of an indexed ARZ record
+// entry: index entry
+// returns: class name (internal pointer, do not free), or NULL if the
+//          entry is not a record or has no Class value
+const char *
+asset_entry_class(const TQAssetEntry *entry)
+{
+  if(!entry || entry->flags != 0 || !g_index_classes || entry->aux == 0 ||
+     entry->aux > g_index_header->num_classes)
+    return(NULL);
+
+  return(g_index_strings + g_index_classes[entry->aux - 1].name_offset);
+}
+
+// asset_index_generation - identify the loaded resource index
+// returns: generation number, or 0 if no index is loaded
+uint32_t
+asset_index_generation(void)
+{
+  return(g_index_header ? g_index_header->generation : 0);
 }
 
 // asset_get_num_files - get the total number of indexed game files
@@ -5,6 +5,7 @@
 #include "arz.h"
 #include "arc.h"
 #include <stddef.h>
+#include <stdbool.h>
 
 // asset_lookup - find an asset by its path
 // path: normalized game path to look up
@@ -20,29 +21,119 @@ const char *asset_get_file_path(uint16_t file_id);
 // game_path: root path to the game installation
 void asset_manager_init(const char *game_path);
 
+// AssetIndexProgressFunc - progress callback for the resource index build
+// done: number of ARZ/ARC containers scanned so far
+// total: number of containers to scan
+// user_data: caller context
+typedef void (*AssetIndexProgressFunc)(int done, int total, void *user_data);
+
+// asset_manager_init_with_progress - initialize the asset manager, reporting
+// progress if the resource index has to be built. The callback runs on the
+// calling thread, so a UI caller may pump its main context from it.
+// game_path: root path to the game installation
+// progress: optional callback (NULL for none)
+// user_data: passed through to progress
+void asset_manager_init_with_progress(const char *game_path,
+                                      AssetIndexProgressFunc progress, void *user_data);
+
 // asset_get_arz - get a cached TQArzFile for a given file_id
 // file_id: index into the file table
 // returns: cached ARZ file, or NULL if not an ARZ file
 TQArzFile *asset_get_arz(uint16_t file_id);
 
-// asset_get_arc - get a cached TQArcFile for a given file_id
+// asset_get_arc - get a cached TQArcFile for a given file_id (thread-safe)
 // file_id: index into the file table
 // returns: cached ARC file, or NULL if not an ARC file
 TQArcFile *asset_get_arc(uint16_t file_id);
 
-// asset_get_dbr - get a cached TQArzRecordData for a given record path
+// asset_view_file - get the contents of an indexed ARC file, whether it is
+// stored as one part or several (thread-safe)
+// entry: index entry of an ARC file (flags has ASSET_FLAG_ARC)
+// buf: buffer to inflate into, or NULL to let the view allocate
+// buf_size: size of buf in bytes
+// view: receives the contents; release with arc_view_release()
+// returns: true on success
+bool asset_view_file(const TQAssetEntry *entry, uint8_t *buf, size_t buf_size, TQArcView *view);
+
+// asset_get_dbr - get a cached TQArzRecordData for a given record path.
+// The cache is bounded, but evicted records are only freed from the main
+// loop: main-thread code may use the result until it returns to the main
+// loop and must not keep it longer. Other threads must hold an
+// asset_dbr_acquire() section while they use the result.
 // record_path: normalized path to the DBR record
 // returns: cached record data, or NULL if not found
 TQArzRecordData *asset_get_dbr(const char *record_path);
 
+// asset_dbr_acquire - keep records returned by asset_get_dbr() alive on a
+// worker thread until asset_dbr_release()
+// returns: token for asset_dbr_release()
+int asset_dbr_acquire(void);
+
+// asset_dbr_release - end a section started by asset_dbr_acquire()
+// token: value returned by asset_dbr_acquire()
+void asset_dbr_release(int token);
+
+// asset_read_record - read a record by location, via the persistent cache
+// file_id: index file table id of the ARZ
+// offset: record offset within the ARZ (TQAssetEntry.offset)
+// size: compressed record size (TQAssetEntry.size)
+// returns: newly allocated record data (caller frees), or NULL on failure
+TQArzRecordData *asset_read_record(uint16_t file_id, uint32_t offset, uint32_t size);
+
+// AssetPathFunc - callback for path-ordered entry iteration
+// entry: index entry (ARZ records have flags == 0)
+// path: normalized path of the entry (internal pointer, do not free)
+// user_data: caller context
+// returns: true to continue, false to stop the iteration
+typedef bool (*AssetPathFunc)(const TQAssetEntry *entry, const char *path, void *user_data);
+
+// asset_foreach_prefix - visit every entry whose path starts with a prefix,
+// in path order. The entries form one range of the index's path-ordered
+// view, so this costs a binary search plus the matches.
+// prefix: path prefix, e.g. "records/item/" (case and separator style are ignored)
+// fn: callback; returning false stops the iteration
+// user_data: passed through to fn
+// returns: number of entries visited
+int asset_foreach_prefix(const char *prefix, AssetPathFunc fn, void *user_data);
+
+// asset_foreach_component - visit every entry under any directory whose
+// name contains a fragment (at any depth below it), in path order. Only the
+// index's directory table is scanned, not every entry.
+// fragment: text to find in a directory name (case is ignored)
+// fn: callback; returning false stops the iteration
+// user_data: passed through to fn
+// returns: number of entries visited
+int asset_foreach_component(const char *fragment, AssetPathFunc fn, void *user_data);
+
+// asset_foreach_class - visit every ARZ record whose Class value matches,
+// in path order. The Class of every record is stored in the resource
+// index, so no record is decoded.
+// class_name: Class value to match, e.g. "LootItemTable_FixedWeight" (case is ignored)
+// fn: callback; returning false stops the iteration
+// user_data: passed through to fn
+// returns: number of records visited
+int asset_foreach_class(const char *class_name, AssetPathFunc fn, void *user_data);
+
+// asset_entry_class - get the Class value of an indexed ARZ record
+// entry: index entry
+// returns: class name (internal pointer, do not free), or NULL if the
+//          entry is not a record or has no Class value
+const char *asset_entry_class(const TQAssetEntry *entry);
+
+// asset_index_generation - identify the loaded resource index. The value
+// changes whenever the index is rewritten, so caches derived from the game
+// data can be keyed on it.
+// returns: generation number, or 0 if no index is loaded
+uint32_t asset_index_generation(void);
+
 // asset_get_num_files - get the total number of indexed game files
 // returns: number of files in the index
 int asset_get_num_files(void);
 
 // asset_cache_insert - insert a pre-built record into the DBR cache
-// key: malloc'd normalized path (ownership transferred to cache)
-// data: record data (ownership transferred to cache)
-void asset_cache_insert(char *key, TQArzRecordData *data);
+// record_path: game-relative path of the record (must be in the index)
+// data: record data (ownership transferred; freed if the path is unknown)
+void asset_cache_insert(const char *record_path, TQArzRecordData *data);
 
 // asset_manager_free - free all cached resources
 void asset_manager_free(void);
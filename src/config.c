@@ -8,7 +8,7 @@
 
 #define CONFIG_FILENAME "tqvc-config.json"
 
-TQConfig global_config = {NULL, NULL, NULL, NULL, 0, NULL};
+TQConfig global_config = {NULL, NULL, NULL, NULL, 0, 0, NULL, NULL};
 bool tqvc_debug = false;
 static bool g_first_run = false;
 
@@ -76,6 +76,21 @@ load_from_file(const char *path)
   if(json_object_object_get_ex(parsed_json, "last_vault_bag", &last_vault_bag_obj))
     global_config.last_vault_bag = json_object_get_int(last_vault_bag_obj);
 
+  struct json_object *dbr_cache_mb_obj;
+
+  if(json_object_object_get_ex(parsed_json, "dbr_cache_mb", &dbr_cache_mb_obj))
+    global_config.dbr_cache_mb = json_object_get_int(dbr_cache_mb_obj);
+
+  struct json_object *language_obj;
+
+  if(json_object_object_get_ex(parsed_json, "language", &language_obj))
+  {
+    const char *code = json_object_get_string(language_obj);
+
+    if(code && code[0])
+      global_config.language = strdup(code);
+  }
+
   global_config.config_path = strdup(path);
   json_object_put(parsed_json);
 }
@@ -263,6 +278,17 @@ config_set_last_vault_bag(int bag_idx)
   global_config.last_vault_bag = bag_idx;
 }
 
+// config_set_language - update the UI text language in config
+// code: language code, or NULL to clear
+void
+config_set_language(const char *code)
+{
+  if(global_config.language)
+    free(global_config.language);
+
+  global_config.language = code ? strdup(code) : NULL;
+}
+
 // config_is_first_run - check if no config file existed on disk at startup
 // returns: true if this is the first run
 bool
@@ -304,6 +330,14 @@ config_save(void)
   json_object_object_add(root, "last_vault_bag",
       json_object_new_int(global_config.last_vault_bag));
 
+  if(global_config.dbr_cache_mb > 0)
+    json_object_object_add(root, "dbr_cache_mb",
+        json_object_new_int(global_config.dbr_cache_mb));
+
+  if(global_config.language)
+    json_object_object_add(root, "language",
+        json_object_new_string(global_config.language));
+
   const char *json_str = json_object_to_json_string_ext(root, JSON_C_TO_STRING_PRETTY);
   // Binary mode: keeps the on-disk size honest so the read-back path's
   // size check doesn't reject our own file (Windows text mode would
@@ -349,5 +383,6 @@ config_free(void)
   free(global_config.game_folder);
   free(global_config.last_character_path);
   free(global_config.last_vault_name);
+  free(global_config.language);
   free(global_config.config_path);
 }
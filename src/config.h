@@ -9,6 +9,8 @@ typedef struct {
   char *last_character_path;
   char *last_vault_name;
   int last_vault_bag;
+  int dbr_cache_mb;  // decoded DBR record cache budget in MB (0 = default)
+  char *language;    // UI text language code, e.g. "DE" (NULL = English)
   char *config_path; // the path where the config was loaded from
 } TQConfig;
 
@@ -45,6 +47,10 @@ void config_set_last_vault(const char *name);
 // bag_idx: bag index
 void config_set_last_vault_bag(int bag_idx);
 
+// config_set_language - update the UI text language in config
+// code: language code (e.g. "DE")
+void config_set_language(const char *code);
+
 // config_is_first_run - check if no config file existed on disk at startup
 // returns: true if this is the first run
 bool config_is_first_run(void);
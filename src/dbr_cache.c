@@ -0,0 +1,457 @@
+#include "dbr_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <glib.h>
+
+#define DBR_CACHE_STRIPES 64
+#define DBR_MAX_READERS 32
+
+// DbrSlot - one cache entry; data stays NULL while the record is in flight
+// or if decoding it failed
+typedef struct {
+  const TQAssetEntry *key;
+  TQArzRecordData *data;
+  size_t bytes;             // arz_record_data_bytes(data)
+  gint referenced;          // CLOCK reference bit, set on every hit
+  bool loading;
+  bool in_ring;             // in the CLOCK ring, guarded by g_clock_mutex
+} DbrSlot;
+
+// DbrStripe - one lock stripe of the cache
+typedef struct {
+  GMutex mutex;
+  GCond loaded;             // broadcast when an in-flight decode finishes
+  GHashTable *table;        // const TQAssetEntry* -> DbrSlot*
+} DbrStripe;
+
+// RetiredRecord - an evicted record waiting for a safe point to be freed
+typedef struct {
+  TQArzRecordData *data;
+  gint epoch;               // g_epoch when it left the cache
+} RetiredRecord;
+
+static DbrStripe g_stripes[DBR_CACHE_STRIPES];
+static bool g_initialized = false;
+
+// Lock order: g_clock_mutex before any stripe mutex. Stripe mutexes are
+// never held while taking g_clock_mutex.
+static GMutex g_clock_mutex;
+static GPtrArray *g_ring = NULL;     // loaded DbrSlot*, CLOCK order
+static guint g_hand = 0;
+static size_t g_budget = 0;
+static size_t g_bytes = 0;
+static size_t g_peak_bytes = 0;
+
+static GMutex g_retire_mutex;
+static GArray *g_retired = NULL;     // RetiredRecord
+static guint g_reclaim_source = 0;
+static gint g_epoch = 1;
+static gint g_reader_epochs[DBR_MAX_READERS];  // 0 = slot free
+
+static gint g_hits = 0;
+static gint g_misses = 0;
+static gint g_waits = 0;
+static gint g_evictions = 0;
+
+// slot_free - GDestroyNotify for DbrSlot values
+// p: slot to free along with its record
+static void
+slot_free(gpointer p)
+{
+  DbrSlot *slot = p;
+
+  arz_record_data_free(slot->data);
+  free(slot);
+}
+
+// stripe_for - pick the lock stripe for an entry
+// entry: index entry of the record
+// returns: stripe guarding that entry
+static DbrStripe *
+stripe_for(const TQAssetEntry *entry)
+{
+  // the low hash bits are independent of the top bits used by the index
+  return(&g_stripes[entry->hash & (DBR_CACHE_STRIPES - 1)]);
+}
+
+// reclaim_cb - free retired records no reader can still be using
+// user_data: unused
+// returns: G_SOURCE_REMOVE (rescheduled by retire/reclaim as needed)
+static gboolean
+reclaim_cb(gpointer user_data)
+{
+  (void)user_data;
+
+  g_mutex_lock(&g_retire_mutex);
+  g_reclaim_source = 0;
+
+  gint oldest = G_MAXINT;
+
+  for(int i = 0; i < DBR_MAX_READERS; i++)
+  {
+    gint e = g_atomic_int_get(&g_reader_epochs[i]);
+
+    if(e != 0 && e < oldest)
+      oldest = e;
+  }
+
+  // a record retired in an epoch older than every active reader's start
+  // was out of the cache before those readers could look it up
+  guint keep = 0;
+
+  for(guint i = 0; i < g_retired->len; i++)
+  {
+    RetiredRecord *r = &g_array_index(g_retired, RetiredRecord, i);
+
+    if(r->epoch < oldest)
+      arz_record_data_free(r->data);
+    else
+      g_array_index(g_retired, RetiredRecord, keep++) = *r;
+  }
+
+  g_array_set_size(g_retired, keep);
+  g_atomic_int_inc(&g_epoch);
+
+  // readers still hold some: try again shortly
+  if(keep > 0)
+    g_reclaim_source = g_timeout_add(100, reclaim_cb, NULL);
+
+  g_mutex_unlock(&g_retire_mutex);
+  return(G_SOURCE_REMOVE);
+}
+
+// retire_record - queue an evicted record for deferred reclamation
+// data: record that has been removed from the cache
+static void
+retire_record(TQArzRecordData *data)
+{
+  if(!data)
+    return;
+
+  RetiredRecord r;
+
+  g_mutex_lock(&g_retire_mutex);
+  r.data = data;
+  r.epoch = g_atomic_int_get(&g_epoch);
+  g_array_append_val(g_retired, r);
+
+  if(g_reclaim_source == 0)
+    g_reclaim_source = g_idle_add(reclaim_cb, NULL);
+
+  g_mutex_unlock(&g_retire_mutex);
+}
+
+// evict_one - advance the CLOCK hand and evict one unreferenced record.
+// Called with g_clock_mutex held.
+// returns: true if a record was evicted
+static bool
+evict_one(void)
+{
+  for(guint scanned = 0; scanned < 2 * g_ring->len; scanned++)
+  {
+    if(g_hand >= g_ring->len)
+      g_hand = 0;
+
+    DbrSlot *slot = g_ring->pdata[g_hand];
+
+    if(g_atomic_int_get(&slot->referenced))
+    {
+      g_atomic_int_set(&slot->referenced, 0);
+      g_hand++;
+      continue;
+    }
+
+    DbrStripe *s = stripe_for(slot->key);
+
+    g_mutex_lock(&s->mutex);
+    g_hash_table_steal(s->table, slot->key);
+    g_mutex_unlock(&s->mutex);
+
+    // the last slot takes the hand's place; close enough for CLOCK
+    g_ptr_array_remove_index_fast(g_ring, g_hand);
+    g_bytes -= slot->bytes;
+    retire_record(slot->data);
+    free(slot);
+    g_atomic_int_inc(&g_evictions);
+    return(true);
+  }
+
+  return(false);
+}
+
+// account_slot - add a loaded slot to the CLOCK ring and evict down to
+// the budget. Called with g_clock_mutex held.
+// slot: loaded slot not yet in the ring
+static void
+account_slot(DbrSlot *slot)
+{
+  g_ptr_array_add(g_ring, slot);
+  slot->in_ring = true;
+  g_bytes += slot->bytes;
+
+  if(g_bytes > g_peak_bytes)
+    g_peak_bytes = g_bytes;
+
+  while(g_budget > 0 && g_bytes > g_budget && g_ring->len > 1)
+  {
+    if(!evict_one())
+      break;
+  }
+}
+
+// dbr_cache_init - create an empty cache
+// budget_bytes: soft limit on cached record bytes (0 = unlimited)
+void
+dbr_cache_init(size_t budget_bytes)
+{
+  if(g_initialized)
+    return;
+
+  for(int i = 0; i < DBR_CACHE_STRIPES; i++)
+  {
+    g_mutex_init(&g_stripes[i].mutex);
+    g_cond_init(&g_stripes[i].loaded);
+    g_stripes[i].table = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, slot_free);
+  }
+
+  g_ring = g_ptr_array_new();
+  g_retired = g_array_new(FALSE, FALSE, sizeof(RetiredRecord));
+  g_hand = 0;
+  g_budget = budget_bytes;
+  g_bytes = 0;
+  g_peak_bytes = 0;
+  g_initialized = true;
+}
+
+// dbr_cache_get - return a cached record, decoding it on first use
+// entry: index entry of the record (the cache key)
+// load: decoder called at most once per entry, without any lock held
+// returns: record data owned by the cache, or NULL if it could not be decoded
+TQArzRecordData *
+dbr_cache_get(const TQAssetEntry *entry, DbrCacheLoadFunc load)
+{
+  if(!g_initialized || !entry)
+    return(NULL);
+
+  DbrStripe *s = stripe_for(entry);
+
+  g_mutex_lock(&s->mutex);
+
+  DbrSlot *slot = g_hash_table_lookup(s->table, entry);
+
+  if(slot)
+  {
+    // another thread is decoding this record: wait for its result
+    if(slot->loading)
+    {
+      g_atomic_int_inc(&g_waits);
+
+      while(slot->loading)
+        g_cond_wait(&s->loaded, &s->mutex);
+    }
+
+    TQArzRecordData *data = slot->data;
+
+    g_atomic_int_set(&slot->referenced, 1);
+    g_mutex_unlock(&s->mutex);
+    g_atomic_int_inc(&g_hits);
+    return(data);
+  }
+
+  slot = calloc(1, sizeof(DbrSlot));
+
+  if(!slot)
+  {
+    g_mutex_unlock(&s->mutex);
+    return(NULL);
+  }
+
+  slot->key = entry;
+  slot->loading = true;
+  g_hash_table_insert(s->table, (gpointer)entry, slot);
+  g_mutex_unlock(&s->mutex);
+  g_atomic_int_inc(&g_misses);
+
+  TQArzRecordData *data = load ? load(entry) : NULL;
+
+  // slots are never evicted while in flight, so slot is still ours. A
+  // loaded slot is published and put in the ring under g_clock_mutex, so
+  // dbr_cache_insert() never sees it half accounted; failed decodes stay
+  // as empty slots outside the ring.
+  if(data)
+    g_mutex_lock(&g_clock_mutex);
+
+  g_mutex_lock(&s->mutex);
+  slot->data = data;
+  slot->bytes = arz_record_data_bytes(data);
+  slot->referenced = 1;
+  slot->loading = false;
+  g_cond_broadcast(&s->loaded);
+  g_mutex_unlock(&s->mutex);
+
+  if(data)
+  {
+    account_slot(slot);
+    g_mutex_unlock(&g_clock_mutex);
+  }
+
+  return(data);
+}
+
+// dbr_cache_insert - store a pre-built record, replacing any cached one
+// entry: index entry of the record
+// data: record data (ownership transferred; freed if the entry is in flight)
+void
+dbr_cache_insert(const TQAssetEntry *entry, TQArzRecordData *data)
+{
+  if(!g_initialized || !entry || !data)
+  {
+    arz_record_data_free(data);
+    return;
+  }
+
+  DbrStripe *s = stripe_for(entry);
+  size_t bytes = arz_record_data_bytes(data);
+
+  g_mutex_lock(&g_clock_mutex);
+  g_mutex_lock(&s->mutex);
+
+  DbrSlot *slot = g_hash_table_lookup(s->table, entry);
+
+  if(slot && slot->loading)
+  {
+    g_mutex_unlock(&s->mutex);
+    g_mutex_unlock(&g_clock_mutex);
+    arz_record_data_free(data);
+    return;
+  }
+
+  if(slot)
+  {
+    // replace in place; readers may still hold the old record
+    TQArzRecordData *old = slot->data;
+
+    if(slot->in_ring)
+      g_bytes -= slot->bytes;
+
+    slot->data = data;
+    slot->bytes = bytes;
+    g_mutex_unlock(&s->mutex);
+
+    if(slot->in_ring)
+      g_bytes += bytes;
+    else
+      account_slot(slot);
+
+    retire_record(old);
+    g_mutex_unlock(&g_clock_mutex);
+    return;
+  }
+
+  slot = calloc(1, sizeof(DbrSlot));
+
+  if(!slot)
+  {
+    g_mutex_unlock(&s->mutex);
+    g_mutex_unlock(&g_clock_mutex);
+    arz_record_data_free(data);
+    return;
+  }
+
+  slot->key = entry;
+  slot->data = data;
+  slot->bytes = bytes;
+  slot->referenced = 1;
+  g_hash_table_insert(s->table, (gpointer)entry, slot);
+  g_mutex_unlock(&s->mutex);
+  account_slot(slot);
+  g_mutex_unlock(&g_clock_mutex);
+}
+
+// dbr_cache_read_begin - pin records for a non-main thread. Records obtained
+// until the matching dbr_cache_read_end() are not freed, even if evicted.
+// returns: token to pass to dbr_cache_read_end()
+int
+dbr_cache_read_begin(void)
+{
+  for(;;)
+  {
+    gint epoch = g_atomic_int_get(&g_epoch);
+
+    for(int i = 0; i < DBR_MAX_READERS; i++)
+    {
+      if(g_atomic_int_compare_and_exchange(&g_reader_epochs[i], 0, epoch))
+        return(i);
+    }
+
+    // every reader slot is taken; wait for one to be released
+    g_thread_yield();
+  }
+}
+
+// dbr_cache_read_end - end a section started by dbr_cache_read_begin()
+// token: value returned by dbr_cache_read_begin()
+void
+dbr_cache_read_end(int token)
+{
+  if(token >= 0 && token < DBR_MAX_READERS)
+    g_atomic_int_set(&g_reader_epochs[token], 0);
+}
+
+// dbr_cache_print_stats - print hit/miss/eviction counters and byte usage
+void
+dbr_cache_print_stats(void)
+{
+  if(!g_initialized)
+    return;
+
+  g_mutex_lock(&g_clock_mutex);
+
+  size_t bytes = g_bytes;
+  size_t peak = g_peak_bytes;
+  guint records = g_ring->len;
+
+  g_mutex_unlock(&g_clock_mutex);
+
+  printf("DBR cache: %d hits, %d misses (%d waited on in-flight decode), "
+         "%d evictions, %u records, %zu KB (peak %zu KB, budget %zu KB)\n",
+         g_atomic_int_get(&g_hits), g_atomic_int_get(&g_misses),
+         g_atomic_int_get(&g_waits), g_atomic_int_get(&g_evictions),
+         records, bytes / 1024, peak / 1024, g_budget / 1024);
+}
+
+// dbr_cache_free - free every cached and retired record and the cache itself
+void
+dbr_cache_free(void)
+{
+  if(!g_initialized)
+    return;
+
+  for(int i = 0; i < DBR_CACHE_STRIPES; i++)
+  {
+    g_hash_table_destroy(g_stripes[i].table);
+    g_stripes[i].table = NULL;
+    g_mutex_clear(&g_stripes[i].mutex);
+    g_cond_clear(&g_stripes[i].loaded);
+  }
+
+  g_mutex_lock(&g_retire_mutex);
+
+  if(g_reclaim_source)
+    g_source_remove(g_reclaim_source);
+
+  g_reclaim_source = 0;
+
+  for(guint i = 0; i < g_retired->len; i++)
+    arz_record_data_free(g_array_index(g_retired, RetiredRecord, i).data);
+
+  g_array_free(g_retired, TRUE);
+  g_retired = NULL;
+  g_mutex_unlock(&g_retire_mutex);
+
+  g_ptr_array_free(g_ring, TRUE);
+  g_ring = NULL;
+  g_bytes = 0;
+  g_initialized = false;
+}
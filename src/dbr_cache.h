@@ -0,0 +1,56 @@
+#ifndef DBR_CACHE_H
+#define DBR_CACHE_H
+
+#include "asset_index.h"
+#include "arz.h"
+#include <stddef.h>
+
+// The DBR cache holds decoded records keyed on their resource index entry.
+// It is split into lock stripes so the UI thread and the prefetch threads
+// rarely contend, and a record being decoded is marked in flight: other
+// threads asking for it wait for that one decode instead of repeating it.
+//
+// The cache is bounded by a byte budget and evicts with CLOCK (a hit sets
+// the record's reference bit; the hand clears bits and evicts the first
+// unreferenced record). Evicted records are not freed on the spot: they
+// are retired and reclaimed from a main-loop idle callback, so a record
+// returned to main-thread code stays valid until control returns to the
+// main loop. Other threads that hold records longer must bracket their
+// work with dbr_cache_read_begin()/dbr_cache_read_end().
+
+// DbrCacheLoadFunc - decode a record on a cache miss
+// entry: index entry of the record
+// returns: newly allocated record data (ownership passes to the cache), or NULL
+typedef TQArzRecordData *(*DbrCacheLoadFunc)(const TQAssetEntry *entry);
+
+// dbr_cache_init - create an empty cache
+// budget_bytes: soft limit on cached record bytes (0 = unlimited)
+void dbr_cache_init(size_t budget_bytes);
+
+// dbr_cache_get - return a cached record, decoding it on first use
+// entry: index entry of the record (the cache key)
+// load: decoder called at most once per entry, without any lock held
+// returns: record data owned by the cache, or NULL if it could not be decoded
+TQArzRecordData *dbr_cache_get(const TQAssetEntry *entry, DbrCacheLoadFunc load);
+
+// dbr_cache_insert - store a pre-built record, replacing any cached one
+// entry: index entry of the record
+// data: record data (ownership transferred; freed if the entry is in flight)
+void dbr_cache_insert(const TQAssetEntry *entry, TQArzRecordData *data);
+
+// dbr_cache_read_begin - pin records for a non-main thread. Records obtained
+// until the matching dbr_cache_read_end() are not freed, even if evicted.
+// returns: token to pass to dbr_cache_read_end()
+int dbr_cache_read_begin(void);
+
+// dbr_cache_read_end - end a section started by dbr_cache_read_begin()
+// token: value returned by dbr_cache_read_begin()
+void dbr_cache_read_end(int token);
+
+// dbr_cache_print_stats - print hit/miss/eviction counters and byte usage
+void dbr_cache_print_stats(void);
+
+// dbr_cache_free - free every cached and retired record and the cache itself
+void dbr_cache_free(void);
+
+#endif
@@ -1,4 +1,5 @@
 #include "dds_decode.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -11,6 +12,9 @@
 //   8   dwFlags
 //   12  dwHeight
 //   16  dwWidth
+//   20  dwPitchOrLinearSize
+//   24  dwDepth
+//   28  dwMipMapCount (valid when dwFlags has DDSD_MIPMAPCOUNT)
 //   ...
 //   76  ddspf.dwSize (=32)
 //   80  ddspf.dwFlags
@@ -21,6 +25,8 @@
 //   100 ddspf.dwBBitMask
 //   104 ddspf.dwABitMask
 
+#define DDSD_MIPMAPCOUNT 0x20000
+
 #define DDPF_ALPHAPIXELS 0x1
 #define DDPF_FOURCC      0x4
 #define DDPF_RGB         0x40
@@ -173,22 +179,16 @@ decode_bc3_alpha(const uint8_t *alpha_block, uint8_t *out, int x, int y,
   }
 }
 
-static uint8_t *
-decode_bcn(const uint8_t *blocks, size_t blocks_size, int width, int height, int variant)
+// Decode every block with the reference per-pixel routines above.
+// out must hold width * height RGBA pixels.
+static void
+decode_bcn_scalar(const uint8_t *blocks, int width, int height, int variant, uint8_t *out)
 {
   // variant: 1=BC1, 2=BC2, 3=BC3
   int block_bytes = (variant == 1) ? 8 : 16;
   int blocks_w = (width + 3) / 4;
   int blocks_h = (height + 3) / 4;
 
-  if(blocks_size < (size_t)(blocks_w * blocks_h * block_bytes))
-    return(NULL);
-
-  uint8_t *out = calloc((size_t)width * (size_t)height, 4);
-
-  if(!out)
-    return(NULL);
-
   for(int by = 0; by < blocks_h; by++)
   {
     for(int bx = 0; bx < blocks_w; bx++)
@@ -214,6 +214,499 @@ decode_bcn(const uint8_t *blocks, size_t blocks_size, int width, int height, int
       }
     }
   }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DDS_HAVE_X86 1
+#include <immintrin.h>
+
+// The vector decoders below build each block's palette as RGBA words
+// (little-endian, so a word's bytes are R, G, B, A in memory), look the 16
+// texels up in it and store whole 4-texel rows. Interior blocks need no
+// bounds checks; blocks on the right/bottom edge go through a clipped copy.
+// Every value matches the scalar routines bit for bit: the RGB565 expansion
+// is tabulated and the divisions by 3, 5 and 7 are exact reciprocal
+// multiplies over the ranges that occur.
+
+#define RGBA_WORD(r, g, b, a) \
+  ((uint32_t)(r) | ((uint32_t)(g) << 8) | ((uint32_t)(b) << 16) | ((uint32_t)(a) << 24))
+
+// v * 255 / 31 and v * 255 / 63
+static const uint8_t expand5[32] = {
+  0, 8, 16, 24, 32, 41, 49, 57, 65, 74, 82, 90, 98, 106, 115, 123, 131, 139,
+  148, 156, 164, 172, 180, 189, 197, 205, 213, 222, 230, 238, 246, 255
+};
+
+static const uint8_t expand6[64] = {
+  0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60, 64, 68, 72, 76,
+  80, 85, 89, 93, 97, 101, 105, 109, 113, 117, 121, 125, 129, 133, 137, 141,
+  145, 149, 153, 157, 161, 165, 170, 174, 178, 182, 186, 190, 194, 198, 202,
+  206, 210, 214, 218, 222, 226, 230, 234, 238, 242, 246, 250, 255
+};
+
+// x / 3 for x < 98304
+static inline uint32_t
+div3(uint32_t x)
+{
+  return((x * 43691u) >> 17);
+}
+
+// x / 5 for x < 1300
+static inline uint32_t
+div5(uint32_t x)
+{
+  return((x * 13108u) >> 16);
+}
+
+// x / 7 for x < 1800
+static inline uint32_t
+div7(uint32_t x)
+{
+  return((x * 9363u) >> 16);
+}
+
+// Build the four RGBA words of a BC1 color block.
+static inline void
+bc1_palette(const uint8_t *block, uint32_t pal[4], int bc1_alpha_punchthrough)
+{
+  uint32_t c0 = (uint32_t)(block[0] | (block[1] << 8));
+  uint32_t c1 = (uint32_t)(block[2] | (block[3] << 8));
+  uint32_t r0 = expand5[c0 >> 11], g0 = expand6[(c0 >> 5) & 0x3F], b0 = expand5[c0 & 0x1F];
+  uint32_t r1 = expand5[c1 >> 11], g1 = expand6[(c1 >> 5) & 0x3F], b1 = expand5[c1 & 0x1F];
+
+  pal[0] = RGBA_WORD(r0, g0, b0, 255);
+  pal[1] = RGBA_WORD(r1, g1, b1, 255);
+
+  if(c0 > c1)
+  {
+    pal[2] = RGBA_WORD(div3(2 * r0 + r1 + 1), div3(2 * g0 + g1 + 1), div3(2 * b0 + b1 + 1), 255);
+    pal[3] = RGBA_WORD(div3(r0 + 2 * r1 + 1), div3(g0 + 2 * g1 + 1), div3(b0 + 2 * b1 + 1), 255);
+  }
+  else
+  {
+    pal[2] = RGBA_WORD((r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2, 255);
+    pal[3] = bc1_alpha_punchthrough ? 0 : RGBA_WORD(0, 0, 0, 255);
+  }
+}
+
+// Build the eight BC3 alpha values, already shifted into the alpha byte.
+static inline void
+bc3_alpha_palette(const uint8_t *alpha_block, uint32_t apal[8])
+{
+  uint32_t a0 = alpha_block[0];
+  uint32_t a1 = alpha_block[1];
+
+  apal[0] = a0 << 24;
+  apal[1] = a1 << 24;
+
+  if(a0 > a1)
+  {
+    for(uint32_t i = 1; i <= 6; i++)
+      apal[i + 1] = div7((7 - i) * a0 + i * a1 + 3) << 24;
+  }
+  else
+  {
+    for(uint32_t i = 1; i <= 4; i++)
+      apal[i + 1] = div5((5 - i) * a0 + i * a1 + 2) << 24;
+
+    apal[6] = 0;
+    apal[7] = 255u << 24;
+  }
+}
+
+// Decode one block into 16 RGBA words in row order.
+static inline void
+bc_tile_words(const uint8_t *blk, int variant, uint32_t tile[16])
+{
+  const uint8_t *color = (variant == 1) ? blk : blk + 8;
+  uint32_t pal[4];
+  uint32_t indices = read_le32(color + 4);
+
+  bc1_palette(color, pal, variant == 1);
+
+  for(int i = 0; i < 16; i++)
+    tile[i] = pal[(indices >> (2 * i)) & 0x3];
+
+  if(variant == 2)
+  {
+    uint64_t bits = (uint64_t)read_le32(blk) | ((uint64_t)read_le32(blk + 4) << 32);
+
+    for(int i = 0; i < 16; i++)
+      tile[i] = (tile[i] & 0x00FFFFFFu) | ((uint32_t)((bits >> (4 * i)) & 0xF) * 17u << 24);
+  }
+  else if(variant == 3)
+  {
+    uint32_t apal[8];
+    uint64_t bits = 0;
+
+    bc3_alpha_palette(blk, apal);
+
+    for(int i = 0; i < 6; i++)
+      bits |= ((uint64_t)blk[2 + i]) << (8 * i);
+
+    for(int i = 0; i < 16; i++)
+      tile[i] = (tile[i] & 0x00FFFFFFu) | apal[(bits >> (3 * i)) & 0x7];
+  }
+}
+
+// Copy the visible part of a decoded edge block into the image.
+static inline void
+store_tile_clipped(const uint32_t tile[16], uint8_t *out, int x, int y,
+                   int width, int height)
+{
+  int w = (width - x < 4) ? width - x : 4;
+  int h = (height - y < 4) ? height - y : 4;
+
+  for(int r = 0; r < h; r++)
+    memcpy(out + ((size_t)(y + r) * width + x) * 4, tile + 4 * r, (size_t)w * 4);
+}
+
+// Spread one tile row's packed texel indices over four 32-bit lanes: lane
+// i gets (bits >> (i * n)) & mask. SSE2 has no per-lane shift, so mul holds
+// 1 << (shift - i * n) and a 16-bit multiply lines every index up under the
+// same right shift. bits must fit in 16 bits.
+__attribute__((target("sse2")))
+static inline __m128i
+sse2_row_indices(uint32_t bits, __m128i mul, int shift, __m128i mask)
+{
+  __m128i v = _mm_mullo_epi16(_mm_set1_epi32((int)bits), mul);
+
+  return(_mm_and_si128(_mm_srli_epi32(v, shift), mask));
+}
+
+// Look each lane's index up in a palette of n broadcast words by comparing
+// it against every entry and merging the matches.
+__attribute__((target("sse2")))
+static inline __m128i
+sse2_palette_select(__m128i idx, const __m128i *pal, int n)
+{
+  __m128i r = _mm_and_si128(_mm_cmpeq_epi32(idx, _mm_setzero_si128()), pal[0]);
+
+  for(int i = 1; i < n; i++)
+    r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi32(idx, _mm_set1_epi32(i)), pal[i]));
+
+  return(r);
+}
+
+// SSE2: one register per tile row; indices are extracted and looked up
+// four texels at a time.
+__attribute__((target("sse2")))
+static void
+decode_bcn_sse2(const uint8_t *blocks, int width, int height, int variant, uint8_t *out)
+{
+  int block_bytes = (variant == 1) ? 8 : 16;
+  int blocks_w = (width + 3) / 4;
+  int blocks_h = (height + 3) / 4;
+  size_t stride = (size_t)width * 4;
+  const __m128i mul2 = _mm_setr_epi32(1 << 6, 1 << 4, 1 << 2, 1);
+  const __m128i mul3 = _mm_setr_epi32(1 << 9, 1 << 6, 1 << 3, 1);
+  const __m128i mul4 = _mm_setr_epi32(1 << 12, 1 << 8, 1 << 4, 1);
+  const __m128i rgb_mask = _mm_set1_epi32(0x00FFFFFF);
+  const __m128i mask2 = _mm_set1_epi32(0x3);
+  const __m128i mask3 = _mm_set1_epi32(0x7);
+  const __m128i mask4 = _mm_set1_epi32(0xF);
+
+  for(int by = 0; by < blocks_h; by++)
+  {
+    for(int bx = 0; bx < blocks_w; bx++)
+    {
+      const uint8_t *blk = blocks + ((size_t)by * blocks_w + bx) * block_bytes;
+      const uint8_t *color = (variant == 1) ? blk : blk + 8;
+      int x = bx * 4;
+      int y = by * 4;
+      uint32_t pal[4];
+      __m128i palv[4];
+      __m128i apalv[8];
+      __m128i rows[4];
+      uint64_t abits = 0;
+
+      bc1_palette(color, pal, variant == 1);
+
+      for(int i = 0; i < 4; i++)
+        palv[i] = _mm_set1_epi32((int)pal[i]);
+
+      if(variant == 3)
+      {
+        uint32_t apal[8];
+
+        bc3_alpha_palette(blk, apal);
+
+        for(int i = 0; i < 8; i++)
+          apalv[i] = _mm_set1_epi32((int)apal[i]);
+
+        for(int i = 0; i < 6; i++)
+          abits |= ((uint64_t)blk[2 + i]) << (8 * i);
+      }
+
+      for(int r = 0; r < 4; r++)
+      {
+        __m128i idx = sse2_row_indices(color[4 + r], mul2, 6, mask2);
+
+        rows[r] = sse2_palette_select(idx, palv, 4);
+
+        if(variant == 2)
+        {
+          // a4 * 17 in the alpha byte is (a4 << 28) | (a4 << 24)
+          __m128i a = sse2_row_indices((uint32_t)(blk[2 * r] | (blk[2 * r + 1] << 8)),
+                                       mul4, 12, mask4);
+
+          rows[r] = _mm_or_si128(_mm_and_si128(rows[r], rgb_mask),
+                                 _mm_or_si128(_mm_slli_epi32(a, 28), _mm_slli_epi32(a, 24)));
+        }
+        else if(variant == 3)
+        {
+          __m128i a = sse2_row_indices((uint32_t)(abits >> (12 * r)) & 0xFFF, mul3, 9, mask3);
+
+          rows[r] = _mm_or_si128(_mm_and_si128(rows[r], rgb_mask),
+                                 sse2_palette_select(a, apalv, 8));
+        }
+      }
+
+      if(x + 4 > width || y + 4 > height)
+      {
+        uint32_t tile[16];
+
+        for(int r = 0; r < 4; r++)
+          _mm_storeu_si128((__m128i *)(tile + 4 * r), rows[r]);
+
+        store_tile_clipped(tile, out, x, y, width, height);
+        continue;
+      }
+
+      uint8_t *row = out + (size_t)y * stride + (size_t)x * 4;
+
+      for(int r = 0; r < 4; r++)
+        _mm_storeu_si128((__m128i *)(row + r * stride), rows[r]);
+    }
+  }
+}
+
+// AVX2: two tile rows per register; texel indices are shifted into lanes
+// with variable shifts and looked up with a cross-lane permute.
+__attribute__((target("avx2")))
+static void
+decode_bcn_avx2(const uint8_t *blocks, int width, int height, int variant, uint8_t *out)
+{
+  int block_bytes = (variant == 1) ? 8 : 16;
+  int blocks_w = (width + 3) / 4;
+  int blocks_h = (height + 3) / 4;
+  size_t stride = (size_t)width * 4;
+  const __m256i shift2_top = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+  const __m256i shift2_bottom = _mm256_setr_epi32(16, 18, 20, 22, 24, 26, 28, 30);
+  const __m256i shift3 = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+  const __m256i shift4 = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+  const __m256i rgb_mask = _mm256_set1_epi32(0x00FFFFFF);
+  const __m256i mask2 = _mm256_set1_epi32(0x3);
+  const __m256i mask3 = _mm256_set1_epi32(0x7);
+  const __m256i mask4 = _mm256_set1_epi32(0xF);
+
+  for(int by = 0; by < blocks_h; by++)
+  {
+    for(int bx = 0; bx < blocks_w; bx++)
+    {
+      const uint8_t *blk = blocks + ((size_t)by * blocks_w + bx) * block_bytes;
+      int x = bx * 4;
+      int y = by * 4;
+
+      if(x + 4 > width || y + 4 > height)
+      {
+        uint32_t tile[16];
+
+        bc_tile_words(blk, variant, tile);
+        store_tile_clipped(tile, out, x, y, width, height);
+        continue;
+      }
+
+      const uint8_t *color = (variant == 1) ? blk : blk + 8;
+      uint32_t pal[4];
+
+      bc1_palette(color, pal, variant == 1);
+
+      __m256i palv = _mm256_setr_epi32((int)pal[0], (int)pal[1], (int)pal[2], (int)pal[3],
+                                       (int)pal[0], (int)pal[1], (int)pal[2], (int)pal[3]);
+      __m256i indices = _mm256_set1_epi32((int)read_le32(color + 4));
+      __m256i top = _mm256_permutevar8x32_epi32(palv,
+        _mm256_and_si256(_mm256_srlv_epi32(indices, shift2_top), mask2));
+      __m256i bottom = _mm256_permutevar8x32_epi32(palv,
+        _mm256_and_si256(_mm256_srlv_epi32(indices, shift2_bottom), mask2));
+
+      if(variant == 2)
+      {
+        // a4 * 17 in the alpha byte is (a4 << 28) | (a4 << 24)
+        __m256i a_top = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)read_le32(blk)), shift4), mask4);
+        __m256i a_bottom = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)read_le32(blk + 4)), shift4), mask4);
+
+        top = _mm256_or_si256(_mm256_and_si256(top, rgb_mask),
+                              _mm256_or_si256(_mm256_slli_epi32(a_top, 28), _mm256_slli_epi32(a_top, 24)));
+        bottom = _mm256_or_si256(_mm256_and_si256(bottom, rgb_mask),
+                                 _mm256_or_si256(_mm256_slli_epi32(a_bottom, 28), _mm256_slli_epi32(a_bottom, 24)));
+      }
+      else if(variant == 3)
+      {
+        uint32_t apal[8];
+
+        bc3_alpha_palette(blk, apal);
+
+        __m256i apv = _mm256_loadu_si256((const __m256i *)apal);
+        uint32_t bits_top = (uint32_t)(blk[2] | (blk[3] << 8) | (blk[4] << 16));
+        uint32_t bits_bottom = (uint32_t)(blk[5] | (blk[6] << 8) | (blk[7] << 16));
+        __m256i a_top = _mm256_permutevar8x32_epi32(apv,
+          _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)bits_top), shift3), mask3));
+        __m256i a_bottom = _mm256_permutevar8x32_epi32(apv,
+          _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)bits_bottom), shift3), mask3));
+
+        top = _mm256_or_si256(_mm256_and_si256(top, rgb_mask), a_top);
+        bottom = _mm256_or_si256(_mm256_and_si256(bottom, rgb_mask), a_bottom);
+      }
+
+      uint8_t *row = out + (size_t)y * stride + (size_t)x * 4;
+
+      _mm_storeu_si128((__m128i *)row, _mm256_castsi256_si128(top));
+      _mm_storeu_si128((__m128i *)(row + stride), _mm256_extracti128_si256(top, 1));
+      _mm_storeu_si128((__m128i *)(row + 2 * stride), _mm256_castsi256_si128(bottom));
+      _mm_storeu_si128((__m128i *)(row + 3 * stride), _mm256_extracti128_si256(bottom, 1));
+    }
+  }
+}
+#endif
+
+bool
+dds_decode_path_supported(DdsDecodePath path)
+{
+  switch(path)
+  {
+    case DDS_DECODE_AUTO:
+    case DDS_DECODE_SCALAR:
+      return(true);
+#ifdef DDS_HAVE_X86
+    case DDS_DECODE_SSE2:
+      return(__builtin_cpu_supports("sse2"));
+    case DDS_DECODE_AVX2:
+      return(__builtin_cpu_supports("avx2"));
+#endif
+    default:
+      return(false);
+  }
+}
+
+#ifdef DDS_HAVE_X86
+// Decode pseudo-random blocks of every variant with a vector path and the
+// scalar one. The image is not a multiple of 4 wide or high, so edge
+// blocks are covered too.
+// returns: true if the outputs match byte for byte
+static bool
+dds_decode_path_matches_scalar(DdsDecodePath path)
+{
+  enum { W = 30, H = 29, BLOCKS = ((W + 3) / 4) * ((H + 3) / 4) };
+  uint8_t blocks[BLOCKS * 16];
+  uint32_t seed = 0x9E3779B9u;
+  bool ok = true;
+
+  for(size_t i = 0; i < sizeof(blocks); i++)
+  {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    blocks[i] = (uint8_t)seed;
+  }
+
+  for(int variant = 1; variant <= 3 && ok; variant++)
+  {
+    uint8_t *want = dds_decode_bcn(blocks, sizeof(blocks), W, H, variant, DDS_DECODE_SCALAR);
+    uint8_t *got = dds_decode_bcn(blocks, sizeof(blocks), W, H, variant, path);
+
+    ok = want && got && memcmp(want, got, (size_t)W * H * 4) == 0;
+    free(want);
+    free(got);
+  }
+
+  return(ok);
+}
+#endif
+
+// Pick the decoder for DDS_DECODE_AUTO: the fastest supported vector path
+// that reproduces the scalar output, checked once per process.
+static DdsDecodePath
+dds_decode_auto_path(void)
+{
+#ifdef DDS_HAVE_X86
+  static int chosen = -1;
+  int path = __atomic_load_n(&chosen, __ATOMIC_ACQUIRE);
+
+  if(path >= 0)
+    return((DdsDecodePath)path);
+
+  static const struct {
+    DdsDecodePath path;
+    const char *name;
+  } candidates[] = {
+    { DDS_DECODE_AVX2, "AVX2" },
+    { DDS_DECODE_SSE2, "SSE2" }
+  };
+
+  path = DDS_DECODE_SCALAR;
+
+  for(size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+  {
+    if(!dds_decode_path_supported(candidates[i].path))
+      continue;
+
+    if(dds_decode_path_matches_scalar(candidates[i].path))
+    {
+      path = candidates[i].path;
+      break;
+    }
+
+    fprintf(stderr, "dds_decode: %s decoder does not match the scalar decoder, not using it\n",
+            candidates[i].name);
+  }
+
+  // racing first callers compute the same answer
+  __atomic_store_n(&chosen, path, __ATOMIC_RELEASE);
+  return((DdsDecodePath)path);
+#else
+  return(DDS_DECODE_SCALAR);
+#endif
+}
+
+uint8_t *
+dds_decode_bcn(const uint8_t *blocks, size_t blocks_size, int width, int height,
+               int variant, DdsDecodePath path)
+{
+  int block_bytes = (variant == 1) ? 8 : 16;
+  int blocks_w = (width + 3) / 4;
+  int blocks_h = (height + 3) / 4;
+
+  if(variant < 1 || variant > 3 || width <= 0 || height <= 0 ||
+     blocks_size < (size_t)blocks_w * blocks_h * block_bytes)
+    return(NULL);
+
+  if(path == DDS_DECODE_AUTO)
+    path = dds_decode_auto_path();
+  else if(!dds_decode_path_supported(path))
+    return(NULL);
+
+  // the blocks cover every pixel, so the buffer needs no clearing
+  uint8_t *out = malloc((size_t)width * (size_t)height * 4);
+
+  if(!out)
+    return(NULL);
+
+  switch(path)
+  {
+#ifdef DDS_HAVE_X86
+    case DDS_DECODE_AVX2:
+      decode_bcn_avx2(blocks, width, height, variant, out);
+      break;
+    case DDS_DECODE_SSE2:
+      decode_bcn_sse2(blocks, width, height, variant, out);
+      break;
+#endif
+    default:
+      decode_bcn_scalar(blocks, width, height, variant, out);
+      break;
+  }
+
   return(out);
 }
 
@@ -257,39 +750,109 @@ decode_uncompressed(const uint8_t *src, size_t src_size, int width, int height,
   return(out);
 }
 
-uint8_t *
-dds_decode(const uint8_t *data, size_t size, uint32_t *out_width, uint32_t *out_height)
+// Halve an RGBA8 image with a 2x2 box filter (edge texels are repeated for
+// odd sizes). Color is weighted by alpha, so the invisible color of
+// transparent texels does not bleed into the edges of an icon as a dark
+// fringe. Frees src and updates width/height on success; returns src
+// unchanged if the new buffer cannot be allocated.
+static uint8_t *
+box_halve(uint8_t *src, uint32_t *width, uint32_t *height)
+{
+  uint32_t w = *width;
+  uint32_t h = *height;
+  uint32_t dw = w > 1 ? w / 2 : 1;
+  uint32_t dh = h > 1 ? h / 2 : 1;
+  uint8_t *dst = malloc((size_t)dw * dh * 4);
+
+  if(!dst)
+    return(src);
+
+  for(uint32_t y = 0; y < dh; y++)
+  {
+    const uint8_t *r0 = src + (size_t)(2 * y < h ? 2 * y : h - 1) * w * 4;
+    const uint8_t *r1 = src + (size_t)(2 * y + 1 < h ? 2 * y + 1 : h - 1) * w * 4;
+    uint8_t *out = dst + (size_t)y * dw * 4;
+
+    for(uint32_t x = 0; x < dw; x++)
+    {
+      size_t x0 = (size_t)(2 * x < w ? 2 * x : w - 1) * 4;
+      size_t x1 = (size_t)(2 * x + 1 < w ? 2 * x + 1 : w - 1) * 4;
+
+      const uint8_t *p[4] = { r0 + x0, r0 + x1, r1 + x0, r1 + x1 };
+      uint32_t alpha = p[0][3] + p[1][3] + p[2][3] + p[3][3];
+
+      for(int c = 0; c < 3; c++)
+      {
+        if(alpha == 0)
+        {
+          out[x * 4 + c] = (uint8_t)((p[0][c] + p[1][c] + p[2][c] + p[3][c] + 2) >> 2);
+          continue;
+        }
+
+        uint32_t sum = p[0][c] * p[0][3] + p[1][c] * p[1][3] +
+                       p[2][c] * p[2][3] + p[3][c] * p[3][3];
+
+        out[x * 4 + c] = (uint8_t)((sum + alpha / 2) / alpha);
+      }
+
+      out[x * 4 + 3] = (uint8_t)((alpha + 2) >> 2);
+    }
+  }
+
+  free(src);
+  *width = dw;
+  *height = dh;
+  return(dst);
+}
+
+// Parsed fields of a DDS header that the decoder needs.
+typedef struct {
+  uint32_t width;
+  uint32_t height;
+  uint32_t mip_count;   // levels stored in the file (at least 1)
+  int variant;          // 1..3 = BC1..BC3, 0 = uncompressed
+  int bpp;              // 24 or 32 when uncompressed
+} DdsInfo;
+
+// Validate a DDS header and read the fields the decoder needs.
+// returns: true if the file is a supported DDS texture
+static bool
+parse_header(const uint8_t *data, size_t size, DdsInfo *info)
 {
   if(size < 128)
-    return(NULL);
+    return(false);
 
-  if(memcmp(data, "DDS ", 4) != 0)
-    return(NULL);
+  // .tex files commonly use the variant magic "DDSR" instead of "DDS "
+  if(memcmp(data, "DDS", 3) != 0 || (data[3] != ' ' && data[3] != 'R'))
+    return(false);
 
   uint32_t hdr_size = read_le32(data + 4);
 
   if(hdr_size != 124)
-    return(NULL);
+    return(false);
 
-  uint32_t height = read_le32(data + 12);
-  uint32_t width = read_le32(data + 16);
+  info->height = read_le32(data + 12);
+  info->width = read_le32(data + 16);
 
-  if(width == 0 || height == 0 || width > 16384 || height > 16384)
-    return(NULL);
+  if(info->width == 0 || info->height == 0 || info->width > 16384 || info->height > 16384)
+    return(false);
+
+  info->mip_count = (read_le32(data + 8) & DDSD_MIPMAPCOUNT) ? read_le32(data + 28) : 1;
+
+  if(info->mip_count < 1)
+    info->mip_count = 1;
 
   uint32_t pf_size = read_le32(data + 76);
 
   if(pf_size != 32)
-    return(NULL);
+    return(false);
 
   uint32_t pf_flags = read_le32(data + 80);
   uint32_t fourcc = read_le32(data + 84);
   uint32_t bit_count = read_le32(data + 88);
 
-  const uint8_t *payload = data + 128;
-  size_t payload_size = size - 128;
-
-  uint8_t *pixels = NULL;
+  info->variant = 0;
+  info->bpp = 0;
 
   if(pf_flags & DDPF_FOURCC)
   {
@@ -299,30 +862,147 @@ dds_decode(const uint8_t *data, size_t size, uint32_t *out_width, uint32_t *out_
     uint32_t dxt5 = (uint32_t)('D' | ('X' << 8) | ('T' << 16) | ('5' << 24));
 
     if(fourcc == dxt1)
-      pixels = decode_bcn(payload, payload_size, (int)width, (int)height, 1);
+      info->variant = 1;
     else if(fourcc == dxt3)
-      pixels = decode_bcn(payload, payload_size, (int)width, (int)height, 2);
+      info->variant = 2;
     else if(fourcc == dxt5)
-      pixels = decode_bcn(payload, payload_size, (int)width, (int)height, 3);
+      info->variant = 3;
     else
-      return(NULL);
+      return(false);
   }
   else if(pf_flags & DDPF_RGB)
   {
     if(bit_count != 24 && bit_count != 32)
-      return(NULL);
+      return(false);
 
-    pixels = decode_uncompressed(payload, payload_size, (int)width, (int)height, (int)bit_count);
+    info->bpp = (int)bit_count;
   }
   else
   {
+    return(false);
+  }
+
+  return(true);
+}
+
+// Bytes one mip level occupies in the file.
+static size_t
+level_size(const DdsInfo *info, uint32_t width, uint32_t height)
+{
+  if(info->variant)
+    return((size_t)((width + 3) / 4) * ((height + 3) / 4) * (info->variant == 1 ? 8 : 16));
+
+  return((size_t)width * height * (size_t)(info->bpp / 8));
+}
+
+bool
+dds_get_size(const uint8_t *data, size_t size, uint32_t *out_width, uint32_t *out_height)
+{
+  DdsInfo info;
+
+  if(!parse_header(data, size, &info))
+    return(false);
+
+  *out_width = info.width;
+  *out_height = info.height;
+  return(true);
+}
+
+uint8_t *
+dds_decode_level(const uint8_t *data, size_t size, uint32_t max_level,
+                 uint32_t *out_width, uint32_t *out_height)
+{
+  DdsInfo info;
+
+  if(!parse_header(data, size, &info))
     return(NULL);
+
+  const uint8_t *payload = data + 128;
+  size_t payload_size = size - 128;
+
+  // walk the stored chain down to the requested level (or its last level)
+  uint32_t level = 0;
+  uint32_t width = info.width;
+  uint32_t height = info.height;
+  size_t offset = 0;
+
+  while(level < max_level && level + 1 < info.mip_count && (width > 1 || height > 1))
+  {
+    size_t next = offset + level_size(&info, width, height);
+    uint32_t nw = width > 1 ? width / 2 : 1;
+    uint32_t nh = height > 1 ? height / 2 : 1;
+
+    // a truncated chain ends here; the box filter below covers the rest
+    if(next + level_size(&info, nw, nh) > payload_size)
+      break;
+
+    offset = next;
+    width = nw;
+    height = nh;
+    level++;
   }
 
+  uint8_t *pixels;
+
+  if(info.variant)
+    pixels = dds_decode_bcn(payload + offset, payload_size - offset, (int)width, (int)height,
+                            info.variant, DDS_DECODE_AUTO);
+  else
+    pixels = decode_uncompressed(payload + offset, payload_size - offset, (int)width, (int)height,
+                                 info.bpp);
+
   if(!pixels)
     return(NULL);
 
+  // no stored level that small: reduce the decoded one instead
+  for(; level < max_level && (width > 1 || height > 1); level++)
+  {
+    uint8_t *halved = box_halve(pixels, &width, &height);
+
+    if(halved == pixels)
+      break;
+
+    pixels = halved;
+  }
+
   *out_width = width;
   *out_height = height;
   return(pixels);
 }
+
+uint8_t *
+dds_decode(const uint8_t *data, size_t size, uint32_t *out_width, uint32_t *out_height)
+{
+  return(dds_decode_level(data, size, 0, out_width, out_height));
+}
+
+// Scale a color channel by alpha the way cairo and pixman do: c * a / 255,
+// rounded to nearest.
+static inline uint32_t
+premultiply(uint32_t c, uint32_t a)
+{
+  uint32_t t = c * a + 0x80;
+
+  return((t + (t >> 8)) >> 8);
+}
+
+void
+dds_rgba_to_argb32_premultiplied(uint8_t *pixels, size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    uint8_t *px = pixels + i * 4;
+    uint32_t a = px[3];
+    uint32_t word;
+
+    if(a == 255)
+      word = 0xFF000000u | ((uint32_t)px[0] << 16) | ((uint32_t)px[1] << 8) | px[2];
+    else if(a == 0)
+      word = 0;
+    else
+      word = (a << 24) | (premultiply(px[0], a) << 16) |
+             (premultiply(px[1], a) << 8) | premultiply(px[2], a);
+
+    memcpy(px, &word, 4);
+  }
+}
@@ -3,9 +3,21 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 
-// Decode a DDS blob (starting at the "DDS " magic) into a freshly allocated
-// RGBA8 pixel buffer. Caller frees with free().
+// BCn decoder implementations. AUTO picks the fastest one the CPU supports
+// that reproduces the scalar decoder's output on a one-time self-check; the
+// others exist so benchmarks can compare them.
+typedef enum {
+  DDS_DECODE_AUTO,
+  DDS_DECODE_SCALAR,
+  DDS_DECODE_SSE2,
+  DDS_DECODE_AVX2
+} DdsDecodePath;
+
+// Decode a DDS blob (starting at the "DDS " magic, or the "DDSR" variant
+// used by .tex files) into a freshly allocated RGBA8 pixel buffer. Caller
+// frees with free().
 //
 // Supported pixel formats (sufficient for Titan Quest .tex assets):
 //   - DXT1 / BC1   (RGB or RGB+1bit alpha)
@@ -14,11 +26,41 @@
 //   - Uncompressed B8G8R8   (24bpp)
 //   - Uncompressed B8G8R8A8 (32bpp)
 //
-// Only the top mip level is decoded; mip chains, cubemaps, volumes and the
-// DX10 extended header are not supported.
+// Decodes mip level 0; see dds_decode_level() for smaller levels. Cubemaps,
+// volumes and the DX10 extended header are not supported.
 //
 // On success: returns RGBA pixels and writes width/height. On failure: NULL.
 uint8_t *dds_decode(const uint8_t *data, size_t size,
                     uint32_t *out_width, uint32_t *out_height);
 
+// Like dds_decode(), but for display at reduced size: decodes mip level
+// max_level (each level halves both dimensions, down to 1x1) instead of
+// level 0. If the file stores fewer levels, the smallest stored one is
+// decoded and reduced the rest of the way with a 2x2 box filter.
+// out_width/out_height receive the size actually decoded.
+uint8_t *dds_decode_level(const uint8_t *data, size_t size, uint32_t max_level,
+                          uint32_t *out_width, uint32_t *out_height);
+
+// Read the level 0 size of a DDS blob without decoding it.
+// returns: true if the header is valid and supported
+bool dds_get_size(const uint8_t *data, size_t size,
+                  uint32_t *out_width, uint32_t *out_height);
+
+// Convert decoded RGBA8 pixels in place to premultiplied ARGB32 words in
+// native byte order -- the layout of CAIRO_FORMAT_ARGB32 -- so the buffer can
+// back a cairo image surface directly.
+// pixels: buffer returned by dds_decode()
+// count: number of pixels (width * height)
+void dds_rgba_to_argb32_premultiplied(uint8_t *pixels, size_t count);
+
+// Decode raw BC1/BC2/BC3 blocks (no DDS header) into a freshly allocated
+// RGBA8 pixel buffer. Caller frees with free().
+// variant: 1 = BC1, 2 = BC2, 3 = BC3
+// path: decoder to use; NULL is returned if the CPU does not support it
+uint8_t *dds_decode_bcn(const uint8_t *blocks, size_t blocks_size, int width, int height,
+                        int variant, DdsDecodePath path);
+
+// True if the given decoder can run on this CPU.
+bool dds_decode_path_supported(DdsDecodePath path);
+
 #endif
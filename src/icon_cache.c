@@ -0,0 +1,609 @@
+#include "icon_cache.h"
+#include "texture.h"
+#include "asset_lookup.h"
+#include "config.h"
+#include "path_hash.h"
+#include "platform_mmap.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ICON_ATLAS_VERSION 1
+#define ICON_ATLAS_PAGE 1024               // atlas page width and height limit in pixels
+#define ICON_ATLAS_ALIGN 64                // file alignment of page pixel data
+#define ICON_ATLAS_MAX_BYTES (64u << 20)   // pixel data kept in one atlas file
+
+#pragma pack(push, 1)
+
+// IconAtlasHeader - header for tqvc-icon-atlas.bin
+// size: 32 bytes
+typedef struct {
+  char magic[4];             // "TQIC"
+  uint32_t version;          // ICON_ATLAS_VERSION
+  uint32_t index_generation; // resource index generation the icons came from
+  uint32_t num_entries;      // number of IconAtlasEntry records
+  uint32_t entries_offset;   // offset to IconAtlasEntry array (sorted by hash)
+  uint32_t num_pages;        // number of IconAtlasPage records
+  uint32_t pages_offset;     // offset to IconAtlasPage array
+  uint32_t strings_offset;   // offset to null-terminated cache keys
+} IconAtlasHeader;
+
+// IconAtlasPage - one page of premultiplied native-endian ARGB32 pixels,
+// the layout cairo uses, so pages are wrapped without conversion
+// size: 16 bytes
+typedef struct {
+  uint32_t data_offset;      // offset to the pixels (ICON_ATLAS_ALIGN aligned)
+  uint32_t stride;           // bytes per row
+  uint16_t width;            // page width in pixels
+  uint16_t height;           // page height in pixels
+  uint32_t reserved;
+} IconAtlasPage;
+
+// IconAtlasEntry - one icon and its rectangle on a page
+// size: 28 bytes
+typedef struct {
+  uint64_t hash;             // path_hash() of the cache key
+  uint32_t key_offset;       // cache key, relative to strings_offset
+  uint16_t page;             // index of the IconAtlasPage
+  uint16_t x, y;             // top-left corner on the page
+  uint16_t width, height;    // icon size in pixels
+  uint16_t base_width;       // level 0 size of the texture
+  uint16_t base_height;
+  uint16_t reserved;
+} IconAtlasEntry;
+
+#pragma pack(pop)
+
+// IconAtlasMap - the mapped atlas file. Every surface served from it holds
+// a reference, so the mapping outlives icon_cache_free() while icons that
+// point into it are still drawn.
+typedef struct {
+  uint8_t *data;
+  size_t size;
+  gint refs;
+} IconAtlasMap;
+
+// IconSource - an icon to write: a rectangle of ARGB32 pixels from the
+// mapped atlas or from a surface decoded this session
+typedef struct {
+  const char *key;
+  const uint8_t *pixels;
+  int stride;
+  int width, height;
+  int base_width, base_height;
+  int page, x, y;            // placement in the new atlas
+} IconSource;
+
+static IconAtlasMap *g_atlas = NULL;
+static const IconAtlasEntry *g_entries = NULL;
+static const IconAtlasPage *g_pages = NULL;
+static const char *g_strings = NULL;
+static size_t g_strings_size = 0;
+static uint32_t g_num_entries = 0;
+static uint32_t g_atlas_generation = 0;   // generation last opened (0 = not yet)
+static GHashTable *g_added = NULL;        // key -> cairo_surface_t* decoded this session
+
+static cairo_user_data_key_t atlas_key;
+
+// icon_cache_path - path of the atlas file
+// returns: newly allocated path (caller frees with g_free)
+static char *
+icon_cache_path(void)
+{
+  char *cache_dir = tqvc_cache_dir_new();
+  char *path = g_build_filename(cache_dir, "tqvc-icon-atlas.bin", NULL);
+
+  g_free(cache_dir);
+  return(path);
+}
+
+// atlas_unref - drop a reference to the mapped atlas, unmapping it with the last
+// data: IconAtlasMap
+static void
+atlas_unref(void *data)
+{
+  IconAtlasMap *map = data;
+
+  if(!g_atomic_int_dec_and_test(&map->refs))
+    return;
+
+  platform_munmap(map->data, map->size);
+  g_free(map);
+}
+
+// atlas_attach - check a mapped atlas and point the lookup globals at it
+// data: mapped file
+// size: file size in bytes
+// generation: resource index generation the atlas must match
+// returns: true if the atlas is valid and current
+static bool
+atlas_attach(const uint8_t *data, size_t size, uint32_t generation)
+{
+  if(size < sizeof(IconAtlasHeader))
+    return(false);
+
+  const IconAtlasHeader *h = (const IconAtlasHeader *)data;
+
+  if(memcmp(h->magic, "TQIC", 4) != 0 || h->version != ICON_ATLAS_VERSION ||
+     h->index_generation != generation ||
+     (uint64_t)h->entries_offset + (uint64_t)h->num_entries * sizeof(IconAtlasEntry) > size ||
+     (uint64_t)h->pages_offset + (uint64_t)h->num_pages * sizeof(IconAtlasPage) > size ||
+     h->strings_offset > size)
+    return(false);
+
+  const IconAtlasEntry *entries = (const IconAtlasEntry *)(data + h->entries_offset);
+  const IconAtlasPage *pages = (const IconAtlasPage *)(data + h->pages_offset);
+  const char *strings = (const char *)data + h->strings_offset;
+  size_t strings_size = 0;
+
+  // the key pool runs up to the first page's pixels; every key must end in it
+  for(uint32_t i = 0; i < h->num_pages; i++)
+  {
+    const IconAtlasPage *p = &pages[i];
+
+    if(p->data_offset % ICON_ATLAS_ALIGN != 0 || p->stride % 4 != 0 ||
+       p->stride < (uint32_t)p->width * 4 ||
+       (uint64_t)p->data_offset + (uint64_t)p->stride * p->height > size ||
+       p->data_offset < h->strings_offset)
+      return(false);
+
+    if(i == 0 || p->data_offset - h->strings_offset < strings_size)
+      strings_size = p->data_offset - h->strings_offset;
+  }
+
+  if(h->num_pages == 0)
+    strings_size = size - h->strings_offset;
+
+  if(strings_size > 0 && memchr(strings, '\0', strings_size) == NULL)
+    return(false);
+
+  for(uint32_t i = 0; i < h->num_entries; i++)
+  {
+    const IconAtlasEntry *e = &entries[i];
+
+    if(e->key_offset >= strings_size ||
+       memchr(strings + e->key_offset, '\0', strings_size - e->key_offset) == NULL ||
+       e->page >= h->num_pages || e->width == 0 || e->height == 0 ||
+       (uint32_t)e->x + e->width > pages[e->page].width ||
+       (uint32_t)e->y + e->height > pages[e->page].height)
+      return(false);
+  }
+
+  g_entries = entries;
+  g_pages = pages;
+  g_strings = strings;
+  g_strings_size = strings_size;
+  g_num_entries = h->num_entries;
+  return(true);
+}
+
+// atlas_detach - drop the cache's hold on the mapped atlas
+static void
+atlas_detach(void)
+{
+  if(g_atlas)
+    atlas_unref(g_atlas);
+
+  g_atlas = NULL;
+  g_entries = NULL;
+  g_pages = NULL;
+  g_strings = NULL;
+  g_strings_size = 0;
+  g_num_entries = 0;
+}
+
+// atlas_open - map the atlas file for the loaded resource index, once per
+// index generation
+// returns: true if an atlas is attached
+static bool
+atlas_open(void)
+{
+  uint32_t generation = asset_index_generation();
+
+  if(generation == 0)
+    return(false);
+
+  if(generation == g_atlas_generation)
+    return(g_atlas != NULL);
+
+  atlas_detach();
+  g_atlas_generation = generation;
+
+  char *path = icon_cache_path();
+  size_t size = 0;
+  uint8_t *data = platform_mmap_readonly(path, &size);
+
+  g_free(path);
+
+  if(!data)
+    return(false);
+
+  if(!atlas_attach(data, size, generation))
+  {
+    platform_munmap(data, size);
+    atlas_detach();
+    return(false);
+  }
+
+  g_atlas = g_new0(IconAtlasMap, 1);
+  g_atlas->data = data;
+  g_atlas->size = size;
+  g_atlas->refs = 1;
+
+  if(tqvc_debug)
+    printf("Icon cache: %u icons mapped (%zu bytes)\n", g_num_entries, size);
+
+  return(true);
+}
+
+// atlas_find - find an icon in the attached atlas
+// key: texture cache key
+// returns: entry, or NULL if the key is not in the atlas
+static const IconAtlasEntry *
+atlas_find(const char *key)
+{
+  return(path_sorted_find(g_entries, g_num_entries, sizeof(IconAtlasEntry),
+                          offsetof(IconAtlasEntry, hash),
+                          offsetof(IconAtlasEntry, key_offset),
+                          g_strings, key));
+}
+
+// icon_cache_lookup - get a cached icon
+// key: texture cache key
+// returns: new surface over the mapped atlas (caller destroys), or NULL
+cairo_surface_t *
+icon_cache_lookup(const char *key)
+{
+  if(!key || !atlas_open())
+    return(NULL);
+
+  const IconAtlasEntry *e = atlas_find(key);
+
+  if(!e)
+    return(NULL);
+
+  const IconAtlasPage *p = &g_pages[e->page];
+
+  // the mapping is read-only: these surfaces are only ever used as sources
+  uint8_t *pixels = g_atlas->data + p->data_offset +
+                    (size_t)e->y * p->stride + (size_t)e->x * 4;
+  cairo_surface_t *surface = cairo_image_surface_create_for_data(pixels,
+      CAIRO_FORMAT_ARGB32, e->width, e->height, (int)p->stride);
+
+  if(cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS)
+  {
+    cairo_surface_destroy(surface);
+    return(NULL);
+  }
+
+  g_atomic_int_inc(&g_atlas->refs);
+  if(cairo_surface_set_user_data(surface, &atlas_key, g_atlas, atlas_unref) != CAIRO_STATUS_SUCCESS)
+  {
+    atlas_unref(g_atlas);
+    cairo_surface_destroy(surface);
+    return(NULL);
+  }
+
+  texture_set_base_size(surface, e->base_width, e->base_height);
+  return(surface);
+}
+
+// icon_cache_add - remember an icon decoded this session
+// key: texture cache key (copied)
+// surface: decoded icon (a reference is taken)
+void
+icon_cache_add(const char *key, cairo_surface_t *surface)
+{
+  if(!key || !surface ||
+     cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE ||
+     cairo_image_surface_get_format(surface) != CAIRO_FORMAT_ARGB32 ||
+     cairo_surface_get_user_data(surface, &atlas_key))
+    return;
+
+  if(atlas_open() && atlas_find(key))
+    return;
+
+  if(!g_added)
+    g_added = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                    (GDestroyNotify)cairo_surface_destroy);
+
+  g_hash_table_replace(g_added, g_strdup(key), cairo_surface_reference(surface));
+}
+
+// compare_sources_by_height - packing order: tallest first, then widest
+static int
+compare_sources_by_height(const void *a, const void *b)
+{
+  const IconSource *sa = a;
+  const IconSource *sb = b;
+
+  if(sa->height != sb->height)
+    return(sb->height - sa->height);
+
+  return(sb->width - sa->width);
+}
+
+// compare_entries - directory order: by key hash
+static int
+compare_entries(const void *a, const void *b)
+{
+  const IconAtlasEntry *ea = a;
+  const IconAtlasEntry *eb = b;
+
+  return(ea->hash < eb->hash ? -1 : ea->hash > eb->hash);
+}
+
+// atlas_pack - place icons on shelves of ICON_ATLAS_PAGE sized pages. An
+// icon too large for a page gets a page of its own.
+// src: icons, sorted tallest first; page, x and y are filled in
+// count: number of icons
+// pages: receives the page sizes (width and height only)
+static void
+atlas_pack(IconSource *src, uint32_t count, GArray *pages)
+{
+  int cur = -1;          // page being filled with shelves
+  int shelf_x = 0;
+  int shelf_y = 0;
+  int shelf_h = 0;
+
+  for(uint32_t i = 0; i < count; i++)
+  {
+    IconSource *s = &src[i];
+
+    if(s->width > ICON_ATLAS_PAGE || s->height > ICON_ATLAS_PAGE)
+    {
+      IconAtlasPage own = {0};
+
+      own.width = (uint16_t)s->width;
+      own.height = (uint16_t)s->height;
+      g_array_append_val(pages, own);
+      s->page = (int)pages->len - 1;
+      s->x = 0;
+      s->y = 0;
+      continue;
+    }
+
+    if(cur >= 0 && shelf_x + s->width > ICON_ATLAS_PAGE)
+    {
+      shelf_y += shelf_h;
+      shelf_x = 0;
+      shelf_h = 0;
+    }
+
+    if(cur < 0 || shelf_y + s->height > ICON_ATLAS_PAGE)
+    {
+      IconAtlasPage page = {0};
+
+      g_array_append_val(pages, page);
+      cur = (int)pages->len - 1;
+      shelf_x = 0;
+      shelf_y = 0;
+      shelf_h = 0;
+    }
+
+    IconAtlasPage *p = &g_array_index(pages, IconAtlasPage, cur);
+
+    s->page = cur;
+    s->x = shelf_x;
+    s->y = shelf_y;
+    shelf_x += s->width;
+    if(s->height > shelf_h)
+      shelf_h = s->height;
+    if(shelf_x > p->width)
+      p->width = (uint16_t)shelf_x;
+    if(shelf_y + s->height > p->height)
+      p->height = (uint16_t)(shelf_y + s->height);
+  }
+}
+
+// atlas_serialize - pack icons into a new atlas file image
+// src: icons to write (reordered)
+// count: number of icons
+// generation: resource index generation to record
+// size_out: receives the image size in bytes
+// returns: malloc'd image (caller frees), or NULL on failure
+static uint8_t *
+atlas_serialize(IconSource *src, uint32_t count, uint32_t generation, size_t *size_out)
+{
+  qsort(src, count, sizeof(IconSource), compare_sources_by_height);
+
+  GArray *pages = g_array_new(FALSE, TRUE, sizeof(IconAtlasPage));
+
+  atlas_pack(src, count, pages);
+
+  IconAtlasEntry *entries = calloc(count ? count : 1, sizeof(IconAtlasEntry));
+  GString *pool = g_string_new(NULL);
+
+  for(uint32_t i = 0; i < count; i++)
+  {
+    entries[i].hash = path_hash(src[i].key);
+    entries[i].key_offset = (uint32_t)pool->len;
+    entries[i].page = (uint16_t)src[i].page;
+    entries[i].x = (uint16_t)src[i].x;
+    entries[i].y = (uint16_t)src[i].y;
+    entries[i].width = (uint16_t)src[i].width;
+    entries[i].height = (uint16_t)src[i].height;
+    entries[i].base_width = (uint16_t)src[i].base_width;
+    entries[i].base_height = (uint16_t)src[i].base_height;
+    g_string_append_len(pool, src[i].key, (gssize)strlen(src[i].key) + 1);
+  }
+
+  qsort(entries, count, sizeof(IconAtlasEntry), compare_entries);
+
+  IconAtlasHeader h;
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "TQIC", 4);
+  h.version = ICON_ATLAS_VERSION;
+  h.index_generation = generation;
+  h.num_entries = count;
+  h.entries_offset = sizeof(IconAtlasHeader);
+  h.num_pages = pages->len;
+  h.pages_offset = h.entries_offset + count * sizeof(IconAtlasEntry);
+  h.strings_offset = h.pages_offset + pages->len * sizeof(IconAtlasPage);
+
+  size_t size = (size_t)h.strings_offset + pool->len;
+
+  for(guint i = 0; i < pages->len; i++)
+  {
+    IconAtlasPage *p = &g_array_index(pages, IconAtlasPage, i);
+
+    size = (size + ICON_ATLAS_ALIGN - 1) & ~(size_t)(ICON_ATLAS_ALIGN - 1);
+    p->data_offset = (uint32_t)size;
+    p->stride = (uint32_t)p->width * 4;
+    size += (size_t)p->stride * p->height;
+  }
+
+  // zero-filled, so gaps between icons stay transparent
+  uint8_t *image = calloc(1, size);
+
+  if(image)
+  {
+    memcpy(image, &h, sizeof(h));
+    memcpy(image + h.entries_offset, entries, count * sizeof(IconAtlasEntry));
+    memcpy(image + h.pages_offset, pages->data, pages->len * sizeof(IconAtlasPage));
+    memcpy(image + h.strings_offset, pool->str, pool->len);
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+      const IconSource *s = &src[i];
+      const IconAtlasPage *p = &g_array_index(pages, IconAtlasPage, s->page);
+      uint8_t *dst = image + p->data_offset + (size_t)s->y * p->stride + (size_t)s->x * 4;
+
+      for(int row = 0; row < s->height; row++)
+        memcpy(dst + (size_t)row * p->stride, s->pixels + (size_t)row * s->stride,
+               (size_t)s->width * 4);
+    }
+
+    *size_out = size;
+  }
+
+  free(entries);
+  g_string_free(pool, TRUE);
+  g_array_free(pages, TRUE);
+  return(image);
+}
+
+// atlas_save - write an atlas image via a temporary file and rename
+// path: filesystem path of tqvc-icon-atlas.bin
+// image: serialized atlas
+// size: image size in bytes
+static void
+atlas_save(const char *path, const uint8_t *image, size_t size)
+{
+  if(!platform_write_file(path, image, size))
+    fprintf(stderr, "icon_cache_save: could not replace %s\n", path);
+}
+
+// icon_cache_save - rewrite the atlas with the cached and newly added icons
+void
+icon_cache_save(void)
+{
+  if(!g_added || g_hash_table_size(g_added) == 0)
+    return;
+
+  uint32_t generation = asset_index_generation();
+
+  if(generation == 0)
+    return;
+
+  // icons added under an older index are dropped with that index
+  if(generation != g_atlas_generation)
+  {
+    g_hash_table_remove_all(g_added);
+    return;
+  }
+
+  uint32_t capacity = g_num_entries + g_hash_table_size(g_added);
+  IconSource *src = calloc(capacity, sizeof(IconSource));
+  uint32_t count = 0;
+  size_t bytes = 0;
+
+  if(!src)
+    return;
+
+  // keep what is already cached first, then add this session's icons while
+  // they fit the size cap
+  for(uint32_t i = 0; i < g_num_entries; i++)
+  {
+    const IconAtlasEntry *e = &g_entries[i];
+    const IconAtlasPage *p = &g_pages[e->page];
+    IconSource *s = &src[count++];
+
+    s->key = g_strings + e->key_offset;
+    s->pixels = g_atlas->data + p->data_offset + (size_t)e->y * p->stride + (size_t)e->x * 4;
+    s->stride = (int)p->stride;
+    s->width = e->width;
+    s->height = e->height;
+    s->base_width = e->base_width;
+    s->base_height = e->base_height;
+    bytes += (size_t)e->width * e->height * 4;
+  }
+
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_hash_table_iter_init(&iter, g_added);
+  while(g_hash_table_iter_next(&iter, &key, &value))
+  {
+    cairo_surface_t *surface = value;
+    int width = cairo_image_surface_get_width(surface);
+    int height = cairo_image_surface_get_height(surface);
+    size_t icon_bytes = (size_t)width * height * 4;
+
+    if(width <= 0 || height <= 0 || width > UINT16_MAX || height > UINT16_MAX ||
+       bytes + icon_bytes > ICON_ATLAS_MAX_BYTES)
+      continue;
+
+    cairo_surface_flush(surface);
+
+    IconSource *s = &src[count++];
+
+    s->key = key;
+    s->pixels = cairo_image_surface_get_data(surface);
+    s->stride = cairo_image_surface_get_stride(surface);
+    s->width = width;
+    s->height = height;
+    texture_base_size(surface, &s->base_width, &s->base_height);
+    bytes += icon_bytes;
+  }
+
+  size_t size = 0;
+  uint8_t *image = atlas_serialize(src, count, generation, &size);
+
+  free(src);
+
+  // the image owns its pixels now; let go of the mapping so the file can
+  // be replaced (surfaces still in use keep their own reference)
+  atlas_detach();
+  g_atlas_generation = 0;
+
+  if(image)
+  {
+    char *path = icon_cache_path();
+
+    atlas_save(path, image, size);
+    g_free(path);
+    free(image);
+
+    if(tqvc_debug)
+      printf("Icon cache: wrote %u icons (%zu bytes)\n", count, size);
+  }
+
+  g_hash_table_remove_all(g_added);
+}
+
+// icon_cache_free - drop the session's icons and the hold on the atlas
+void
+icon_cache_free(void)
+{
+  if(g_added)
+  {
+    g_hash_table_destroy(g_added);
+    g_added = NULL;
+  }
+
+  atlas_detach();
+  g_atlas_generation = 0;
+}
@@ -0,0 +1,36 @@
+#ifndef ICON_CACHE_H
+#define ICON_CACHE_H
+
+#include <gtk/gtk.h>
+#include <stdbool.h>
+
+// The icon cache keeps decoded, display-ready icons across launches in
+// tqvc-icon-atlas.bin in the cache directory: premultiplied ARGB32 atlas
+// pages plus a key -> rectangle directory. The file is mapped read-only and
+// icons are served as surfaces over the mapping, so a cached icon costs no
+// ARC read, inflate or DDS decode. It is tied to the resource index
+// generation and ignored once the game data changes. Main thread only.
+
+// icon_cache_lookup - get a cached icon
+// key: texture cache key (e.g. "base_name:var1@level")
+// returns: new surface over the mapped atlas (caller destroys; never draw
+//          into it), or NULL if the key is not cached
+cairo_surface_t *icon_cache_lookup(const char *key);
+
+// icon_cache_add - remember an icon decoded this session so the next
+// icon_cache_save() writes it to the atlas
+// key: texture cache key (copied)
+// surface: decoded icon (a reference is taken)
+void icon_cache_add(const char *key, cairo_surface_t *surface);
+
+// icon_cache_save - rewrite the atlas file with the cached icons plus the
+// ones added this session, if any were added. The cache lets go of the old
+// mapping first; surfaces from icon_cache_lookup() should be destroyed
+// before this, as some platforms cannot replace a mapped file.
+void icon_cache_save(void);
+
+// icon_cache_free - drop the session's icons and the cache's hold on the
+// mapped atlas (surfaces still in use keep it mapped until destroyed)
+void icon_cache_free(void);
+
+#endif
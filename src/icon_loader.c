@@ -0,0 +1,314 @@
+#include "icon_loader.h"
+#include "texture.h"
+#include "asset_lookup.h"
+#include "arz.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// IconJob - one queued icon decode. The pending table on the main thread
+// maps each key to its current job; a worker fills in surface and hands the
+// job back to the main loop, which frees it.
+typedef struct {
+  char *key;
+  char *base_name;
+  uint32_t var1;
+  unsigned level;
+  IconPriority priority;
+  uint64_t seq;              // FIFO order within a priority
+  int superseded;            // atomic: replaced by a higher-priority job
+  GPtrArray *waiters;        // GtkWidget refs (main thread only)
+  cairo_surface_t *surface;  // set by the worker
+} IconJob;
+
+static GThreadPool *g_pool = NULL;
+static GHashTable *g_pending = NULL;   // key -> IconJob* (main thread)
+static GHashTable *g_failed = NULL;    // keys with no loadable texture
+static IconReadyFunc g_ready = NULL;
+static void *g_ready_data = NULL;
+static uint64_t g_next_seq = 0;
+static int g_shutdown = 0;
+
+// icon_job_new - allocate a job for a request
+// returns: new job
+static IconJob *
+icon_job_new(const char *key, const char *base_name, uint32_t var1,
+             unsigned level, IconPriority priority)
+{
+  IconJob *job = g_new0(IconJob, 1);
+
+  job->key = g_strdup(key);
+  job->base_name = g_strdup(base_name);
+  job->var1 = var1;
+  job->level = level;
+  job->priority = priority;
+  job->seq = g_next_seq++;
+  job->waiters = g_ptr_array_new_with_free_func(g_object_unref);
+  return(job);
+}
+
+// icon_job_free - release a job and the surface it carries
+// job: job to free
+static void
+icon_job_free(IconJob *job)
+{
+  if(job->surface)
+    cairo_surface_destroy(job->surface);
+
+  g_ptr_array_unref(job->waiters);
+  g_free(job->base_name);
+  g_free(job->key);
+  g_free(job);
+}
+
+// compare_jobs - thread pool order: visible before prefetch, then FIFO
+static gint
+compare_jobs(gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const IconJob *ja = a;
+  const IconJob *jb = b;
+
+  (void)user_data;
+
+  if(ja->priority != jb->priority)
+    return(ja->priority < jb->priority ? -1 : 1);
+
+  return(ja->seq < jb->seq ? -1 : ja->seq > jb->seq);
+}
+
+// add_waiter - remember a widget to redraw when a job completes
+// job: pending job
+// waiter: widget, or NULL
+static void
+add_waiter(IconJob *job, GtkWidget *waiter)
+{
+  if(!waiter)
+    return;
+
+  for(guint i = 0; i < job->waiters->len; i++)
+    if(g_ptr_array_index(job->waiters, i) == waiter)
+      return;
+
+  g_ptr_array_add(job->waiters, g_object_ref(waiter));
+}
+
+// icon_deliver - main loop side of a finished job
+// data: the job
+// returns: G_SOURCE_REMOVE
+static gboolean
+icon_deliver(gpointer data)
+{
+  IconJob *job = data;
+
+  // a job replaced by a higher-priority copy may still finish first; either
+  // way only the job the pending table points at is delivered
+  if(g_pending && g_hash_table_lookup(g_pending, job->key) == job)
+  {
+    g_hash_table_remove(g_pending, job->key);
+
+    if(!job->surface)
+      g_hash_table_add(g_failed, g_strdup(job->key));
+
+    if(g_ready)
+      g_ready(job->key, job->surface, job->waiters, g_ready_data);
+  }
+
+  icon_job_free(job);
+  return(G_SOURCE_REMOVE);
+}
+
+// icon_worker - thread pool function: resolve and decode one icon
+// data: the job
+// user_data: unused
+static void
+icon_worker(gpointer data, gpointer user_data)
+{
+  IconJob *job = data;
+  char tex_path[1024];
+
+  (void)user_data;
+
+  // superseded jobs are no longer in the pending table; nobody else frees them
+  if(g_atomic_int_get(&g_shutdown) || g_atomic_int_get(&job->superseded))
+  {
+    icon_job_free(job);
+    return;
+  }
+
+  icon_texture_path(job->base_name, job->var1, tex_path, sizeof(tex_path));
+  job->surface = texture_load_surface(tex_path, job->level);
+  g_idle_add(icon_deliver, job);
+}
+
+// icon_texture_path - resolve the .tex path of an item's icon from its DBR
+// base_name: DBR record path of the item
+// var1: shard count
+// tex_path: receives the texture path
+// size: size of tex_path in bytes
+void
+icon_texture_path(const char *base_name, uint32_t var1, char *tex_path, size_t size)
+{
+  char *bitmap_path = NULL;
+  int token = asset_dbr_acquire();
+  TQArzRecordData *data = asset_get_dbr(base_name);
+
+  if(data)
+  {
+    bitmap_path = arz_record_get_string(data, "bitmap", NULL);
+    if(!bitmap_path)
+      bitmap_path = arz_record_get_string(data, "artifactBitmap", NULL);
+
+    if(!bitmap_path)
+    {
+      // For relics/charms: use shardBitmap when incomplete, relicBitmap when complete.
+      // completedRelicLevel from the DBR tells us how many shards are needed.
+      char *relic_bmp = arz_record_get_string(data, "relicBitmap", NULL);
+      char *shard_bmp = arz_record_get_string(data, "shardBitmap", NULL);
+
+      if(relic_bmp && shard_bmp)
+      {
+        int max_shards = arz_record_get_int(data, "completedRelicLevel", 0, NULL);
+
+        if(max_shards > 0 && var1 < (uint32_t)max_shards)
+        {
+          bitmap_path = shard_bmp;
+          free(relic_bmp);
+        }
+        else
+        {
+          bitmap_path = relic_bmp;
+          free(shard_bmp);
+        }
+      }
+      else if(relic_bmp)
+        bitmap_path = relic_bmp;
+      else if(shard_bmp)
+        bitmap_path = shard_bmp;
+    }
+  }
+
+  asset_dbr_release(token);
+
+  const char *source = bitmap_path ? bitmap_path : base_name;
+
+  // leave room for the ".tex" extension
+  g_strlcpy(tex_path, source, size > 4 ? size - 4 : size);
+  if(bitmap_path)
+    free(bitmap_path);
+
+  char *dot = strrchr(tex_path, '.');
+
+  if(dot)
+    *dot = '\0';
+
+  g_strlcat(tex_path, ".tex", size);
+}
+
+// icon_loader_init - start the icon decode worker pool
+// ready: completion callback
+// user_data: passed through to ready
+void
+icon_loader_init(IconReadyFunc ready, void *user_data)
+{
+  if(g_pool)
+    return;
+
+  // leave a core for the UI thread
+  int threads = (int)g_get_num_processors() - 1;
+
+  if(threads < 1)
+    threads = 1;
+  if(threads > 4)
+    threads = 4;
+
+  g_ready = ready;
+  g_ready_data = user_data;
+  g_atomic_int_set(&g_shutdown, 0);
+  g_pending = g_hash_table_new(g_str_hash, g_str_equal);
+  g_failed = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  g_pool = g_thread_pool_new(icon_worker, NULL, threads, FALSE, NULL);
+  g_thread_pool_set_sort_function(g_pool, compare_jobs, NULL);
+
+  if(tqvc_debug)
+    printf("Icon loader: %d worker threads\n", threads);
+}
+
+// icon_loader_request - queue an item icon for decoding on a worker thread
+// key: cache key identifying base_name, var1 and level (copied)
+// base_name: DBR record path of the item (copied)
+// var1: shard count
+// level: mip level to decode
+// priority: queue priority
+// waiter: widget to redraw when the icon is ready, or NULL
+// returns: true if the icon will be delivered, false otherwise
+bool
+icon_loader_request(const char *key, const char *base_name, uint32_t var1,
+                    unsigned level, IconPriority priority, GtkWidget *waiter)
+{
+  if(!g_pool || !key || !base_name)
+    return(false);
+
+  if(g_hash_table_contains(g_failed, key))
+    return(false);
+
+  IconJob *job = g_hash_table_lookup(g_pending, key);
+
+  if(job)
+  {
+    add_waiter(job, waiter);
+
+    if(priority >= job->priority)
+      return(true);
+
+    // queued jobs cannot be re-sorted, so queue a copy at the new priority
+    // and let the worker drop the old one
+    IconJob *promoted = icon_job_new(key, base_name, var1, level, priority);
+
+    g_ptr_array_extend_and_steal(promoted->waiters, job->waiters);
+    job->waiters = g_ptr_array_new_with_free_func(g_object_unref);
+    g_hash_table_replace(g_pending, promoted->key, promoted);
+    g_atomic_int_set(&job->superseded, 1);
+    g_thread_pool_push(g_pool, promoted, NULL);
+    return(true);
+  }
+
+  job = icon_job_new(key, base_name, var1, level, priority);
+  add_waiter(job, waiter);
+  g_hash_table_insert(g_pending, job->key, job);
+  g_thread_pool_push(g_pool, job, NULL);
+  return(true);
+}
+
+// icon_loader_free - stop the worker pool and drop pending requests
+void
+icon_loader_free(void)
+{
+  if(!g_pool)
+    return;
+
+  // drop widget references here, on the main thread, before queued jobs
+  // free themselves on the workers
+  GHashTableIter iter;
+  gpointer value;
+
+  g_hash_table_iter_init(&iter, g_pending);
+  while(g_hash_table_iter_next(&iter, NULL, &value))
+    g_ptr_array_set_size(((IconJob *)value)->waiters, 0);
+
+  // queued jobs see the flag and free themselves; finished ones already
+  // posted to the main loop find no pending table and are freed when
+  // their sources are dispatched below
+  g_atomic_int_set(&g_shutdown, 1);
+  g_thread_pool_free(g_pool, FALSE, TRUE);
+  g_pool = NULL;
+
+  g_hash_table_destroy(g_pending);
+  g_pending = NULL;
+  g_hash_table_destroy(g_failed);
+  g_failed = NULL;
+  g_ready = NULL;
+
+  // the application's main loop has usually stopped by now
+  while(g_main_context_iteration(NULL, FALSE));
+}
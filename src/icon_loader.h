@@ -0,0 +1,54 @@
+#ifndef ICON_LOADER_H
+#define ICON_LOADER_H
+
+#include <gtk/gtk.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// IconPriority - order in which queued icon decodes run
+typedef enum {
+  ICON_PRIORITY_VISIBLE,   // drawn as a placeholder right now
+  ICON_PRIORITY_PREFETCH   // likely to be shown soon
+} IconPriority;
+
+// IconReadyFunc - completion callback, run on the main thread
+// key: cache key passed to icon_loader_request()
+// surface: decoded texture (borrowed; take a reference to keep it), or NULL
+//          if the item has no loadable texture
+// waiters: widgets that asked for the icon while it was pending (borrowed)
+// user_data: value passed to icon_loader_init()
+typedef void (*IconReadyFunc)(const char *key, cairo_surface_t *surface,
+                              GPtrArray *waiters, void *user_data);
+
+// icon_loader_init - start the icon decode worker pool
+// ready: completion callback
+// user_data: passed through to ready
+void icon_loader_init(IconReadyFunc ready, void *user_data);
+
+// icon_loader_request - queue an item icon for decoding on a worker thread.
+// Requests for a key that is already pending are merged; a visible request
+// moves a pending prefetch ahead of the remaining prefetches.
+// key: cache key identifying base_name, var1 and level (copied)
+// base_name: DBR record path of the item (copied)
+// var1: shard count (picks shard vs complete relic texture)
+// level: mip level to decode
+// priority: queue priority
+// waiter: widget to redraw when the icon is ready, or NULL
+// returns: true if the icon will be delivered, false if it failed to load
+//          before or the loader is not running
+bool icon_loader_request(const char *key, const char *base_name, uint32_t var1,
+                         unsigned level, IconPriority priority, GtkWidget *waiter);
+
+// icon_texture_path - resolve the .tex path of an item's icon from its DBR
+// (bitmap, artifactBitmap, or relic/shard bitmap by shard count).
+// Safe to call from any thread.
+// base_name: DBR record path of the item
+// var1: shard count
+// tex_path: receives the texture path
+// size: size of tex_path in bytes
+void icon_texture_path(const char *base_name, uint32_t var1, char *tex_path, size_t size);
+
+// icon_loader_free - stop the worker pool and drop pending requests
+void icon_loader_free(void);
+
+#endif
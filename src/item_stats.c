@@ -221,162 +221,7 @@ static AttributeMap attr_maps[] = {
 static GHashTable *g_skip_set = NULL;    // interned ptr -> (gpointer)1
 static GHashTable *g_attr_map_ht = NULL; // interned ptr -> &attr_maps[i]
 
-// Pre-interned variable name pointers for frequently used names
-static const char *INT_offensivePhysicalMin, *INT_offensivePhysicalMax, *INT_offensivePhysicalChance;
-static const char *INT_offensiveFireMin, *INT_offensiveFireMax, *INT_offensiveFireChance;
-static const char *INT_offensiveColdMin, *INT_offensiveColdMax, *INT_offensiveColdChance;
-static const char *INT_offensiveLightningMin, *INT_offensiveLightningMax, *INT_offensiveLightningChance;
-static const char *INT_offensivePoisonMin, *INT_offensivePoisonMax, *INT_offensivePoisonChance;
-static const char *INT_offensivePierceMin, *INT_offensivePierceMax, *INT_offensivePierceChance;
-static const char *INT_offensiveElementalMin, *INT_offensiveElementalMax, *INT_offensiveElementalChance;
-static const char *INT_offensiveConvertChance;
-static const char *INT_offensiveManaLeechMin, *INT_offensiveManaLeechMax;
-static const char *INT_offensiveBasePhysicalMin, *INT_offensiveBasePhysicalMax;
-static const char *INT_offensiveBaseColdMin, *INT_offensiveBaseColdMax;
-static const char *INT_offensiveBaseFireMin, *INT_offensiveBaseFireMax;
-static const char *INT_offensiveBaseLightningMin, *INT_offensiveBaseLightningMax;
-static const char *INT_offensiveBasePoisonMin, *INT_offensiveBasePoisonMax;
-static const char *INT_offensiveBaseLifeMin, *INT_offensiveBaseLifeMax;
-static const char *INT_offensiveLifeMin, *INT_offensiveLifeMax, *INT_offensiveLifeChance;
-static const char *INT_offensiveBonusPhysicalMin, *INT_offensiveBonusPhysicalMax, *INT_offensiveBonusPhysicalChance;
-static const char *INT_offensiveLifeLeechMin, *INT_offensiveLifeLeechMax;
-static const char *INT_offensiveSlowFireMin, *INT_offensiveSlowFireMax, *INT_offensiveSlowFireDurationMin, *INT_offensiveSlowFireChance;
-static const char *INT_offensiveSlowLightningMin, *INT_offensiveSlowLightningMax, *INT_offensiveSlowLightningDurationMin, *INT_offensiveSlowLightningChance;
-static const char *INT_offensiveSlowColdMin, *INT_offensiveSlowColdMax, *INT_offensiveSlowColdDurationMin, *INT_offensiveSlowColdChance;
-static const char *INT_offensiveSlowPoisonMin, *INT_offensiveSlowPoisonMax, *INT_offensiveSlowPoisonDurationMin, *INT_offensiveSlowPoisonChance;
-static const char *INT_offensiveSlowLifeLeachMin, *INT_offensiveSlowLifeLeachMax, *INT_offensiveSlowLifeLeachDurationMin, *INT_offensiveSlowLifeLeachChance;
-static const char *INT_offensiveSlowLifeMin, *INT_offensiveSlowLifeMax, *INT_offensiveSlowLifeDurationMin, *INT_offensiveSlowLifeChance;
-static const char *INT_offensiveSlowManaLeachMin, *INT_offensiveSlowManaLeachMax, *INT_offensiveSlowManaLeachDurationMin, *INT_offensiveSlowManaLeachChance;
-static const char *INT_offensiveSlowBleedingMin, *INT_offensiveSlowBleedingMax, *INT_offensiveSlowBleedingDurationMin, *INT_offensiveSlowBleedingChance;
-static const char *INT_offensiveSlowBleedingModifier, *INT_offensiveSlowBleedingModifierChance;
-static const char *INT_offensiveSlowFireModifier, *INT_offensiveSlowFireModifierChance;
-static const char *INT_offensiveSlowColdModifier, *INT_offensiveSlowColdModifierChance;
-static const char *INT_offensiveSlowLightningModifier, *INT_offensiveSlowLightningModifierChance;
-static const char *INT_offensiveSlowPoisonModifier, *INT_offensiveSlowPoisonModifierChance;
-static const char *INT_offensiveSlowLifeModifier, *INT_offensiveSlowLifeModifierChance;
-static const char *INT_offensiveSlowLifeLeachModifier, *INT_offensiveSlowLifeLeachModifierChance;
-static const char *INT_offensiveSlowDefensiveReductionMin, *INT_offensiveSlowDefensiveReductionDurationMin;
-static const char *INT_offensiveSlowAttackSpeedMin, *INT_offensiveSlowAttackSpeedDurationMin;
-static const char *INT_offensiveSlowRunSpeedMin, *INT_offensiveSlowRunSpeedDurationMin;
-static const char *INT_offensiveStunMin, *INT_offensiveStunDurationMin, *INT_offensiveStunChance;
-static const char *INT_offensiveFumbleMin, *INT_offensiveFumbleDurationMin, *INT_offensiveFumbleChance;
-static const char *INT_offensiveProjectileFumbleMin, *INT_offensiveProjectileFumbleDurationMin, *INT_offensiveProjectileFumbleChance;
-static const char *INT_offensiveFreezeMin, *INT_offensiveFreezeDurationMin, *INT_offensiveFreezeChance;
-static const char *INT_offensivePetrifyMin, *INT_offensivePetrifyDurationMin, *INT_offensivePetrifyChance;
-static const char *INT_offensiveConfusionMin, *INT_offensiveConfusionDurationMin, *INT_offensiveConfusionChance;
-static const char *INT_offensiveFearMin, *INT_offensiveFearMax, *INT_offensiveFearChance;
-static const char *INT_offensiveConvertMin;
-static const char *INT_retaliationPhysicalMin, *INT_retaliationPhysicalChance;
-static const char *INT_retaliationFireMin, *INT_retaliationFireChance;
-static const char *INT_retaliationColdMin, *INT_retaliationColdChance;
-static const char *INT_retaliationLightningMin, *INT_retaliationLightningChance;
-static const char *INT_retaliationPierceMin, *INT_retaliationPierceChance;
-static const char *INT_retaliationSlowFireMin, *INT_retaliationSlowFireMax, *INT_retaliationSlowFireDurationMin, *INT_retaliationSlowFireChance;
-static const char *INT_retaliationSlowColdMin, *INT_retaliationSlowColdMax, *INT_retaliationSlowColdDurationMin, *INT_retaliationSlowColdChance;
-static const char *INT_retaliationSlowLightningMin, *INT_retaliationSlowLightningMax, *INT_retaliationSlowLightningDurationMin, *INT_retaliationSlowLightningChance;
-static const char *INT_retaliationSlowPoisonMin, *INT_retaliationSlowPoisonMax, *INT_retaliationSlowPoisonDurationMin, *INT_retaliationSlowPoisonChance;
-static const char *INT_retaliationSlowLifeMin, *INT_retaliationSlowLifeMax, *INT_retaliationSlowLifeDurationMin, *INT_retaliationSlowLifeChance;
-static const char *INT_retaliationSlowBleedingMin, *INT_retaliationSlowBleedingMax, *INT_retaliationSlowBleedingDurationMin, *INT_retaliationSlowBleedingChance;
-static const char *INT_retaliationSlowLifeLeachMin, *INT_retaliationSlowLifeLeachMax, *INT_retaliationSlowLifeLeachDurationMin, *INT_retaliationSlowLifeLeachChance;
-static const char *INT_retaliationSlowManaLeachMax;
-static const char *INT_retaliationSlowRunSpeedMin, *INT_retaliationSlowRunSpeedMax, *INT_retaliationSlowRunSpeedDurationMin, *INT_retaliationSlowRunSpeedChance;
-static const char *INT_retaliationSlowDefensiveAbilityMin, *INT_retaliationSlowDefensiveAbilityMax, *INT_retaliationSlowDefensiveAbilityDurationMin, *INT_retaliationSlowDefensiveAbilityChance;
-static const char *INT_retaliationSlowOffensiveAbilityMin, *INT_retaliationSlowOffensiveAbilityMax, *INT_retaliationSlowOffensiveAbilityDurationMin, *INT_retaliationSlowOffensiveAbilityChance;
-static const char *INT_retaliationSlowOffensiveReductionMin, *INT_retaliationSlowOffensiveReductionMax, *INT_retaliationSlowOffensiveReductionDurationMin, *INT_retaliationSlowOffensiveReductionChance;
-static const char *INT_offensivePhysicalModifier, *INT_offensivePhysicalModifierChance;
-static const char *INT_offensiveFireModifier, *INT_offensiveFireModifierChance;
-static const char *INT_offensiveColdModifier, *INT_offensiveColdModifierChance;
-static const char *INT_offensiveLightningModifier, *INT_offensiveLightningModifierChance;
-static const char *INT_offensivePoisonModifier, *INT_offensivePoisonModifierChance;
-static const char *INT_offensiveLifeModifier, *INT_offensiveLifeModifierChance;
-static const char *INT_offensivePierceModifier, *INT_offensivePierceModifierChance;
-static const char *INT_offensiveElementalModifier, *INT_offensiveElementalModifierChance;
-static const char *INT_offensiveTotalDamageModifier, *INT_offensiveTotalDamageModifierChance;
-static const char *INT_defensivePhysical, *INT_defensivePhysicalChance;
-static const char *INT_defensiveFire, *INT_defensiveFireChance;
-static const char *INT_defensiveCold, *INT_defensiveColdChance;
-static const char *INT_defensiveLightning, *INT_defensiveLightningChance;
-static const char *INT_defensivePoison, *INT_defensivePoisonChance;
-static const char *INT_defensivePierce, *INT_defensivePierceChance;
-static const char *INT_defensiveLife, *INT_defensiveLifeChance;
-static const char *INT_defensiveBleeding, *INT_defensiveBleedingChance;
-static const char *INT_defensiveElementalResistance, *INT_defensiveElementalResistanceChance;
-static const char *INT_offensivePercentCurrentLifeMin, *INT_offensivePercentCurrentLifeChance;
-static const char *INT_offensiveTotalDamageReductionPercentMin, *INT_offensiveTotalDamageReductionPercentChance;
-static const char *INT_offensiveTotalDamageReductionPercentDurationMin;
-static const char *INT_offensiveManaBurnDrainMin, *INT_offensiveManaBurnDrainMax, *INT_offensiveManaBurnDrainRatioMin, *INT_offensiveManaBurnDamageRatio;
-static const char *INT_offensiveManaBurnChance, *INT_offensiveManaBurnRatioAdder, *INT_offensiveManaBurnRatioAdderChance;
-static const char *INT_retaliationPhysicalModifier, *INT_retaliationPhysicalModifierChance;
-static const char *INT_retaliationColdModifier, *INT_retaliationColdModifierChance;
-static const char *INT_retaliationFireModifier, *INT_retaliationFireModifierChance;
-static const char *INT_retaliationLightningModifier, *INT_retaliationLightningModifierChance;
-static const char *INT_retaliationPoisonModifier, *INT_retaliationPoisonModifierChance;
-static const char *INT_retaliationPierceModifier, *INT_retaliationPierceModifierChance;
-static const char *INT_retaliationLifeModifier, *INT_retaliationLifeModifierChance;
-static const char *INT_retaliationStunModifier, *INT_retaliationStunModifierChance;
-static const char *INT_retaliationElementalModifier, *INT_retaliationElementalModifierChance;
-static const char *INT_racialBonusPercentDamage, *INT_racialBonusPercentDefense, *INT_racialBonusRace;
-static const char *INT_petBonusName;
-static const char *INT_skillCooldownTime, *INT_refreshTime;
-static const char *INT_skillCooldownReduction, *INT_skillCooldownReductionChance;
-static const char *INT_skillManaCostReduction, *INT_skillManaCostReductionChance;
-static const char *INT_skillTargetNumber, *INT_skillActiveDuration, *INT_skillTargetRadius;
-static const char *INT_offensiveGlobalChance;
-static const char *INT_offensiveDisruptionMin;
-static const char *INT_offensiveSlowLightningDurationMax, *INT_offensiveSlowFireDurationMax;
-static const char *INT_offensiveSlowColdDurationMax, *INT_offensiveSlowPoisonDurationMax;
-static const char *INT_defensiveDisruption, *INT_defensiveDisruptionDuration;
-static const char *INT_offensiveTotalResistanceReductionAbsoluteMin, *INT_offensiveTotalResistanceReductionAbsoluteDurationMin;
-static const char *INT_offensiveTotalResistanceReductionAbsoluteChance, *INT_offensiveTotalResistanceReductionAbsoluteMax;
-static const char *INT_offensiveTotalResistanceReductionPercentMin, *INT_offensiveTotalResistanceReductionPercentDurationMin;
-static const char *INT_offensiveTotalResistanceReductionPercentChance;
-static const char *INT_offensiveSlowOffensiveAbilityModifier, *INT_offensiveSlowOffensiveAbilityDurationMin;
-static const char *INT_offensiveSlowPhysicalMin, *INT_offensiveSlowPhysicalMax, *INT_offensiveSlowPhysicalDurationMin, *INT_offensiveSlowPhysicalChance;
-static const char *INT_offensiveSlowDefensiveAbilityMin, *INT_offensiveSlowDefensiveAbilityMax, *INT_offensiveSlowDefensiveAbilityDurationMin, *INT_offensiveSlowDefensiveAbilityChance;
-static const char *INT_offensiveSlowOffensiveAbilityMin, *INT_offensiveSlowOffensiveAbilityMax, *INT_offensiveSlowOffensiveAbilityChance;
-static const char *INT_offensiveSlowOffensiveReductionModifier, *INT_offensiveSlowOffensiveReductionDurationMin;
-static const char *INT_offensiveSlowTotalSpeedMin, *INT_offensiveSlowTotalSpeedChance, *INT_offensiveSlowTotalSpeedDurationMin;
-static const char *INT_offensivePercentCurrentLifeMax, *INT_offensiveConfusionMax;
-static const char *INT_racialBonusAbsoluteDamage, *INT_racialBonusAbsoluteDefense;
-static const char *INT_retaliationSlowAttackSpeedMin, *INT_retaliationSlowAttackSpeedDurationMin;
-static const char *INT_retaliationSlowManaLeachMin, *INT_retaliationSlowManaLeachDurationMin, *INT_retaliationSlowManaLeachChance;
-static const char *INT_retaliationPierceMax;
-static const char *INT_retaliationFireMax, *INT_retaliationColdMax, *INT_retaliationLightningMax, *INT_retaliationPhysicalMax;
-static const char *INT_retaliationLifeMin, *INT_retaliationLifeMax, *INT_retaliationLifeChance;
-static const char *INT_retaliationPoisonMin, *INT_retaliationPoisonMax, *INT_retaliationPoisonChance;
-static const char *INT_retaliationStunMin, *INT_retaliationStunMax, *INT_retaliationStunChance;
-static const char *INT_retaliationElementalMin, *INT_retaliationElementalMax, *INT_retaliationElementalChance;
-static const char *INT_retaliationPercentCurrentLifeMin, *INT_retaliationPercentCurrentLifeMax, *INT_retaliationPercentCurrentLifeChance;
-static const char *INT_retaliationGlobalChance;
-static const char *INT_defensiveBlock, *INT_defensiveBlockChance, *INT_defensiveAbsorption, *INT_defensivePetrify;
-static const char *INT_offensivePierceRatioMin, *INT_offensivePierceRatioMax, *INT_offensivePierceRatioChance;
-static const char *INT_offensivePierceRatioModifier, *INT_offensivePierceRatioModifierChance;
-static const char *INT_offensiveSlowRunSpeedMax;
-static const char *INT_offensiveStunMax, *INT_offensiveStunModifier;
-static const char *INT_offensiveFreezeMax;
-static const char *INT_offensiveSleepMin, *INT_offensiveSleepMax, *INT_offensiveSleepChance;
-static const char *INT_offensiveSleepDurationMin, *INT_offensiveSleepModifier;
-static const char *INT_offensiveDisruptionMax, *INT_offensiveDisruptionChance;
-static const char *INT_offensiveBaseFireChance, *INT_offensiveBaseColdChance, *INT_offensiveBaseLightningChance;
-static const char *INT_offensiveSlowLifeLeachDurationMax, *INT_offensiveSlowManaLeachDurationMax;
-static const char *INT_offensiveSlowBleedingDurationMax;
-static const char *INT_defensiveSlowLifeLeach, *INT_defensiveSlowLifeLeachChance;
-static const char *INT_defensiveSlowManaLeach, *INT_defensiveSlowManaLeachChance;
-static const char *INT_defensivePoisonDuration, *INT_defensivePoisonDurationChance;
-static const char *INT_defensiveReflect, *INT_defensiveReflectChance;
-const char *INT_itemNameTag, *INT_description, *INT_lootRandomizerName, *INT_FileDescription;
-const char *INT_itemClassification, *INT_itemText;
-const char *INT_characterBaseAttackSpeedTag, *INT_artifactClassification;
-const char *INT_itemSkillName, *INT_buffSkillName, *INT_skillDisplayName;
-const char *INT_itemSkillAutoController, *INT_triggerType, *INT_itemSkillLevel;
-const char *INT_skillBaseDescription, *INT_petSkillName, *INT_skillChanceWeight;
-const char *INT_itemSetName, *INT_setName, *INT_setMembers;
-const char *INT_completedRelicLevel;
-const char *INT_dexterityRequirement, *INT_intelligenceRequirement;
-const char *INT_strengthRequirement, *INT_levelRequirement;
-const char *INT_itemLevel, *INT_itemCostName, *INT_Class;
-
-#define INTERN(name) INT_##name = arz_intern(#name)
+// Frequently used variable names are the INT_* builtin symbols (arz_syms.h)
 
 // Initialize the item stats subsystem: pre-intern attribute names,
 // build skip set and attr_map hash tables.
@@ -532,160 +377,6 @@ item_stats_init(void)
   for(int i = 0; attr_maps[i].variable; i++)
     g_hash_table_insert(g_attr_map_ht, (gpointer)attr_maps[i].interned, &attr_maps[i]);
 
-  // Pre-intern all frequently used variable names
-  INTERN(offensivePhysicalMin); INTERN(offensivePhysicalMax); INTERN(offensivePhysicalChance);
-  INTERN(offensiveFireMin); INTERN(offensiveFireMax); INTERN(offensiveFireChance);
-  INTERN(offensiveColdMin); INTERN(offensiveColdMax); INTERN(offensiveColdChance);
-  INTERN(offensiveLightningMin); INTERN(offensiveLightningMax); INTERN(offensiveLightningChance);
-  INTERN(offensivePoisonMin); INTERN(offensivePoisonMax); INTERN(offensivePoisonChance);
-  INTERN(offensivePierceMin); INTERN(offensivePierceMax); INTERN(offensivePierceChance);
-  INTERN(offensiveElementalMin); INTERN(offensiveElementalMax); INTERN(offensiveElementalChance);
-  INTERN(offensiveConvertChance);
-  INTERN(offensiveManaLeechMin); INTERN(offensiveManaLeechMax);
-  INTERN(offensiveBasePhysicalMin); INTERN(offensiveBasePhysicalMax);
-  INTERN(offensiveBaseColdMin); INTERN(offensiveBaseColdMax);
-  INTERN(offensiveBaseFireMin); INTERN(offensiveBaseFireMax);
-  INTERN(offensiveBaseLightningMin); INTERN(offensiveBaseLightningMax);
-  INTERN(offensiveBasePoisonMin); INTERN(offensiveBasePoisonMax);
-  INTERN(offensiveBaseLifeMin); INTERN(offensiveBaseLifeMax);
-  INTERN(offensiveLifeMin); INTERN(offensiveLifeMax); INTERN(offensiveLifeChance);
-  INTERN(offensiveBonusPhysicalMin); INTERN(offensiveBonusPhysicalMax); INTERN(offensiveBonusPhysicalChance);
-  INTERN(offensiveLifeLeechMin); INTERN(offensiveLifeLeechMax);
-  INTERN(offensiveSlowFireMin); INTERN(offensiveSlowFireMax); INTERN(offensiveSlowFireDurationMin); INTERN(offensiveSlowFireChance);
-  INTERN(offensiveSlowLightningMin); INTERN(offensiveSlowLightningMax); INTERN(offensiveSlowLightningDurationMin); INTERN(offensiveSlowLightningChance);
-  INTERN(offensiveSlowColdMin); INTERN(offensiveSlowColdMax); INTERN(offensiveSlowColdDurationMin); INTERN(offensiveSlowColdChance);
-  INTERN(offensiveSlowPoisonMin); INTERN(offensiveSlowPoisonMax); INTERN(offensiveSlowPoisonDurationMin); INTERN(offensiveSlowPoisonChance);
-  INTERN(offensiveSlowLifeLeachMin); INTERN(offensiveSlowLifeLeachMax); INTERN(offensiveSlowLifeLeachDurationMin); INTERN(offensiveSlowLifeLeachChance);
-  INTERN(offensiveSlowLifeMin); INTERN(offensiveSlowLifeMax); INTERN(offensiveSlowLifeDurationMin); INTERN(offensiveSlowLifeChance);
-  INTERN(offensiveSlowManaLeachMin); INTERN(offensiveSlowManaLeachMax); INTERN(offensiveSlowManaLeachDurationMin); INTERN(offensiveSlowManaLeachChance);
-  INTERN(offensiveSlowBleedingMin); INTERN(offensiveSlowBleedingMax); INTERN(offensiveSlowBleedingDurationMin); INTERN(offensiveSlowBleedingChance);
-  INTERN(offensiveSlowBleedingModifier); INTERN(offensiveSlowBleedingModifierChance);
-  INTERN(offensiveSlowFireModifier); INTERN(offensiveSlowFireModifierChance);
-  INTERN(offensiveSlowColdModifier); INTERN(offensiveSlowColdModifierChance);
-  INTERN(offensiveSlowLightningModifier); INTERN(offensiveSlowLightningModifierChance);
-  INTERN(offensiveSlowPoisonModifier); INTERN(offensiveSlowPoisonModifierChance);
-  INTERN(offensiveSlowLifeModifier); INTERN(offensiveSlowLifeModifierChance);
-  INTERN(offensiveSlowLifeLeachModifier); INTERN(offensiveSlowLifeLeachModifierChance);
-  INTERN(offensiveSlowDefensiveReductionMin); INTERN(offensiveSlowDefensiveReductionDurationMin);
-  INTERN(offensiveSlowAttackSpeedMin); INTERN(offensiveSlowAttackSpeedDurationMin);
-  INTERN(offensiveSlowRunSpeedMin); INTERN(offensiveSlowRunSpeedDurationMin);
-  INTERN(offensiveStunMin); INTERN(offensiveStunDurationMin); INTERN(offensiveStunChance);
-  INTERN(offensiveFumbleMin); INTERN(offensiveFumbleDurationMin); INTERN(offensiveFumbleChance);
-  INTERN(offensiveProjectileFumbleMin); INTERN(offensiveProjectileFumbleDurationMin); INTERN(offensiveProjectileFumbleChance);
-  INTERN(offensiveFreezeMin); INTERN(offensiveFreezeDurationMin); INTERN(offensiveFreezeChance);
-  INTERN(offensivePetrifyMin); INTERN(offensivePetrifyDurationMin); INTERN(offensivePetrifyChance);
-  INTERN(offensiveConfusionMin); INTERN(offensiveConfusionDurationMin); INTERN(offensiveConfusionChance);
-  INTERN(offensiveFearMin); INTERN(offensiveFearMax); INTERN(offensiveFearChance);
-  INTERN(offensiveConvertMin);
-  INTERN(retaliationPhysicalMin); INTERN(retaliationPhysicalChance);
-  INTERN(retaliationFireMin); INTERN(retaliationFireChance);
-  INTERN(retaliationColdMin); INTERN(retaliationColdChance);
-  INTERN(retaliationLightningMin); INTERN(retaliationLightningChance);
-  INTERN(retaliationPierceMin); INTERN(retaliationPierceChance);
-  INTERN(retaliationSlowFireMin); INTERN(retaliationSlowFireMax); INTERN(retaliationSlowFireDurationMin); INTERN(retaliationSlowFireChance);
-  INTERN(retaliationSlowColdMin); INTERN(retaliationSlowColdMax); INTERN(retaliationSlowColdDurationMin); INTERN(retaliationSlowColdChance);
-  INTERN(retaliationSlowLightningMin); INTERN(retaliationSlowLightningMax); INTERN(retaliationSlowLightningDurationMin); INTERN(retaliationSlowLightningChance);
-  INTERN(retaliationSlowPoisonMin); INTERN(retaliationSlowPoisonMax); INTERN(retaliationSlowPoisonDurationMin); INTERN(retaliationSlowPoisonChance);
-  INTERN(retaliationSlowLifeMin); INTERN(retaliationSlowLifeMax); INTERN(retaliationSlowLifeDurationMin); INTERN(retaliationSlowLifeChance);
-  INTERN(retaliationSlowBleedingMin); INTERN(retaliationSlowBleedingMax); INTERN(retaliationSlowBleedingDurationMin); INTERN(retaliationSlowBleedingChance);
-  INTERN(retaliationSlowLifeLeachMin); INTERN(retaliationSlowLifeLeachMax); INTERN(retaliationSlowLifeLeachDurationMin); INTERN(retaliationSlowLifeLeachChance);
-  INTERN(retaliationSlowManaLeachMax);
-  INTERN(retaliationSlowRunSpeedMin); INTERN(retaliationSlowRunSpeedMax); INTERN(retaliationSlowRunSpeedDurationMin); INTERN(retaliationSlowRunSpeedChance);
-  INTERN(retaliationSlowDefensiveAbilityMin); INTERN(retaliationSlowDefensiveAbilityMax); INTERN(retaliationSlowDefensiveAbilityDurationMin); INTERN(retaliationSlowDefensiveAbilityChance);
-  INTERN(retaliationSlowOffensiveAbilityMin); INTERN(retaliationSlowOffensiveAbilityMax); INTERN(retaliationSlowOffensiveAbilityDurationMin); INTERN(retaliationSlowOffensiveAbilityChance);
-  INTERN(retaliationSlowOffensiveReductionMin); INTERN(retaliationSlowOffensiveReductionMax); INTERN(retaliationSlowOffensiveReductionDurationMin); INTERN(retaliationSlowOffensiveReductionChance);
-  INTERN(offensivePhysicalModifier); INTERN(offensivePhysicalModifierChance);
-  INTERN(offensiveFireModifier); INTERN(offensiveFireModifierChance);
-  INTERN(offensiveColdModifier); INTERN(offensiveColdModifierChance);
-  INTERN(offensiveLightningModifier); INTERN(offensiveLightningModifierChance);
-  INTERN(offensivePoisonModifier); INTERN(offensivePoisonModifierChance);
-  INTERN(offensiveLifeModifier); INTERN(offensiveLifeModifierChance);
-  INTERN(offensivePierceModifier); INTERN(offensivePierceModifierChance);
-  INTERN(offensiveElementalModifier); INTERN(offensiveElementalModifierChance);
-  INTERN(offensiveTotalDamageModifier); INTERN(offensiveTotalDamageModifierChance);
-  INTERN(defensivePhysical); INTERN(defensivePhysicalChance);
-  INTERN(defensiveFire); INTERN(defensiveFireChance);
-  INTERN(defensiveCold); INTERN(defensiveColdChance);
-  INTERN(defensiveLightning); INTERN(defensiveLightningChance);
-  INTERN(defensivePoison); INTERN(defensivePoisonChance);
-  INTERN(defensivePierce); INTERN(defensivePierceChance);
-  INTERN(defensiveLife); INTERN(defensiveLifeChance);
-  INTERN(defensiveBleeding); INTERN(defensiveBleedingChance);
-  INTERN(defensiveElementalResistance); INTERN(defensiveElementalResistanceChance);
-  INTERN(offensivePercentCurrentLifeMin); INTERN(offensivePercentCurrentLifeChance);
-  INTERN(offensiveManaBurnDrainMin); INTERN(offensiveManaBurnDrainMax); INTERN(offensiveManaBurnDrainRatioMin); INTERN(offensiveManaBurnDamageRatio);
-  INTERN(offensiveManaBurnChance); INTERN(offensiveManaBurnRatioAdder); INTERN(offensiveManaBurnRatioAdderChance);
-  INTERN(retaliationPhysicalModifier); INTERN(retaliationPhysicalModifierChance);
-  INTERN(retaliationColdModifier); INTERN(retaliationColdModifierChance);
-  INTERN(retaliationFireModifier); INTERN(retaliationFireModifierChance);
-  INTERN(retaliationLightningModifier); INTERN(retaliationLightningModifierChance);
-  INTERN(retaliationPoisonModifier); INTERN(retaliationPoisonModifierChance);
-  INTERN(retaliationPierceModifier); INTERN(retaliationPierceModifierChance);
-  INTERN(retaliationLifeModifier); INTERN(retaliationLifeModifierChance);
-  INTERN(retaliationStunModifier); INTERN(retaliationStunModifierChance);
-  INTERN(retaliationElementalModifier); INTERN(retaliationElementalModifierChance);
-  INTERN(offensiveTotalDamageReductionPercentMin); INTERN(offensiveTotalDamageReductionPercentChance);
-  INTERN(offensiveTotalDamageReductionPercentDurationMin);
-  INTERN(racialBonusPercentDamage); INTERN(racialBonusPercentDefense); INTERN(racialBonusRace);
-  INTERN(petBonusName);
-  INTERN(skillCooldownTime); INTERN(refreshTime);
-  INTERN(skillCooldownReduction); INTERN(skillCooldownReductionChance);
-  INTERN(skillManaCostReduction); INTERN(skillManaCostReductionChance);
-  INTERN(skillTargetNumber); INTERN(skillActiveDuration); INTERN(skillTargetRadius);
-  INTERN(offensiveGlobalChance);
-  INTERN(offensiveDisruptionMin);
-  INTERN(offensiveSlowLightningDurationMax); INTERN(offensiveSlowFireDurationMax);
-  INTERN(offensiveSlowColdDurationMax); INTERN(offensiveSlowPoisonDurationMax);
-  INTERN(defensiveDisruption); INTERN(defensiveDisruptionDuration);
-  INTERN(offensiveTotalResistanceReductionAbsoluteMin); INTERN(offensiveTotalResistanceReductionAbsoluteDurationMin);
-  INTERN(offensiveTotalResistanceReductionAbsoluteChance); INTERN(offensiveTotalResistanceReductionAbsoluteMax);
-  INTERN(offensiveTotalResistanceReductionPercentMin); INTERN(offensiveTotalResistanceReductionPercentDurationMin);
-  INTERN(offensiveTotalResistanceReductionPercentChance);
-  INTERN(offensiveSlowOffensiveAbilityModifier); INTERN(offensiveSlowOffensiveAbilityDurationMin);
-  INTERN(offensiveSlowPhysicalMin); INTERN(offensiveSlowPhysicalMax); INTERN(offensiveSlowPhysicalDurationMin); INTERN(offensiveSlowPhysicalChance);
-  INTERN(offensiveSlowDefensiveAbilityMin); INTERN(offensiveSlowDefensiveAbilityMax); INTERN(offensiveSlowDefensiveAbilityDurationMin); INTERN(offensiveSlowDefensiveAbilityChance);
-  INTERN(offensiveSlowOffensiveAbilityMin); INTERN(offensiveSlowOffensiveAbilityMax); INTERN(offensiveSlowOffensiveAbilityChance);
-  INTERN(offensiveSlowOffensiveReductionModifier); INTERN(offensiveSlowOffensiveReductionDurationMin);
-  INTERN(offensiveSlowTotalSpeedMin); INTERN(offensiveSlowTotalSpeedChance); INTERN(offensiveSlowTotalSpeedDurationMin);
-  INTERN(offensivePercentCurrentLifeMax); INTERN(offensiveConfusionMax);
-  INTERN(racialBonusAbsoluteDamage); INTERN(racialBonusAbsoluteDefense);
-  INTERN(retaliationSlowAttackSpeedMin); INTERN(retaliationSlowAttackSpeedDurationMin);
-  INTERN(retaliationSlowManaLeachMin); INTERN(retaliationSlowManaLeachDurationMin); INTERN(retaliationSlowManaLeachChance);
-  INTERN(retaliationPierceMax);
-  INTERN(retaliationFireMax); INTERN(retaliationColdMax); INTERN(retaliationLightningMax); INTERN(retaliationPhysicalMax);
-  INTERN(retaliationLifeMin); INTERN(retaliationLifeMax); INTERN(retaliationLifeChance);
-  INTERN(retaliationPoisonMin); INTERN(retaliationPoisonMax); INTERN(retaliationPoisonChance);
-  INTERN(retaliationStunMin); INTERN(retaliationStunMax); INTERN(retaliationStunChance);
-  INTERN(retaliationElementalMin); INTERN(retaliationElementalMax); INTERN(retaliationElementalChance);
-  INTERN(retaliationPercentCurrentLifeMin); INTERN(retaliationPercentCurrentLifeMax); INTERN(retaliationPercentCurrentLifeChance);
-  INTERN(retaliationGlobalChance);
-  INTERN(defensiveBlock); INTERN(defensiveBlockChance); INTERN(defensiveAbsorption); INTERN(defensivePetrify);
-  INTERN(offensivePierceRatioMin); INTERN(offensivePierceRatioMax); INTERN(offensivePierceRatioChance);
-  INTERN(offensivePierceRatioModifier); INTERN(offensivePierceRatioModifierChance);
-  INTERN(offensiveSlowRunSpeedMax);
-  INTERN(offensiveStunMax); INTERN(offensiveStunModifier);
-  INTERN(offensiveFreezeMax);
-  INTERN(offensiveSleepMin); INTERN(offensiveSleepMax); INTERN(offensiveSleepChance);
-  INTERN(offensiveSleepDurationMin); INTERN(offensiveSleepModifier);
-  INTERN(offensiveDisruptionMax); INTERN(offensiveDisruptionChance);
-  INTERN(offensiveBaseFireChance); INTERN(offensiveBaseColdChance); INTERN(offensiveBaseLightningChance);
-  INTERN(offensiveSlowLifeLeachDurationMax); INTERN(offensiveSlowManaLeachDurationMax);
-  INTERN(offensiveSlowBleedingDurationMax);
-  INTERN(defensiveSlowLifeLeach); INTERN(defensiveSlowLifeLeachChance);
-  INTERN(defensiveSlowManaLeach); INTERN(defensiveSlowManaLeachChance);
-  INTERN(defensivePoisonDuration); INTERN(defensivePoisonDurationChance);
-  INTERN(defensiveReflect); INTERN(defensiveReflectChance);
-  INTERN(itemNameTag); INTERN(description); INTERN(lootRandomizerName); INTERN(FileDescription);
-  INTERN(itemClassification); INTERN(itemText);
-  INTERN(characterBaseAttackSpeedTag); INTERN(artifactClassification);
-  INTERN(itemSkillName); INTERN(buffSkillName); INTERN(skillDisplayName);
-  INTERN(itemSkillAutoController); INTERN(triggerType); INTERN(itemSkillLevel);
-  INTERN(skillBaseDescription); INTERN(petSkillName); INTERN(skillChanceWeight);
-  INTERN(itemSetName); INTERN(setName); INTERN(setMembers);
-  INTERN(completedRelicLevel);
-  INTERN(dexterityRequirement); INTERN(intelligenceRequirement);
-  INTERN(strengthRequirement); INTERN(levelRequirement);
-  INTERN(itemLevel); INTERN(itemCostName); INTERN(Class);
 }
 
 // Free all item stats resources (skip set and attr map hash tables).
@@ -1065,7 +756,7 @@ item_bonus_stat_summary(const char *record_path, TQTranslation *tr)
   }
 
   // Also check stats handled in dedicated blocks (resistances, damage ranges)
-  static const struct { const char **val; const char *fmt; } extra_simple[] = {
+  static const struct { const char *const *val; const char *fmt; } extra_simple[] = {
     {&INT_defensiveFire, "%+d%% Fire Resistance"},
     {&INT_defensiveCold, "%+d%% Cold Resistance"},
     {&INT_defensiveLightning, "%+d%% Lightning Resistance"},
@@ -1111,7 +802,7 @@ item_bonus_stat_summary(const char *record_path, TQTranslation *tr)
   }
 
   // Flat retaliation (may have chance)
-  static const struct { const char **val; const char **chance; const char *label; } extra_retal[] = {
+  static const struct { const char *const *val; const char *const *chance; const char *label; } extra_retal[] = {
     {&INT_retaliationPhysicalMin,  &INT_retaliationPhysicalChance,  "Physical Retaliation"},
     {&INT_retaliationFireMin,      &INT_retaliationFireChance,      "Fire Retaliation"},
     {&INT_retaliationColdMin,      &INT_retaliationColdChance,      "Cold Retaliation"},
@@ -1157,7 +848,7 @@ item_bonus_stat_summary(const char *record_path, TQTranslation *tr)
   }
 
   // Damage ranges (min-max pairs from dedicated blocks), with optional chance
-  static const struct { const char **mn; const char **mx; const char **chance; const char *label; } extra_dmg[] = {
+  static const struct { const char *const *mn; const char *const *mx; const char *const *chance; const char *label; } extra_dmg[] = {
     {&INT_offensivePhysicalMin,     &INT_offensivePhysicalMax,     NULL,                      "Physical Damage"},
     {&INT_offensiveFireMin,         &INT_offensiveFireMax,         NULL,                      "Fire Damage"},
     {&INT_offensiveColdMin,         &INT_offensiveColdMax,         NULL,                      "Cold Damage"},
@@ -1334,7 +1025,7 @@ item_bonus_stat_summary(const char *record_path, TQTranslation *tr)
 
   // Offensive damage modifiers (may have chance qualifier)
   {
-    static const struct { const char **val; const char **chance; const char *label; } off_mod[] = {
+    static const struct { const char *const *val; const char *const *chance; const char *label; } off_mod[] = {
       {&INT_offensivePhysicalModifier,  &INT_offensivePhysicalModifierChance,  "Physical Damage"},
       {&INT_offensiveFireModifier,      &INT_offensiveFireModifierChance,      "Fire Damage"},
       {&INT_offensiveColdModifier,      &INT_offensiveColdModifierChance,      "Cold Damage"},
@@ -1542,7 +1233,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
     // prefix: stat name segment used to look up offensive<Prefix>Global.
     // is_base: weapon base damage (always top-level).  NULL prefix on
     // non-base entries means "no Global lookup" (treat like top-level).
-    static struct { const char **min_int; const char **max_int; const char **chance_int; const char *label; bool is_base; const char *prefix; } damage_types[] = {
+    static struct { const char *const *min_int; const char *const *max_int; const char *const *chance_int; const char *label; bool is_base; const char *prefix; } damage_types[] = {
       {&INT_offensivePhysicalMin, &INT_offensivePhysicalMax, &INT_offensivePhysicalChance, "Physical Damage", false, "Physical"},
       {&INT_offensiveFireMin, &INT_offensiveFireMax, &INT_offensiveFireChance, "Fire Damage", false, "Fire"},
       {&INT_offensiveColdMin, &INT_offensiveColdMax, &INT_offensiveColdChance, "Cold Damage", false, "Cold"},
@@ -1622,7 +1313,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
 
   // DoT: all damage-over-time types with optional chance
   {
-    static struct { const char **min_int; const char **max_int; const char **dur_int; const char **chance_int; const char *label; } dot_types[] = {
+    static struct { const char *const *min_int; const char *const *max_int; const char *const *dur_int; const char *const *chance_int; const char *label; } dot_types[] = {
       {&INT_offensiveSlowFireMin,      &INT_offensiveSlowFireMax,      &INT_offensiveSlowFireDurationMin,      &INT_offensiveSlowFireChance,      "Burn Damage"},
       {&INT_offensiveSlowLightningMin, &INT_offensiveSlowLightningMax, &INT_offensiveSlowLightningDurationMin, &INT_offensiveSlowLightningChance, "Electrical Burn Damage"},
       {&INT_offensiveSlowColdMin,      &INT_offensiveSlowColdMax,      &INT_offensiveSlowColdDurationMin,      &INT_offensiveSlowColdChance,      "Frostburn Damage"},
@@ -1671,7 +1362,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
   // block only when its corresponding offensiveSlow*Global flag is set;
   // otherwise it stays top-level.
   {
-    static const struct { const char **val; const char **chance; const char *label; const char *prefix; } slow_mod_defs[] = {
+    static const struct { const char *const *val; const char *const *chance; const char *label; const char *prefix; } slow_mod_defs[] = {
       {&INT_offensiveSlowFireModifier,      &INT_offensiveSlowFireModifierChance,      "Burn Damage",            "SlowFire"},
       {&INT_offensiveSlowColdModifier,      &INT_offensiveSlowColdModifierChance,      "Frostburn Damage",       "SlowCold"},
       {&INT_offensiveSlowLightningModifier, &INT_offensiveSlowLightningModifierChance, "Electrical Burn Damage", "SlowLightning"},
@@ -1706,7 +1397,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
   // Retaliation DoTs (damage over time triggered on retaliation, may have chance)
   {
     static const struct {
-      const char **val; const char **max; const char **dur; const char **chance; const char *label;
+      const char *const *val; const char *const *max; const char *const *dur; const char *const *chance; const char *label;
     } retal_dots[] = {
       {&INT_retaliationSlowFireMin,      &INT_retaliationSlowFireMax,      &INT_retaliationSlowFireDurationMin,      &INT_retaliationSlowFireChance,      "Burn Retaliation"},
       {&INT_retaliationSlowColdMin,      &INT_retaliationSlowColdMax,      &INT_retaliationSlowColdDurationMin,      &INT_retaliationSlowColdChance,      "Frostburn Retaliation"},
@@ -1755,7 +1446,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
   // Flat retaliation (may have chance and/or max range)
   {
     static const struct {
-      const char **val; const char **max; const char **chance; const char *label;
+      const char *const *val; const char *const *max; const char *const *chance; const char *label;
     } retal_flat[] = {
       {&INT_retaliationPhysicalMin,  &INT_retaliationPhysicalMax,  &INT_retaliationPhysicalChance,  "Physical Retaliation"},
       {&INT_retaliationFireMin,      &INT_retaliationFireMax,      &INT_retaliationFireChance,      "Fire Retaliation"},
@@ -1854,7 +1545,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
   // Slow / ability / damage-reduction retaliation debuffs (rate, not damage * duration)
   {
     static const struct {
-      const char **min; const char **max; const char **dur; const char **chance;
+      const char *const *min; const char *const *max; const char *const *dur; const char *const *chance;
       const char *label; bool is_percent;
     } retal_debuffs[] = {
       {&INT_retaliationSlowRunSpeedMin,         &INT_retaliationSlowRunSpeedMax,         &INT_retaliationSlowRunSpeedDurationMin,         &INT_retaliationSlowRunSpeedChance,         "Slow Retaliation",                          true},
@@ -2018,7 +1709,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
   // set; otherwise it stays top-level.  TotalDamage has no Global
   // partner and always renders top-level.
   {
-    static const struct { const char **val; const char **chance; const char *label; const char *prefix; } off_mod_defs[] = {
+    static const struct { const char *const *val; const char *const *chance; const char *label; const char *prefix; } off_mod_defs[] = {
       {&INT_offensivePhysicalModifier,  &INT_offensivePhysicalModifierChance,  "Physical Damage",  "Physical"},
       {&INT_offensiveFireModifier,      &INT_offensiveFireModifierChance,      "Fire Damage",      "Fire"},
       {&INT_offensiveColdModifier,      &INT_offensiveColdModifierChance,      "Cold Damage",      "Cold"},
@@ -2055,7 +1746,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
 
   // Retaliation %-modifiers (may have chance)
   {
-    static const struct { const char **val; const char **chance; const char *label; } retal_mod_defs[] = {
+    static const struct { const char *const *val; const char *const *chance; const char *label; } retal_mod_defs[] = {
       {&INT_retaliationPhysicalModifier,  &INT_retaliationPhysicalModifierChance,  "Physical Retaliation"},
       {&INT_retaliationColdModifier,      &INT_retaliationColdModifierChance,      "Cold Retaliation"},
       {&INT_retaliationFireModifier,      &INT_retaliationFireModifierChance,      "Fire Retaliation"},
@@ -2436,7 +2127,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
   // Reduced Defensive/Offensive Ability proc-style (Min/Max/Chance, applied to enemies)
   {
     static const struct {
-      const char **min; const char **max; const char **dur; const char **chance; const char *label;
+      const char *const *min; const char *const *max; const char *const *dur; const char *const *chance; const char *label;
     } ability_debuffs[] = {
       {&INT_offensiveSlowDefensiveAbilityMin, &INT_offensiveSlowDefensiveAbilityMax, &INT_offensiveSlowDefensiveAbilityDurationMin, &INT_offensiveSlowDefensiveAbilityChance, "Reduced Defensive Ability"},
       {&INT_offensiveSlowOffensiveAbilityMin, &INT_offensiveSlowOffensiveAbilityMax, &INT_offensiveSlowOffensiveAbilityDurationMin, &INT_offensiveSlowOffensiveAbilityChance, "Reduced Offensive Ability"},
@@ -2643,7 +2334,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
   // "X% Chance of -Y% Recharge" is one effect; the standalone Chance and
   // value fields should not render as separate lines.
   {
-    static const struct { const char **val; const char **chance; const char *label; } skill_red[] = {
+    static const struct { const char *const *val; const char *const *chance; const char *label; } skill_red[] = {
       {&INT_skillCooldownReduction, &INT_skillCooldownReductionChance, "Recharge"},
       {&INT_skillManaCostReduction, &INT_skillManaCostReductionChance, "Energy Cost"},
     };
@@ -2673,7 +2364,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
     if(!v->name)
       continue;
 
-    const char *interned = arz_intern(v->name);
+    const char *interned = arz_sym_name(v->sym);
 
     // skip already-handled vars
     if(strncasecmp(v->name, "augmentMastery", 14) == 0)
@@ -2714,7 +2405,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
 
   // Defensive resistances (may have chance)
   {
-    static const struct { const char **val; const char **chance; const char *label; } resist_defs[] = {
+    static const struct { const char *const *val; const char *const *chance; const char *label; } resist_defs[] = {
       {&INT_defensiveFire,      &INT_defensiveFireChance,      "Fire"},
       {&INT_defensiveCold,      &INT_defensiveColdChance,      "Cold"},
       {&INT_defensiveLightning, &INT_defensiveLightningChance, "Lightning"},
@@ -2745,7 +2436,7 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
 
   // DoT resistances / duration reductions with optional chance
   {
-    static const struct { const char **val; const char **chance; const char *label; } dot_resist[] = {
+    static const struct { const char *const *val; const char *const *chance; const char *label; } dot_resist[] = {
       {&INT_defensiveSlowLifeLeach,  &INT_defensiveSlowLifeLeachChance,  "Vitality Decay Resistance"},
       {&INT_defensiveSlowManaLeach,  &INT_defensiveSlowManaLeachChance,  "Energy Drain Resistance"},
       {&INT_defensivePoisonDuration, &INT_defensivePoisonDurationChance, "Reduced Poison Duration"},
@@ -142,17 +142,6 @@ add_stats_from_record(const char *record_path, TQTranslation *tr, BufWriter *w,
 bool
 path_contains_ci(const char *path, const char *needle);
 
-// Pre-interned variable name pointers (shared across item_stats modules)
-extern const char *INT_itemNameTag, *INT_description, *INT_lootRandomizerName, *INT_FileDescription;
-extern const char *INT_itemClassification, *INT_itemText;
-extern const char *INT_characterBaseAttackSpeedTag, *INT_artifactClassification;
-extern const char *INT_itemSkillName, *INT_buffSkillName, *INT_skillDisplayName;
-extern const char *INT_itemSkillAutoController, *INT_triggerType, *INT_itemSkillLevel;
-extern const char *INT_skillBaseDescription, *INT_petSkillName, *INT_skillChanceWeight;
-extern const char *INT_itemSetName, *INT_setName, *INT_setMembers;
-extern const char *INT_completedRelicLevel;
-extern const char *INT_dexterityRequirement, *INT_intelligenceRequirement;
-extern const char *INT_strengthRequirement, *INT_levelRequirement;
-extern const char *INT_itemLevel, *INT_itemCostName, *INT_Class;
+// Variable name constants (INT_*) come from arz.h / arz_syms.h
 
 #endif
@@ -371,7 +371,7 @@ add_requirements(const char *record_path, BufWriter *w)
 
   buf_write(w, "\n");
 
-  static struct { const char **interned; const char *label; const char *eq_suffix; } req_types[] = {
+  static struct { const char *const *interned; const char *label; const char *eq_suffix; } req_types[] = {
     {&INT_levelRequirement,        "Required Player Level", "LevelEquation"},
     {&INT_dexterityRequirement,    "Required Dexterity",    "DexterityEquation"},
     {&INT_intelligenceRequirement, "Required Intelligence", "IntelligenceEquation"},
@@ -995,11 +995,11 @@ format_stats_common(uint32_t seed, const char *base_name, const char *prefix_nam
 
 // Get a resistance value from a single DBR record.
 // record_path: DBR path to load.
-// attr_name: attribute name to query.
+// attr: attribute symbol to query.
 // shard_index: shard index for multi-value variables.
 // Returns: resistance value, or 0.0f if not found.
 static float
-get_dbr_resistance(const char *record_path, const char *attr_name, int shard_index)
+get_dbr_resistance(const char *record_path, TQArzSym attr, int shard_index)
 {
   if(!record_path || !record_path[0])
     return(0.0f);
@@ -1009,8 +1009,7 @@ get_dbr_resistance(const char *record_path, const char *attr_name, int shard_ind
   if(!data)
     return(0.0f);
 
-  const char *interned = arz_intern(attr_name);
-  TQVariable *v = arz_record_get_var(data, interned);
+  TQVariable *v = arz_record_get_sym(data, attr);
 
   if(!v)
     return(0.0f);
@@ -1025,11 +1024,13 @@ get_dbr_resistance(const char *record_path, const char *attr_name, int shard_ind
 
 // Like get_dbr_resistance but returns 0 if the stat has an associated Chance < 100%.
 // record_path: DBR path to load.
-// attr_name: attribute name to query.
+// attr: attribute symbol to query.
+// chance_attr: symbol of its {attr}Chance partner.
 // shard_index: shard index for multi-value variables.
 // Returns: guaranteed stat value, or 0.0f.
 static float
-get_dbr_guaranteed(const char *record_path, const char *attr_name, int shard_index)
+get_dbr_guaranteed(const char *record_path, TQArzSym attr, TQArzSym chance_attr,
+                   int shard_index)
 {
   if(!record_path || !record_path[0])
     return(0.0f);
@@ -1039,19 +1040,13 @@ get_dbr_guaranteed(const char *record_path, const char *attr_name, int shard_ind
   if(!data)
     return(0.0f);
 
-  const char *interned = arz_intern(attr_name);
-  TQVariable *v = arz_record_get_var(data, interned);
+  TQVariable *v = arz_record_get_sym(data, attr);
 
   if(!v)
     return(0.0f);
 
   // Check for a corresponding Chance variable
-  char chance_name[128];
-
-  snprintf(chance_name, sizeof(chance_name), "%sChance", attr_name);
-
-  const char *chance_interned = arz_intern(chance_name);
-  TQVariable *cv = arz_record_get_var(data, chance_interned);
+  TQVariable *cv = arz_record_get_sym(data, chance_attr);
 
   if(cv && cv->count > 0)
   {
@@ -1083,13 +1078,16 @@ item_get_resistance(TQItem *item, const char *attr_name)
   int si1 = item->var1 > 0 ? (int)item->var1 - 1 : 0;
   int si2 = item->var2 > 0 ? (int)item->var2 - 1 : 0;
 
-  return(get_dbr_resistance(item->base_name, attr_name, 0)
-       + get_dbr_resistance(item->prefix_name, attr_name, 0)
-       + get_dbr_resistance(item->suffix_name, attr_name, 0)
-       + get_dbr_resistance(item->relic_name, attr_name, si1)
-       + get_dbr_resistance(item->relic_bonus, attr_name, 0)
-       + get_dbr_resistance(item->relic_name2, attr_name, si2)
-       + get_dbr_resistance(item->relic_bonus2, attr_name, 0));
+  // resolve the name once for all seven components
+  TQArzSym attr = arz_sym(arz_intern(attr_name));
+
+  return(get_dbr_resistance(item->base_name, attr, 0)
+       + get_dbr_resistance(item->prefix_name, attr, 0)
+       + get_dbr_resistance(item->suffix_name, attr, 0)
+       + get_dbr_resistance(item->relic_name, attr, si1)
+       + get_dbr_resistance(item->relic_bonus, attr, 0)
+       + get_dbr_resistance(item->relic_name2, attr, si2)
+       + get_dbr_resistance(item->relic_bonus2, attr, 0));
 }
 
 // Like item_get_resistance but excludes stats that have an associated
@@ -1106,24 +1104,32 @@ item_get_guaranteed_stat(TQItem *item, const char *attr_name)
   int si1 = item->var1 > 0 ? (int)item->var1 - 1 : 0;
   int si2 = item->var2 > 0 ? (int)item->var2 - 1 : 0;
 
-  return(get_dbr_guaranteed(item->base_name, attr_name, 0)
-       + get_dbr_guaranteed(item->prefix_name, attr_name, 0)
-       + get_dbr_guaranteed(item->suffix_name, attr_name, 0)
-       + get_dbr_guaranteed(item->relic_name, attr_name, si1)
-       + get_dbr_guaranteed(item->relic_bonus, attr_name, 0)
-       + get_dbr_guaranteed(item->relic_name2, attr_name, si2)
-       + get_dbr_guaranteed(item->relic_bonus2, attr_name, 0));
+  // resolve the stat and its {attr}Chance partner once for all components
+  char chance_name[128];
+
+  snprintf(chance_name, sizeof(chance_name), "%sChance", attr_name);
+
+  TQArzSym attr = arz_sym(arz_intern(attr_name));
+  TQArzSym chance = arz_sym(arz_intern(chance_name));
+
+  return(get_dbr_guaranteed(item->base_name, attr, chance, 0)
+       + get_dbr_guaranteed(item->prefix_name, attr, chance, 0)
+       + get_dbr_guaranteed(item->suffix_name, attr, chance, 0)
+       + get_dbr_guaranteed(item->relic_name, attr, chance, si1)
+       + get_dbr_guaranteed(item->relic_bonus, attr, chance, 0)
+       + get_dbr_guaranteed(item->relic_name2, attr, chance, si2)
+       + get_dbr_guaranteed(item->relic_bonus2, attr, chance, 0));
 }
 
 // Like get_dbr_guaranteed but with an explicit chance attribute name.
 // record_path: DBR path to load.
-// attr_name: attribute name to query.
-// chance_attr: explicit chance attribute name.
+// attr: attribute symbol to query.
+// chance_attr: explicit chance attribute symbol (ARZ_SYM_NONE for none).
 // shard_index: shard index for multi-value variables.
 // Returns: guaranteed stat value, or 0.0f.
 static float
-get_dbr_guaranteed_ex(const char *record_path, const char *attr_name,
-                      const char *chance_attr, int shard_index)
+get_dbr_guaranteed_ex(const char *record_path, TQArzSym attr,
+                      TQArzSym chance_attr, int shard_index)
 {
   if(!record_path || !record_path[0])
     return(0.0f);
@@ -1133,15 +1139,14 @@ get_dbr_guaranteed_ex(const char *record_path, const char *attr_name,
   if(!data)
     return(0.0f);
 
-  const char *interned = arz_intern(attr_name);
-  TQVariable *v = arz_record_get_var(data, interned);
+  TQVariable *v = arz_record_get_sym(data, attr);
 
   if(!v)
     return(0.0f);
 
   if(chance_attr)
   {
-    TQVariable *cv = arz_record_get_var(data, arz_intern(chance_attr));
+    TQVariable *cv = arz_record_get_sym(data, chance_attr);
 
     if(cv && cv->count > 0)
     {
@@ -1174,27 +1179,30 @@ item_get_guaranteed_stat_ex(TQItem *item, const char *attr_name, const char *cha
   int si1 = item->var1 > 0 ? (int)item->var1 - 1 : 0;
   int si2 = item->var2 > 0 ? (int)item->var2 - 1 : 0;
 
-  return(get_dbr_guaranteed_ex(item->base_name, attr_name, chance_attr, 0)
-       + get_dbr_guaranteed_ex(item->prefix_name, attr_name, chance_attr, 0)
-       + get_dbr_guaranteed_ex(item->suffix_name, attr_name, chance_attr, 0)
-       + get_dbr_guaranteed_ex(item->relic_name, attr_name, chance_attr, si1)
-       + get_dbr_guaranteed_ex(item->relic_bonus, attr_name, chance_attr, 0)
-       + get_dbr_guaranteed_ex(item->relic_name2, attr_name, chance_attr, si2)
-       + get_dbr_guaranteed_ex(item->relic_bonus2, attr_name, chance_attr, 0));
+  TQArzSym attr = arz_sym(arz_intern(attr_name));
+  TQArzSym chance = arz_sym(arz_intern(chance_attr));
+
+  return(get_dbr_guaranteed_ex(item->base_name, attr, chance, 0)
+       + get_dbr_guaranteed_ex(item->prefix_name, attr, chance, 0)
+       + get_dbr_guaranteed_ex(item->suffix_name, attr, chance, 0)
+       + get_dbr_guaranteed_ex(item->relic_name, attr, chance, si1)
+       + get_dbr_guaranteed_ex(item->relic_bonus, attr, chance, 0)
+       + get_dbr_guaranteed_ex(item->relic_name2, attr, chance, si2)
+       + get_dbr_guaranteed_ex(item->relic_bonus2, attr, chance, 0));
 }
 
 // Returns mean of a guaranteed damage range from a single DBR.
 // If max > min, returns (min + max) / 2; otherwise returns min.
 // Returns 0 if the stat has a chance > 0 and < 100%.
 // record_path: DBR path to load.
-// min_attr: DBR attribute for minimum damage.
-// max_attr: DBR attribute for maximum damage.
-// chance_attr: DBR attribute for chance (NULL if always guaranteed).
+// min_attr: attribute symbol for minimum damage.
+// max_attr: attribute symbol for maximum damage.
+// chance_attr: chance attribute symbol (ARZ_SYM_NONE if always guaranteed).
 // shard_index: shard index for multi-value variables.
 // Returns: guaranteed mean damage, or 0.0f.
 static float
-get_dbr_guaranteed_mean(const char *record_path, const char *min_attr,
-                        const char *max_attr, const char *chance_attr,
+get_dbr_guaranteed_mean(const char *record_path, TQArzSym min_attr,
+                        TQArzSym max_attr, TQArzSym chance_attr,
                         int shard_index)
 {
   if(!record_path || !record_path[0])
@@ -1205,7 +1213,7 @@ get_dbr_guaranteed_mean(const char *record_path, const char *min_attr,
   if(!data)
     return(0.0f);
 
-  TQVariable *vmin = arz_record_get_var(data, arz_intern(min_attr));
+  TQVariable *vmin = arz_record_get_sym(data, min_attr);
 
   if(!vmin)
     return(0.0f);
@@ -1213,7 +1221,7 @@ get_dbr_guaranteed_mean(const char *record_path, const char *min_attr,
   // Check chance -- if > 0 and < 100, not guaranteed
   if(chance_attr)
   {
-    TQVariable *cv = arz_record_get_var(data, arz_intern(chance_attr));
+    TQVariable *cv = arz_record_get_sym(data, chance_attr);
 
     if(cv && cv->count > 0)
     {
@@ -1234,7 +1242,7 @@ get_dbr_guaranteed_mean(const char *record_path, const char *min_attr,
   if(mn <= 0)
     return(0.0f);
 
-  TQVariable *vmax = arz_record_get_var(data, arz_intern(max_attr));
+  TQVariable *vmax = arz_record_get_sym(data, max_attr);
 
   if(vmax)
   {
@@ -1269,25 +1277,29 @@ item_get_guaranteed_damage_mean(TQItem *item, const char *min_attr,
   int si1 = item->var1 > 0 ? (int)item->var1 - 1 : 0;
   int si2 = item->var2 > 0 ? (int)item->var2 - 1 : 0;
 
-  return(get_dbr_guaranteed_mean(item->base_name, min_attr, max_attr, chance_attr, 0)
-       + get_dbr_guaranteed_mean(item->prefix_name, min_attr, max_attr, chance_attr, 0)
-       + get_dbr_guaranteed_mean(item->suffix_name, min_attr, max_attr, chance_attr, 0)
-       + get_dbr_guaranteed_mean(item->relic_name, min_attr, max_attr, chance_attr, si1)
-       + get_dbr_guaranteed_mean(item->relic_bonus, min_attr, max_attr, chance_attr, 0)
-       + get_dbr_guaranteed_mean(item->relic_name2, min_attr, max_attr, chance_attr, si2)
-       + get_dbr_guaranteed_mean(item->relic_bonus2, min_attr, max_attr, chance_attr, 0));
+  TQArzSym mn = arz_sym(arz_intern(min_attr));
+  TQArzSym mx = arz_sym(arz_intern(max_attr));
+  TQArzSym chance = arz_sym(arz_intern(chance_attr));
+
+  return(get_dbr_guaranteed_mean(item->base_name, mn, mx, chance, 0)
+       + get_dbr_guaranteed_mean(item->prefix_name, mn, mx, chance, 0)
+       + get_dbr_guaranteed_mean(item->suffix_name, mn, mx, chance, 0)
+       + get_dbr_guaranteed_mean(item->relic_name, mn, mx, chance, si1)
+       + get_dbr_guaranteed_mean(item->relic_bonus, mn, mx, chance, 0)
+       + get_dbr_guaranteed_mean(item->relic_name2, mn, mx, chance, si2)
+       + get_dbr_guaranteed_mean(item->relic_bonus2, mn, mx, chance, 0));
 }
 
 // Returns min * duration from a single DBR, only if guaranteed (chance == 0 or >= 100).
 // record_path: DBR path to load.
-// min_attr: DBR attribute for minimum damage.
-// dur_attr: DBR attribute for duration.
-// chance_attr: DBR attribute for chance.
+// min_attr: attribute symbol for minimum damage.
+// dur_attr: attribute symbol for duration.
+// chance_attr: attribute symbol for chance.
 // shard_index: shard index for multi-value variables.
 // Returns: total guaranteed DOT damage, or 0.0f.
 static float
-get_dbr_guaranteed_dot(const char *record_path, const char *min_attr,
-                       const char *dur_attr, const char *chance_attr,
+get_dbr_guaranteed_dot(const char *record_path, TQArzSym min_attr,
+                       TQArzSym dur_attr, TQArzSym chance_attr,
                        int shard_index)
 {
   if(!record_path || !record_path[0])
@@ -1299,7 +1311,7 @@ get_dbr_guaranteed_dot(const char *record_path, const char *min_attr,
     return(0.0f);
 
   // Check chance -- if > 0 and < 100, not guaranteed
-  TQVariable *cv = arz_record_get_var(data, arz_intern(chance_attr));
+  TQVariable *cv = arz_record_get_sym(data, chance_attr);
 
   if(cv && cv->count > 0)
   {
@@ -1309,7 +1321,7 @@ get_dbr_guaranteed_dot(const char *record_path, const char *min_attr,
       return(0.0f);
   }
 
-  TQVariable *mv = arz_record_get_var(data, arz_intern(min_attr));
+  TQVariable *mv = arz_record_get_sym(data, min_attr);
 
   if(!mv || mv->count == 0)
     return(0.0f);
@@ -1324,7 +1336,7 @@ get_dbr_guaranteed_dot(const char *record_path, const char *min_attr,
   if(minv <= 0)
     return(0.0f);
 
-  TQVariable *dv = arz_record_get_var(data, arz_intern(dur_attr));
+  TQVariable *dv = arz_record_get_sym(data, dur_attr);
 
   if(!dv || dv->count == 0)
     return(0.0f);
@@ -1355,13 +1367,17 @@ item_get_guaranteed_dot(TQItem *item, const char *min_attr, const char *dur_attr
   int si1 = item->var1 > 0 ? (int)item->var1 - 1 : 0;
   int si2 = item->var2 > 0 ? (int)item->var2 - 1 : 0;
 
-  return(get_dbr_guaranteed_dot(item->base_name, min_attr, dur_attr, chance_attr, 0)
-       + get_dbr_guaranteed_dot(item->prefix_name, min_attr, dur_attr, chance_attr, 0)
-       + get_dbr_guaranteed_dot(item->suffix_name, min_attr, dur_attr, chance_attr, 0)
-       + get_dbr_guaranteed_dot(item->relic_name, min_attr, dur_attr, chance_attr, si1)
-       + get_dbr_guaranteed_dot(item->relic_bonus, min_attr, dur_attr, chance_attr, 0)
-       + get_dbr_guaranteed_dot(item->relic_name2, min_attr, dur_attr, chance_attr, si2)
-       + get_dbr_guaranteed_dot(item->relic_bonus2, min_attr, dur_attr, chance_attr, 0));
+  TQArzSym mn = arz_sym(arz_intern(min_attr));
+  TQArzSym dur = arz_sym(arz_intern(dur_attr));
+  TQArzSym chance = arz_sym(arz_intern(chance_attr));
+
+  return(get_dbr_guaranteed_dot(item->base_name, mn, dur, chance, 0)
+       + get_dbr_guaranteed_dot(item->prefix_name, mn, dur, chance, 0)
+       + get_dbr_guaranteed_dot(item->suffix_name, mn, dur, chance, 0)
+       + get_dbr_guaranteed_dot(item->relic_name, mn, dur, chance, si1)
+       + get_dbr_guaranteed_dot(item->relic_bonus, mn, dur, chance, 0)
+       + get_dbr_guaranteed_dot(item->relic_name2, mn, dur, chance, si2)
+       + get_dbr_guaranteed_dot(item->relic_bonus2, mn, dur, chance, 0));
 }
 
 // public API
@@ -12,6 +12,8 @@
 #include "affix_table.h"
 #include "item_stats.h"
 #include "prefetch.h"
+#include "icon_loader.h"
+#include "icon_cache.h"
 #include "translation.h"
 
 static int g_saved_argc;
@@ -170,7 +172,7 @@ on_activate(GtkApplication *app, gpointer user_data)
 
     affix_table_init(NULL);
     if(tqvc_debug)
-      printf("Main: Affix table initialized.\n");
+      printf("Main: Affix table build started.\n");
   }
 
   if(tqvc_debug)
@@ -299,8 +301,14 @@ main(int argc, char **argv)
     printf("Main: GTK application finished with status %d.\n", status);
 
   prefetch_free();
+  icon_loader_free();
+  // the UI dropped its atlas-backed icons on "shutdown", so the atlas file
+  // is no longer mapped by anything but the cache itself
+  icon_cache_save();
+  icon_cache_free();
   item_stats_free();
   affix_table_free();
+  translation_languages_free();
   arz_intern_free();
   asset_manager_free();
   config_free();
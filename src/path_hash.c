@@ -0,0 +1,147 @@
+#include "path_hash.h"
+#include <string.h>
+
+#define PF(c) ((c) == '/' ? '\\' : ((c) >= 'A' && (c) <= 'Z') ? (c) + 32 : (c))
+#define PF4(c) PF(c), PF((c) + 1), PF((c) + 2), PF((c) + 3)
+#define PF16(c) PF4(c), PF4((c) + 4), PF4((c) + 8), PF4((c) + 12)
+#define PF64(c) PF16(c), PF16((c) + 16), PF16((c) + 32), PF16((c) + 48)
+
+// lowercase ASCII letters and map '/' to '\'; every other byte is itself
+const uint8_t path_fold_table[256] = {
+  PF64(0), PF64(64), PF64(128), PF64(192)
+};
+
+#undef PF64
+#undef PF16
+#undef PF4
+#undef PF
+
+#define FNV64_OFFSET 0xcbf29ce484222325ULL
+#define FNV64_PRIME  0x100000001b3ULL
+
+// path_normalize - copy a path into buf in folded form
+// path: input path (need not be NUL-terminated)
+// len: path length in bytes
+// buf: output buffer (NUL-terminated on return)
+// buf_size: size of buf; longer paths are truncated
+// returns: length of the normalized path
+size_t
+path_normalize(const char *path, size_t len, char *buf, size_t buf_size)
+{
+  if(len >= buf_size)
+    len = buf_size - 1;
+
+  for(size_t i = 0; i < len; i++)
+    buf[i] = (char)path_fold_table[(uint8_t)path[i]];
+
+  buf[len] = '\0';
+  return(len);
+}
+
+// path_hash_len - 64-bit FNV-1a hash of the folded form of a path
+// path: input path (need not be NUL-terminated)
+// len: path length in bytes
+// returns: hash value (equal for paths that differ only in case/separator)
+uint64_t
+path_hash_len(const char *path, size_t len)
+{
+  uint64_t h = FNV64_OFFSET;
+
+  for(size_t i = 0; i < len; i++)
+  {
+    h ^= path_fold_table[(uint8_t)path[i]];
+    h *= FNV64_PRIME;
+  }
+
+  return(h);
+}
+
+// path_hash - 64-bit FNV-1a hash of the folded form of a C string
+// path: NUL-terminated path
+// returns: hash value, or 0 if path is NULL
+uint64_t
+path_hash(const char *path)
+{
+  if(!path)
+    return(0);
+
+  uint64_t h = FNV64_OFFSET;
+
+  for(const uint8_t *p = (const uint8_t *)path; *p; p++)
+  {
+    h ^= path_fold_table[*p];
+    h *= FNV64_PRIME;
+  }
+
+  return(h);
+}
+
+// path_equal - compare two paths in folded form
+// a: first NUL-terminated path
+// b: second NUL-terminated path
+// returns: true if the paths match ignoring case and separator style
+bool
+path_equal(const char *a, const char *b)
+{
+  const uint8_t *p = (const uint8_t *)a;
+  const uint8_t *q = (const uint8_t *)b;
+
+  while(*p && path_fold_table[*p] == path_fold_table[*q])
+  {
+    p++;
+    q++;
+  }
+
+  return(path_fold_table[*p] == path_fold_table[*q]);
+}
+
+// path_sorted_find - find a path in a table of records sorted by path_hash()
+// base: first record
+// count: number of records
+// stride: record size in bytes
+// hash_field: offset of the record's uint64_t path hash
+// offset_field: offset of the record's uint32_t path offset into strings
+// strings: pool of NUL-terminated paths
+// path: path to find (case and separators are ignored)
+// returns: pointer to the matching record, or NULL if not found
+const void *
+path_sorted_find(const void *base, uint32_t count, size_t stride,
+                 size_t hash_field, size_t offset_field,
+                 const char *strings, const char *path)
+{
+  const uint8_t *records = (const uint8_t *)base;
+  uint64_t hash = path_hash(path);
+  uint64_t h;
+  uint32_t low = 0;
+  uint32_t high = count;
+
+  while(low < high)
+  {
+    uint32_t mid = low + (high - low) / 2;
+
+    memcpy(&h, records + (size_t)mid * stride + hash_field, sizeof(h));
+
+    if(h < hash)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  for(uint32_t i = low; i < count; i++)
+  {
+    const uint8_t *rec = records + (size_t)i * stride;
+    uint32_t off;
+
+    memcpy(&h, rec + hash_field, sizeof(h));
+
+    if(h != hash)
+      break;
+
+    memcpy(&off, rec + offset_field, sizeof(off));
+
+    if(path_equal(strings + off, path))
+      return(rec);
+  }
+
+  return(NULL);
+}
@@ -0,0 +1,65 @@
+#ifndef PATH_HASH_H
+#define PATH_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Game paths are compared case-insensitively with '/' and '\' treated as
+// the same separator. These helpers fold each byte through one lookup
+// table while they hash or compare, so callers never need a normalized
+// copy of the path.
+
+// path_fold_table - folded form of every byte (lowercase ASCII, '/' -> '\')
+extern const uint8_t path_fold_table[256];
+
+// path_fold - fold one path byte
+// c: byte to fold
+// returns: folded byte
+static inline char
+path_fold(char c)
+{
+  return((char)path_fold_table[(uint8_t)c]);
+}
+
+// path_normalize - copy a path into buf in folded form
+// path: input path (need not be NUL-terminated)
+// len: path length in bytes
+// buf: output buffer (NUL-terminated on return)
+// buf_size: size of buf; longer paths are truncated
+// returns: length of the normalized path
+size_t path_normalize(const char *path, size_t len, char *buf, size_t buf_size);
+
+// path_hash_len - 64-bit FNV-1a hash of the folded form of a path
+// path: input path (need not be NUL-terminated)
+// len: path length in bytes
+// returns: hash value (equal for paths that differ only in case/separator)
+uint64_t path_hash_len(const char *path, size_t len);
+
+// path_hash - 64-bit FNV-1a hash of the folded form of a C string
+// path: NUL-terminated path
+// returns: hash value, or 0 if path is NULL
+uint64_t path_hash(const char *path);
+
+// path_equal - compare two paths in folded form
+// a: first NUL-terminated path
+// b: second NUL-terminated path
+// returns: true if the paths match ignoring case and separator style
+bool path_equal(const char *a, const char *b);
+
+// path_sorted_find - find a path in a table of records sorted by path_hash().
+// Binary searches for the first record with the path's hash, then checks
+// the run of equal hashes with path_equal(). Records may be packed.
+// base: first record
+// count: number of records
+// stride: record size in bytes
+// hash_field: offset of the record's uint64_t path hash
+// offset_field: offset of the record's uint32_t path offset into strings
+// strings: pool of NUL-terminated paths
+// path: path to find (case and separators are ignored)
+// returns: pointer to the matching record, or NULL if not found
+const void *path_sorted_find(const void *base, uint32_t count, size_t stride,
+                             size_t hash_field, size_t offset_field,
+                             const char *strings, const char *path);
+
+#endif
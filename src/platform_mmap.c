@@ -1,4 +1,6 @@
 #include "platform_mmap.h"
+#include <stdio.h>
+#include <stdatomic.h>
 
 #ifdef _WIN32
 
@@ -58,6 +60,46 @@ platform_munmap(void *addr, size_t size)
     UnmapViewOfFile(addr);
 }
 
+// platform_file_info - query a file's size and modification time (Windows)
+// path: filesystem path to the file
+// out_size: on success, set to the file size in bytes
+// out_mtime: on success, set to the last-write FILETIME as a 64-bit value
+// returns: true on success, false if the file cannot be queried
+bool
+platform_file_info(const char *path, uint64_t *out_size, int64_t *out_mtime)
+{
+  WIN32_FILE_ATTRIBUTE_DATA fad;
+
+  if(!path || !GetFileAttributesExA(path, GetFileExInfoStandard, &fad))
+    return(false);
+
+  if(out_size)
+    *out_size = ((uint64_t)fad.nFileSizeHigh << 32) | fad.nFileSizeLow;
+
+  if(out_mtime)
+    *out_mtime = (int64_t)(((uint64_t)fad.ftLastWriteTime.dwHighDateTime << 32) |
+                           fad.ftLastWriteTime.dwLowDateTime);
+
+  return(true);
+}
+
+// platform_replace_file - rename src over dst, replacing dst (Windows)
+// src: file to move
+// dst: file to replace
+// returns: true on success
+static bool
+platform_replace_file(const char *src, const char *dst)
+{
+  return(MoveFileExA(src, dst, MOVEFILE_REPLACE_EXISTING) != 0);
+}
+
+// platform_pid - current process id (Windows)
+static unsigned long
+platform_pid(void)
+{
+  return((unsigned long)GetCurrentProcessId());
+}
+
 #else // POSIX
 
 #include <sys/mman.h>
@@ -109,4 +151,77 @@ platform_munmap(void *addr, size_t size)
     munmap(addr, size);
 }
 
+// platform_file_info - query a file's size and modification time (POSIX)
+// path: filesystem path to the file
+// out_size: on success, set to the file size in bytes
+// out_mtime: on success, set to the modification time in nanoseconds
+// returns: true on success, false if the file cannot be queried
+bool
+platform_file_info(const char *path, uint64_t *out_size, int64_t *out_mtime)
+{
+  struct stat st;
+
+  if(!path || stat(path, &st) < 0)
+    return(false);
+
+  if(out_size)
+    *out_size = (uint64_t)st.st_size;
+
+  if(out_mtime)
+    *out_mtime = (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+
+  return(true);
+}
+
+// platform_replace_file - rename src over dst, replacing dst (POSIX)
+// src: file to move
+// dst: file to replace
+// returns: true on success
+static bool
+platform_replace_file(const char *src, const char *dst)
+{
+  return(rename(src, dst) == 0);
+}
+
+// platform_pid - current process id (POSIX)
+static unsigned long
+platform_pid(void)
+{
+  return((unsigned long)getpid());
+}
+
 #endif
+
+// platform_write_file - replace a file's contents in one step
+// path: filesystem path to replace
+// data: bytes to write
+// size: number of bytes
+// returns: true on success; on failure path is left as it was
+bool
+platform_write_file(const char *path, const void *data, size_t size)
+{
+  static atomic_uint counter;
+  char tmp_path[4096];
+  int n = snprintf(tmp_path, sizeof(tmp_path), "%s.%lu.%u.tmp", path,
+                   platform_pid(), atomic_fetch_add(&counter, 1));
+
+  if(n < 0 || (size_t)n >= sizeof(tmp_path))
+    return(false);
+
+  FILE *fp = fopen(tmp_path, "wb");
+
+  if(!fp)
+    return(false);
+
+  bool ok = (fwrite(data, 1, size, fp) == size);
+
+  ok = (fclose(fp) == 0) && ok;
+
+  if(!ok || !platform_replace_file(tmp_path, path))
+  {
+    remove(tmp_path);
+    return(false);
+  }
+
+  return(true);
+}
@@ -2,6 +2,8 @@
 #define PLATFORM_MMAP_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 // platform_mmap_readonly - memory-map a file for reading
 // path: filesystem path to the file
@@ -14,4 +16,20 @@ void *platform_mmap_readonly(const char *path, size_t *out_size);
 // size: size of the mapped region
 void platform_munmap(void *addr, size_t size);
 
+// platform_file_info - query a file's size and modification time
+// path: filesystem path to the file
+// out_size: on success, set to the file size in bytes
+// out_mtime: on success, set to the modification time (opaque, comparable)
+// returns: true on success, false if the file cannot be queried
+bool platform_file_info(const char *path, uint64_t *out_size, int64_t *out_mtime);
+
+// platform_write_file - replace a file's contents in one step. The data is
+// written to a temporary file named after the process and a counter, so
+// concurrent writers never share one, and then renamed over path.
+// path: filesystem path to replace
+// data: bytes to write
+// size: number of bytes
+// returns: true on success; on failure path is left as it was
+bool platform_write_file(const char *path, const void *data, size_t size);
+
 #endif
@@ -11,32 +11,9 @@ extern int tqvc_debug;
 static GThread *g_prefetch_thread;
 static volatile int g_prefetch_cancel;
 
-// interned variable name pointers — resolved once on first use
-static const char *INT_itemSkillName;
-static const char *INT_buffSkillName;
-static const char *INT_petBonusName;
-static const char *INT_itemSetName;
-static const char *INT_setMembers;
-static int g_interns_ready;
-
-// ensure_interns - resolve interned variable name pointers on first use
-static void
-ensure_interns(void)
-{
-  if(g_interns_ready)
-    return;
-
-  INT_itemSkillName = arz_intern("itemSkillName");
-  INT_buffSkillName = arz_intern("buffSkillName");
-  INT_petBonusName  = arz_intern("petBonusName");
-  INT_itemSetName   = arz_intern("itemSetName");
-  INT_setMembers    = arz_intern("setMembers");
-  g_interns_ready = 1;
-}
-
 // record_str - read a string variable from a record using interned name lookup
 // data: record data to search
-// interned: interned variable name pointer
+// interned: interned variable name pointer (INT_*)
 // returns: first string value, or NULL if not found
 static const char *
 record_str(TQArzRecordData *data, const char *interned)
@@ -126,16 +103,17 @@ prefetch_thread_func(gpointer data)
 {
   char **paths = (char **)data;
 
-  ensure_interns();
-
   for(int i = 0; paths[i] && !g_atomic_int_get(&g_prefetch_cancel); i++)
   {
+    // records may be evicted while we follow their chains
+    int token = asset_dbr_acquire();
     TQArzRecordData *rec = asset_get_dbr(paths[i]);
 
     // follow chain references for base item records
     if(rec && !g_atomic_int_get(&g_prefetch_cancel))
       follow_chains(rec);
 
+    asset_dbr_release(token);
     free(paths[i]);
   }
   free(paths);
@@ -0,0 +1,501 @@
+#include "record_cache.h"
+#include "asset_lookup.h"
+#include "platform_mmap.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#define RECORD_CACHE_VERSION 1
+
+// upper bound for the rewritten file; records decoded this session are
+// kept first, older ones fill whatever room is left
+#define RECORD_CACHE_MAX_BYTES (64u * 1024 * 1024)
+
+#pragma pack(push, 1)
+
+// RecordCacheHeader - header for tqvc-dbr-cache.bin
+// size: 32 bytes
+typedef struct {
+  char magic[4];            // "TQVD"
+  uint32_t version;         // RECORD_CACHE_VERSION
+  uint32_t num_sources;     // number of RecordCacheSource entries
+  uint32_t num_records;     // number of RecordCacheEntry entries
+  uint32_t sources_offset;  // offset to RecordCacheSource array
+  uint32_t records_offset;  // offset to RecordCacheEntry array
+  uint32_t strings_offset;  // offset to null-terminated source path strings
+  uint32_t reserved;
+} RecordCacheHeader;
+
+// RecordCacheSource - one ARZ the cached records were decoded from
+// size: 24 bytes
+typedef struct {
+  uint32_t path_offset;     // relative to strings_offset
+  uint16_t file_id;         // index file table id
+  uint16_t reserved;
+  uint64_t size;            // ARZ size at the time of caching
+  int64_t mtime;            // ARZ mtime at the time of caching
+} RecordCacheSource;
+
+// RecordCacheEntry - one decoded record, sorted by (file_id, offset)
+// size: 16 bytes
+typedef struct {
+  uint16_t file_id;         // index file table id
+  uint16_t reserved;
+  uint32_t offset;          // record offset within the ARZ
+  uint32_t data_offset;     // absolute offset of the decoded bytes (4-aligned)
+  uint32_t data_size;       // decoded record size in bytes
+} RecordCacheEntry;
+
+#pragma pack(pop)
+
+// PendingRecord - a record decoded this session, awaiting the next save
+typedef struct {
+  uint64_t key;             // (file_id << 32) | offset
+  uint32_t size;
+  uint8_t bytes[];
+} PendingRecord;
+
+// SaveItem - one record selected for the rewritten cache file
+typedef struct {
+  uint64_t key;
+  const uint8_t *bytes;
+  uint32_t size;
+} SaveItem;
+
+static char *g_cache_path = NULL;
+static char *g_game_path = NULL;
+static uint8_t *g_map = NULL;
+static size_t g_map_size = 0;
+static const RecordCacheEntry *g_entries = NULL;
+static uint32_t g_num_entries = 0;
+static GHashTable *g_pending = NULL;  // &key -> PendingRecord*
+static GMutex g_pending_mutex;
+static int g_hits = 0;
+
+// make_key - combine a file id and record offset into one sort key
+// file_id: index file table id
+// offset: record offset within the ARZ
+// returns: 64-bit key
+static uint64_t
+make_key(uint16_t file_id, uint32_t offset)
+{
+  return(((uint64_t)file_id << 32) | offset);
+}
+
+// source_matches - check a cached source against the current install
+// src: source entry from the mapped cache
+// strings: start of the mapped path string table
+// strings_size: bytes available in the string table
+// returns: true if the same ARZ is still present, unchanged
+static bool
+source_matches(const RecordCacheSource *src, const char *strings, size_t strings_size)
+{
+  if(src->path_offset >= strings_size)
+    return(false);
+
+  const char *path = strings + src->path_offset;
+
+  if(!memchr(path, '\0', strings_size - src->path_offset))
+    return(false);
+
+  const char *current = asset_get_file_path(src->file_id);
+
+  if(!current || strcmp(current, path) != 0)
+    return(false);
+
+  char *full_path = g_build_filename(g_game_path, current, NULL);
+  uint64_t size = 0;
+  int64_t mtime = 0;
+  bool ok = platform_file_info(full_path, &size, &mtime);
+
+  g_free(full_path);
+  return(ok && size == src->size && mtime == src->mtime);
+}
+
+// record_cache_validate - check the mapped file's structure and sources
+// returns: true if the mapped cache can be served from
+static bool
+record_cache_validate(void)
+{
+  if(g_map_size < sizeof(RecordCacheHeader))
+    return(false);
+
+  const RecordCacheHeader *h = (const RecordCacheHeader *)g_map;
+
+  if(memcmp(h->magic, "TQVD", 4) != 0 || h->version != RECORD_CACHE_VERSION)
+    return(false);
+
+  if((uint64_t)h->sources_offset + (uint64_t)h->num_sources * sizeof(RecordCacheSource) > g_map_size ||
+     (uint64_t)h->records_offset + (uint64_t)h->num_records * sizeof(RecordCacheEntry) > g_map_size ||
+     h->strings_offset > g_map_size)
+    return(false);
+
+  const RecordCacheSource *sources = (const RecordCacheSource *)(g_map + h->sources_offset);
+  const char *strings = (const char *)g_map + h->strings_offset;
+
+  for(uint32_t i = 0; i < h->num_sources; i++)
+  {
+    if(!source_matches(&sources[i], strings, g_map_size - h->strings_offset))
+      return(false);
+  }
+
+  const RecordCacheEntry *entries = (const RecordCacheEntry *)(g_map + h->records_offset);
+
+  for(uint32_t i = 0; i < h->num_records; i++)
+  {
+    if((uint64_t)entries[i].data_offset + entries[i].data_size > g_map_size ||
+       (entries[i].data_offset & 3) != 0)
+      return(false);
+  }
+
+  g_entries = entries;
+  g_num_entries = h->num_records;
+  return(true);
+}
+
+// record_cache_open - map and validate the persistent record cache
+// cache_path: filesystem path to the cache file
+// game_path: root path to the game installation (source ARZ checks)
+// returns: true if a valid cache was mapped, false if starting empty
+bool
+record_cache_open(const char *cache_path, const char *game_path)
+{
+  record_cache_close();
+
+  g_cache_path = g_strdup(cache_path);
+  g_game_path = g_strdup(game_path);
+  g_pending = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, free);
+  g_hits = 0;
+
+  g_map = platform_mmap_readonly(cache_path, &g_map_size);
+
+  if(!g_map)
+    return(false);
+
+  if(!record_cache_validate())
+  {
+    fprintf(stderr, "record_cache_open: %s is stale or invalid, starting empty\n", cache_path);
+    platform_munmap(g_map, g_map_size);
+    g_map = NULL;
+    g_map_size = 0;
+    g_entries = NULL;
+    g_num_entries = 0;
+    return(false);
+  }
+
+  if(tqvc_debug)
+    printf("record_cache_open: %u decoded records mapped from %s\n", g_num_entries, cache_path);
+
+  return(true);
+}
+
+// find_entry - binary search the mapped entries for a record
+// key: (file_id << 32) | offset
+// returns: matching entry, or NULL if not cached
+static const RecordCacheEntry *
+find_entry(uint64_t key)
+{
+  uint32_t low = 0;
+  uint32_t high = g_num_entries;
+
+  while(low < high)
+  {
+    uint32_t mid = low + (high - low) / 2;
+    uint64_t mid_key = make_key(g_entries[mid].file_id, g_entries[mid].offset);
+
+    if(mid_key == key)
+      return(&g_entries[mid]);
+
+    if(mid_key < key)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return(NULL);
+}
+
+// record_cache_get - build a record from the persistent cache (zero-copy)
+// arz: database file the record belongs to (for its string table)
+// file_id: index file table id of the ARZ
+// offset: record offset within the ARZ (TQAssetEntry.offset)
+// returns: parsed record borrowing the mapped bytes, or NULL if not cached
+TQArzRecordData *
+record_cache_get(TQArzFile *arz, uint16_t file_id, uint32_t offset)
+{
+  if(!g_map || !arz)
+    return(NULL);
+
+  const RecordCacheEntry *e = find_entry(make_key(file_id, offset));
+
+  if(!e)
+    return(NULL);
+
+  TQArzRecordData *data = arz_record_parse(arz, g_map + e->data_offset, e->data_size, false);
+
+  if(data)
+    g_atomic_int_inc(&g_hits);
+
+  return(data);
+}
+
+// record_cache_note - remember a freshly decoded record for the next save
+// file_id: index file table id of the ARZ
+// offset: record offset within the ARZ (TQAssetEntry.offset)
+// data: decoded record (its raw bytes are copied)
+void
+record_cache_note(uint16_t file_id, uint32_t offset, const TQArzRecordData *data)
+{
+  if(!g_pending || !data || !data->raw || data->raw_size == 0)
+    return;
+
+  uint64_t key = make_key(file_id, offset);
+
+  if(g_map && find_entry(key))
+    return;
+
+  g_mutex_lock(&g_pending_mutex);
+
+  if(!g_hash_table_contains(g_pending, &key))
+  {
+    PendingRecord *p = malloc(sizeof(PendingRecord) + data->raw_size);
+
+    if(p)
+    {
+      p->key = key;
+      p->size = data->raw_size;
+      memcpy(p->bytes, data->raw, data->raw_size);
+      g_hash_table_insert(g_pending, &p->key, p);
+    }
+  }
+
+  g_mutex_unlock(&g_pending_mutex);
+}
+
+// compare_save_items - qsort comparator for SaveItem by key
+// a: pointer to first SaveItem
+// b: pointer to second SaveItem
+// returns: negative, zero, or positive
+static int
+compare_save_items(const void *a, const void *b)
+{
+  const SaveItem *s1 = a;
+  const SaveItem *s2 = b;
+
+  if(s1->key < s2->key)
+    return(-1);
+
+  return(s1->key > s2->key ? 1 : 0);
+}
+
+// write_padding - pad the output file to a 4-byte boundary
+// fp: output file
+// pos: current write position (updated)
+static void
+write_padding(FILE *fp, uint32_t *pos)
+{
+  static const uint8_t zeros[4] = {0};
+  uint32_t pad = (4 - (*pos & 3)) & 3;
+
+  fwrite(zeros, 1, pad, fp);
+  *pos += pad;
+}
+
+// record_cache_write - write the merged cache to a temporary file
+// tmp_path: filesystem path to write
+// returns: true on success
+static bool
+record_cache_write(const char *tmp_path)
+{
+  uint32_t max_items = g_hash_table_size(g_pending) + g_num_entries;
+  SaveItem *items = malloc((size_t)max_items * sizeof(SaveItem));
+
+  if(!items)
+    return(false);
+
+  uint32_t n = 0;
+  uint64_t total = 0;
+  GHashTableIter iter;
+  gpointer k, v;
+
+  // this session's records first, then older ones while they fit
+  g_hash_table_iter_init(&iter, g_pending);
+
+  while(g_hash_table_iter_next(&iter, &k, &v))
+  {
+    PendingRecord *p = v;
+
+    if(total + p->size > RECORD_CACHE_MAX_BYTES)
+      continue;
+
+    items[n].key = p->key;
+    items[n].bytes = p->bytes;
+    items[n].size = p->size;
+    total += p->size;
+    n++;
+  }
+
+  for(uint32_t i = 0; i < g_num_entries; i++)
+  {
+    if(total + g_entries[i].data_size > RECORD_CACHE_MAX_BYTES)
+      break;
+
+    items[n].key = make_key(g_entries[i].file_id, g_entries[i].offset);
+    items[n].bytes = g_map + g_entries[i].data_offset;
+    items[n].size = g_entries[i].data_size;
+    total += g_entries[i].data_size;
+    n++;
+  }
+
+  qsort(items, n, sizeof(SaveItem), compare_save_items);
+
+  // distinct source files, in file_id order thanks to the sort
+  uint16_t *file_ids = malloc((size_t)(n ? n : 1) * sizeof(uint16_t));
+  uint32_t num_sources = 0;
+
+  if(!file_ids)
+  {
+    free(items);
+    return(false);
+  }
+
+  for(uint32_t i = 0; i < n; i++)
+  {
+    uint16_t fid = (uint16_t)(items[i].key >> 32);
+
+    if(num_sources == 0 || file_ids[num_sources - 1] != fid)
+      file_ids[num_sources++] = fid;
+  }
+
+  FILE *fp = fopen(tmp_path, "wb");
+
+  if(!fp)
+  {
+    fprintf(stderr, "record_cache_write: fopen(%s, wb) failed: %s\n", tmp_path, strerror(errno));
+    free(file_ids);
+    free(items);
+    return(false);
+  }
+
+  RecordCacheSource *sources = calloc(num_sources ? num_sources : 1, sizeof(RecordCacheSource));
+  GString *strings = g_string_new(NULL);
+  bool ok = (sources != NULL);
+
+  for(uint32_t i = 0; ok && i < num_sources; i++)
+  {
+    const char *rel = asset_get_file_path(file_ids[i]);
+    char *full_path = rel ? g_build_filename(g_game_path, rel, NULL) : NULL;
+
+    sources[i].file_id = file_ids[i];
+    sources[i].path_offset = (uint32_t)strings->len;
+    ok = full_path && platform_file_info(full_path, &sources[i].size, &sources[i].mtime);
+    g_free(full_path);
+
+    if(ok)
+      g_string_append_len(strings, rel, (gssize)strlen(rel) + 1);
+  }
+
+  RecordCacheHeader header;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "TQVD", 4);
+  header.version = RECORD_CACHE_VERSION;
+  header.num_sources = num_sources;
+  header.num_records = n;
+  header.sources_offset = sizeof(RecordCacheHeader);
+  header.records_offset = header.sources_offset + num_sources * (uint32_t)sizeof(RecordCacheSource);
+  header.strings_offset = header.records_offset + n * (uint32_t)sizeof(RecordCacheEntry);
+
+  uint32_t data_pos = header.strings_offset + (uint32_t)strings->len;
+
+  data_pos = (data_pos + 3) & ~3u;
+
+  if(ok)
+  {
+    fwrite(&header, sizeof(header), 1, fp);
+    fwrite(sources, sizeof(RecordCacheSource), num_sources, fp);
+
+    for(uint32_t i = 0; i < n; i++)
+    {
+      RecordCacheEntry e;
+
+      e.file_id = (uint16_t)(items[i].key >> 32);
+      e.reserved = 0;
+      e.offset = (uint32_t)items[i].key;
+      e.data_offset = data_pos;
+      e.data_size = items[i].size;
+      fwrite(&e, sizeof(e), 1, fp);
+      data_pos = (data_pos + items[i].size + 3) & ~3u;
+    }
+
+    uint32_t pos = header.strings_offset;
+
+    fwrite(strings->str, 1, strings->len, fp);
+    pos += (uint32_t)strings->len;
+    write_padding(fp, &pos);
+
+    for(uint32_t i = 0; i < n; i++)
+    {
+      fwrite(items[i].bytes, 1, items[i].size, fp);
+      pos += items[i].size;
+      write_padding(fp, &pos);
+    }
+  }
+
+  if(fclose(fp) != 0)
+    ok = false;
+
+  if(tqvc_debug)
+    printf("record_cache_write: %u records (%u new, %d served from cache this session)\n",
+           n, g_hash_table_size(g_pending), g_atomic_int_get(&g_hits));
+
+  g_string_free(strings, TRUE);
+  free(sources);
+  free(file_ids);
+  free(items);
+  return(ok);
+}
+
+// record_cache_close - write the merged cache if anything new was decoded,
+// then unmap it. Records returned by record_cache_get() must be freed first.
+void
+record_cache_close(void)
+{
+  char *tmp_path = NULL;
+  bool wrote = false;
+
+  if(g_pending && g_cache_path && g_hash_table_size(g_pending) > 0)
+  {
+    tmp_path = g_strconcat(g_cache_path, ".tmp", NULL);
+    wrote = record_cache_write(tmp_path);
+  }
+
+  // the mapping must be gone before the rename on Windows
+  if(g_map)
+    platform_munmap(g_map, g_map_size);
+
+  if(tmp_path)
+  {
+    if(!wrote || g_rename(tmp_path, g_cache_path) != 0)
+      g_unlink(tmp_path);
+
+    g_free(tmp_path);
+  }
+
+  if(g_pending)
+    g_hash_table_destroy(g_pending);
+
+  g_map = NULL;
+  g_map_size = 0;
+  g_entries = NULL;
+  g_num_entries = 0;
+  g_pending = NULL;
+  g_free(g_cache_path);
+  g_free(g_game_path);
+  g_cache_path = NULL;
+  g_game_path = NULL;
+}
@@ -0,0 +1,38 @@
+#ifndef RECORD_CACHE_H
+#define RECORD_CACHE_H
+
+#include "arz.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// The record cache persists already-decoded DBR records between launches
+// (tqvc-dbr-cache.bin next to the resource index). Records are stored in
+// their decoded ARZ var layout -- a flat, relocatable block of var headers
+// and 4-byte values that reference names and strings by ARZ string-table
+// index -- so serving one is a parse over the mmap instead of an inflate.
+// The whole file is discarded when any source ARZ changes size or mtime.
+
+// record_cache_open - map and validate the persistent record cache
+// cache_path: filesystem path to the cache file
+// game_path: root path to the game installation (source ARZ checks)
+// returns: true if a valid cache was mapped, false if starting empty
+bool record_cache_open(const char *cache_path, const char *game_path);
+
+// record_cache_get - build a record from the persistent cache (zero-copy)
+// arz: database file the record belongs to (for its string table)
+// file_id: index file table id of the ARZ
+// offset: record offset within the ARZ (TQAssetEntry.offset)
+// returns: parsed record borrowing the mapped bytes, or NULL if not cached
+TQArzRecordData *record_cache_get(TQArzFile *arz, uint16_t file_id, uint32_t offset);
+
+// record_cache_note - remember a freshly decoded record for the next save
+// file_id: index file table id of the ARZ
+// offset: record offset within the ARZ (TQAssetEntry.offset)
+// data: decoded record (its raw bytes are copied)
+void record_cache_note(uint16_t file_id, uint32_t offset, const TQArzRecordData *data);
+
+// record_cache_close - write the merged cache if anything new was decoded,
+// then unmap it. Records returned by record_cache_get() must be freed first.
+void record_cache_close(void);
+
+#endif
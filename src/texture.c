@@ -5,6 +5,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+
+// User data keys for texture surfaces: the pixel buffer a surface wraps,
+// the texture's level 0 size, and the two most recent scaled copies made
+// by texture_paint() (an item is usually drawn at two sizes: in its
+// container and under the cursor).
+static cairo_user_data_key_t pixels_key;
+static cairo_user_data_key_t base_size_key;
+static cairo_user_data_key_t scaled_keys[2];
 
 static void
 pixbuf_free_pixels(guchar *pixels, gpointer user_data)
@@ -13,40 +22,79 @@ pixbuf_free_pixels(guchar *pixels, gpointer user_data)
   free(pixels);
 }
 
-// normalize_path - convert forward slashes to backslashes for ARC path matching
-// path: input path string
-// returns: newly allocated string with normalized separators (caller must free)
-static char *
-normalize_path(const char *path)
+// TextureScratch - per-thread buffer that compressed textures are inflated
+// into, so the UI thread and each icon worker reuse one allocation
+typedef struct {
+  uint8_t *data;
+  size_t size;
+} TextureScratch;
+
+// textures above this size are inflated into a buffer of their own rather
+// than growing a scratch buffer that every thread would then keep
+#define TEXTURE_SCRATCH_MAX (4u << 20)
+
+static void
+texture_scratch_free(gpointer data)
 {
-  char *res = strdup(path);
+  TextureScratch *scratch = data;
+
+  free(scratch->data);
+  free(scratch);
+}
 
-  if(!res)
+static GPrivate scratch_key = G_PRIVATE_INIT(texture_scratch_free);
+
+// texture_scratch - get this thread's inflate buffer
+// size: bytes needed
+// out_size: receives the buffer size
+// returns: buffer of at least size bytes, or NULL if size is too large or
+//          allocation failed (arc_view_*() then allocate their own)
+static uint8_t *
+texture_scratch(size_t size, size_t *out_size)
+{
+  *out_size = 0;
+
+  if(size > TEXTURE_SCRATCH_MAX)
     return(NULL);
 
-  for(int i = 0; res[i]; i++)
+  TextureScratch *scratch = g_private_get(&scratch_key);
+
+  if(!scratch)
+  {
+    scratch = calloc(1, sizeof(TextureScratch));
+    if(!scratch)
+      return(NULL);
+    g_private_set(&scratch_key, scratch);
+  }
+
+  if(scratch->size < size)
   {
-    if(res[i] == '/')
-      res[i] = '\\';
+    // grow in one step to the largest size likely to be needed
+    size_t grown = size < 256 * 1024 ? 256 * 1024 : size;
+    uint8_t *data = malloc(grown);
+
+    if(!data)
+      return(NULL);
+
+    free(scratch->data);
+    scratch->data = data;
+    scratch->size = grown;
   }
-  return(res);
+
+  *out_size = scratch->size;
+  return(scratch->data);
 }
 
-// texture_load_from_data - decode raw TEX/DDS data into a GdkPixbuf
-// raw_data: raw TEX file bytes (ownership transferred, freed by this function)
+// texture_dds_data - find the DDS blob inside raw TEX data
+// raw_data: raw TEX file bytes
 // raw_size: size of raw_data in bytes
-// returns: GdkPixbuf or NULL on failure
-static GdkPixbuf *
-texture_load_from_data(uint8_t *raw_data, size_t raw_size)
+// dds_size: receives the size of the DDS blob
+// returns: pointer into raw_data, or NULL if the data is too short
+static const uint8_t *
+texture_dds_data(const uint8_t *raw_data, size_t raw_size, size_t *dds_size)
 {
-  if(tqvc_debug)
-    printf("texture_load_from_data: size=%zu\n", raw_size);
-
   if(raw_size < 13)
-  {
-    free(raw_data);
     return(NULL);
-  }
 
   int header_size = 12;
 
@@ -57,92 +105,394 @@ texture_load_from_data(uint8_t *raw_data, size_t raw_size)
   }
 
   if(raw_size < (size_t)header_size + 4)
-  {
-    free(raw_data);
     return(NULL);
-  }
 
-  // skip TEX header to get to DDS
-  uint8_t *dds_data = raw_data + header_size;
-  size_t dds_size = raw_size - header_size;
+  // skip TEX header to get to DDS ("DDSR" magic is accepted by the decoder)
+  *dds_size = raw_size - header_size;
+  return(raw_data + header_size);
+}
 
-  // .tex files commonly use the variant magic "DDSR" instead of "DDS ";
-  // normalise so dds_decode() recognises it.
-  if(dds_size >= 4 && memcmp(dds_data, "DDSR", 4) == 0)
-    dds_data[3] = ' ';
+// texture_decode_data - decode raw TEX/DDS data into RGBA8 pixels
+// raw_data: raw TEX file bytes (not modified; may point into an archive mapping)
+// raw_size: size of raw_data in bytes
+// level: mip level to decode (0 = full size)
+// out_width: receives the decoded width
+// out_height: receives the decoded height
+// out_base: if non-NULL, receives the level 0 width and height
+// returns: malloc'd RGBA8 pixels (caller frees), or NULL on failure
+static uint8_t *
+texture_decode_data(const uint8_t *raw_data, size_t raw_size, unsigned level,
+                    uint32_t *out_width, uint32_t *out_height, uint32_t out_base[2])
+{
+  if(tqvc_debug)
+    printf("texture_load_from_data: size=%zu\n", raw_size);
 
+  size_t dds_size;
+  const uint8_t *dds_data = texture_dds_data(raw_data, raw_size, &dds_size);
+
+  if(!dds_data)
+    return(NULL);
+
+  uint8_t *pixels = dds_decode_level(dds_data, dds_size, level, out_width, out_height);
+
+  if(pixels && out_base)
+    dds_get_size(dds_data, dds_size, &out_base[0], &out_base[1]);
+
+  if(!pixels && tqvc_debug)
+    fprintf(stderr, "dds_decode: failed (size=%zu)\n", dds_size);
+
+  return(pixels);
+}
+
+// texture_load_from_data - decode raw TEX/DDS data into a GdkPixbuf
+// raw_data: raw TEX file bytes
+// raw_size: size of raw_data in bytes
+// returns: GdkPixbuf or NULL on failure
+static GdkPixbuf *
+texture_load_from_data(const uint8_t *raw_data, size_t raw_size)
+{
   uint32_t width = 0;
   uint32_t height = 0;
-  uint8_t *pixels = dds_decode(dds_data, dds_size, &width, &height);
+  uint8_t *pixels = texture_decode_data(raw_data, raw_size, 0, &width, &height, NULL);
+
+  if(!pixels)
+    return(NULL);
 
-  GdkPixbuf *pixbuf = NULL;
+  return(gdk_pixbuf_new_from_data(pixels, GDK_COLORSPACE_RGB, TRUE, 8,
+      (int)width, (int)height, (int)width * 4,
+      pixbuf_free_pixels, NULL));
+}
 
-  if(pixels)
+// texture_surface_from_data - decode raw TEX/DDS data into a premultiplied
+// ARGB32 cairo image surface that owns its pixel buffer
+// raw_data: raw TEX file bytes
+// raw_size: size of raw_data in bytes
+// level: mip level to decode (0 = full size)
+// returns: new surface, or NULL on failure
+static cairo_surface_t *
+texture_surface_from_data(const uint8_t *raw_data, size_t raw_size, unsigned level)
+{
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t *base = malloc(2 * sizeof(uint32_t));
+
+  if(!base)
+    return(NULL);
+
+  uint8_t *pixels = texture_decode_data(raw_data, raw_size, level, &width, &height, base);
+
+  if(!pixels)
   {
-    pixbuf = gdk_pixbuf_new_from_data(pixels, GDK_COLORSPACE_RGB, TRUE, 8,
-        (int)width, (int)height, (int)width * 4,
-        pixbuf_free_pixels, NULL);
+    free(base);
+    return(NULL);
   }
-  else if(tqvc_debug)
+
+  // ARGB32 rows are always 4-byte aligned, so the stride is width * 4 and
+  // the decoder's buffer can be used as-is
+  dds_rgba_to_argb32_premultiplied(pixels, (size_t)width * height);
+
+  cairo_surface_t *surface = cairo_image_surface_create_for_data(pixels,
+      CAIRO_FORMAT_ARGB32, (int)width, (int)height, (int)width * 4);
+
+  if(cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS ||
+     cairo_surface_set_user_data(surface, &pixels_key, pixels, free) != CAIRO_STATUS_SUCCESS)
   {
-    fprintf(stderr, "dds_decode: failed (size=%zu)\n", dds_size);
+    cairo_surface_destroy(surface);
+    free(pixels);
+    free(base);
+    return(NULL);
+  }
+
+  if(cairo_surface_set_user_data(surface, &base_size_key, base, free) != CAIRO_STATUS_SUCCESS)
+    free(base);
+
+  return(surface);
+}
+
+// texture_extract - get a texture's raw TEX bytes using the global asset
+// index. Stored textures are borrowed from the archive mapping; compressed
+// ones are inflated into this thread's scratch buffer.
+// tex_path: normalized game path to the texture
+// diag: log the outcome of this attempt
+// attempt: attempt number shown in the log
+// view: receives the TEX bytes (release with arc_view_release())
+// returns: true on success
+static bool
+texture_extract(const char *tex_path, bool diag, int attempt, TQArcView *view)
+{
+  const TQAssetEntry *entry = asset_lookup(tex_path);
+
+  if(!entry)
+  {
+    if(diag)
+      fprintf(stderr, "texture_load[%d]: asset_lookup(%s) = NULL\n", attempt, tex_path);
+    return(false);
   }
 
-  free(raw_data);
-  return(pixbuf);
+  size_t buf_size;
+  uint8_t *buf = texture_scratch(entry->real_size, &buf_size);
+  bool ok = asset_view_file(entry, buf, buf_size, view);
+
+  if(!ok && diag)
+    fprintf(stderr, "texture_load[%d]: asset_view_file failed (file_id=%u offset=%u sz=%u real=%u parts=%s) for %s\n",
+            attempt, entry->file_id, entry->offset, entry->size, entry->real_size,
+            entry->aux ? "several" : "one", tex_path);
+
+  return(ok);
 }
 
+// First-call diagnostic: log the first few attempts (success or failure)
+// unconditionally so Windows users can debug without --debug. Icons are
+// also loaded on worker threads, so the counter is atomic.
+static int diag_count = 0;
+
 // texture_load - load a texture using the global asset index
 // tex_path: normalized game path to the texture
 // returns: GdkPixbuf or NULL on failure
 GdkPixbuf *
 texture_load(const char *tex_path)
 {
-  // First-call diagnostic: log the first few attempts (success or failure)
-  // unconditionally so Windows users can debug without --debug.
-  static int diag_count = 0;
-  bool diag = (diag_count < 5);
+  int attempt = g_atomic_int_add(&diag_count, 1) + 1;
+  bool diag = (attempt <= 5);
+
+  TQArcView view;
+
+  if(!texture_extract(tex_path, diag, attempt, &view))
+    return(NULL);
+
+  GdkPixbuf *pb = texture_load_from_data(view.data, view.size);
+
+  arc_view_release(&view);
 
   if(diag)
-    diag_count++;
+    fprintf(stderr, "texture_load[%d]: %s for %s\n",
+            attempt, pb ? "OK" : "decode-FAILED", tex_path);
 
-  const TQAssetEntry *entry = asset_lookup(tex_path);
+  return(pb);
+}
 
-  if(!entry)
-  {
-    if(diag)
-      fprintf(stderr, "texture_load[%d]: asset_lookup(%s) = NULL\n", diag_count, tex_path);
+// texture_load_surface - load a texture as a premultiplied ARGB32 surface
+// tex_path: normalized game path to the texture
+// level: mip level to decode (0 = full size)
+// returns: new cairo image surface (caller destroys), or NULL on failure
+cairo_surface_t *
+texture_load_surface(const char *tex_path, unsigned level)
+{
+  int attempt = g_atomic_int_add(&diag_count, 1) + 1;
+  bool diag = (attempt <= 5);
+
+  TQArcView view;
+
+  if(!texture_extract(tex_path, diag, attempt, &view))
     return(NULL);
+
+  cairo_surface_t *surface = texture_surface_from_data(view.data, view.size, level);
+
+  arc_view_release(&view);
+
+  if(diag)
+    fprintf(stderr, "texture_load[%d]: %s for %s\n",
+            attempt, surface ? "OK" : "decode-FAILED", tex_path);
+
+  return(surface);
+}
+
+// texture_base_size - get the level 0 size of a texture surface
+// surface: surface from texture_load_surface()
+// width: receives the width in texels
+// height: receives the height in texels
+void
+texture_base_size(cairo_surface_t *surface, int *width, int *height)
+{
+  const uint32_t *base = cairo_surface_get_user_data(surface, &base_size_key);
+
+  if(base)
+  {
+    *width = (int)base[0];
+    *height = (int)base[1];
+  }
+  else
+  {
+    *width = cairo_image_surface_get_width(surface);
+    *height = cairo_image_surface_get_height(surface);
   }
+}
 
-  TQArcFile *arc = asset_get_arc(entry->file_id);
+// texture_set_base_size - record the level 0 size of a texture surface
+// surface: texture surface not made by texture_load_surface()
+// width: level 0 width in texels
+// height: level 0 height in texels
+void
+texture_set_base_size(cairo_surface_t *surface, int width, int height)
+{
+  uint32_t *base = malloc(2 * sizeof(uint32_t));
 
-  if(!arc)
+  if(!base)
+    return;
+
+  base[0] = (uint32_t)width;
+  base[1] = (uint32_t)height;
+
+  if(cairo_surface_set_user_data(surface, &base_size_key, base, free) != CAIRO_STATUS_SUCCESS)
+    free(base);
+}
+
+// texture_get_size - read a texture's level 0 size from its DDS header
+// tex_path: normalized game path to the texture
+// width: receives the width in texels
+// height: receives the height in texels
+// returns: true on success
+bool
+texture_get_size(const char *tex_path, int *width, int *height)
+{
+  TQArcView view;
+
+  if(!texture_extract(tex_path, false, 0, &view))
+    return(false);
+
+  size_t dds_size;
+  const uint8_t *dds_data = texture_dds_data(view.data, view.size, &dds_size);
+  uint32_t w, h;
+  bool ok = dds_data && dds_get_size(dds_data, dds_size, &w, &h);
+
+  arc_view_release(&view);
+
+  if(!ok)
+    return(false);
+
+  *width = (int)w;
+  *height = (int)h;
+  return(true);
+}
+
+// texture_level_for_scale - pick the mip level for display at a scale
+// scale: display pixels per level 0 texel
+// returns: the smallest level still at least as large as the display size
+unsigned
+texture_level_for_scale(double scale)
+{
+  unsigned level = 0;
+
+  while(level < 15 && scale > 0.0 && scale <= 0.5)
   {
-    if(diag)
-      fprintf(stderr, "texture_load[%d]: asset_get_arc(file_id=%u) = NULL for %s\n",
-              diag_count, entry->file_id, tex_path);
+    scale *= 2.0;
+    level++;
+  }
+
+  return(level);
+}
+
+// texture_scaled_copy - get a copy of a texture surface at a given size,
+// reusing one of the copies cached on the surface when the size matches
+// surface: source texture surface
+// width: target width in pixels
+// height: target height in pixels
+// returns: surface owned by the source (do not destroy), or NULL on failure
+static cairo_surface_t *
+texture_scaled_copy(cairo_surface_t *surface, int width, int height)
+{
+  for(int i = 0; i < 2; i++)
+  {
+    cairo_surface_t *copy = cairo_surface_get_user_data(surface, &scaled_keys[i]);
+
+    if(copy && cairo_image_surface_get_width(copy) == width &&
+       cairo_image_surface_get_height(copy) == height)
+      return(copy);
+  }
+
+  cairo_surface_t *scaled = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+
+  if(cairo_surface_status(scaled) != CAIRO_STATUS_SUCCESS)
+  {
+    cairo_surface_destroy(scaled);
     return(NULL);
   }
 
-  size_t raw_size;
-  uint8_t *raw_data = arc_extract_file_at(arc, entry->offset, entry->size, entry->real_size, &raw_size);
+  cairo_t *cr = cairo_create(scaled);
 
-  if(!raw_data)
+  cairo_scale(cr, width / (double)cairo_image_surface_get_width(surface),
+              height / (double)cairo_image_surface_get_height(surface));
+  cairo_set_source_surface(cr, surface, 0, 0);
+  cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_PAD);
+  cairo_paint(cr);
+  cairo_destroy(cr);
+
+  // the newest copy goes in slot 0, the previous one moves to slot 1
+  cairo_surface_t *prev = cairo_surface_get_user_data(surface, &scaled_keys[0]);
+
+  if(prev)
   {
-    if(diag)
-      fprintf(stderr, "texture_load[%d]: arc_extract_file_at failed (offset=%u sz=%u real=%u) for %s\n",
-              diag_count, entry->offset, entry->size, entry->real_size, tex_path);
+    cairo_surface_reference(prev);
+
+    if(cairo_surface_set_user_data(surface, &scaled_keys[1], prev,
+                                   (cairo_destroy_func_t)cairo_surface_destroy) != CAIRO_STATUS_SUCCESS)
+      cairo_surface_destroy(prev);
+  }
+
+  if(cairo_surface_set_user_data(surface, &scaled_keys[0], scaled,
+                                 (cairo_destroy_func_t)cairo_surface_destroy) != CAIRO_STATUS_SUCCESS)
+  {
+    cairo_surface_destroy(scaled);
     return(NULL);
   }
 
-  GdkPixbuf *pb = texture_load_from_data(raw_data, raw_size);
+  return(scaled);
+}
 
-  if(diag)
-    fprintf(stderr, "texture_load[%d]: %s for %s\n",
-            diag_count, pb ? "OK" : "decode-FAILED", tex_path);
+// texture_paint - paint a texture surface into a pixel rectangle
+// cr: cairo context
+// surface: surface from texture_load_surface()
+// x: left edge of the destination rectangle
+// y: top edge of the destination rectangle
+// width: destination width in pixels
+// height: destination height in pixels
+// alpha: opacity (1.0 for opaque)
+void
+texture_paint(cairo_t *cr, cairo_surface_t *surface,
+              double x, double y, double width, double height, double alpha)
+{
+  // work in device pixels so HiDPI outputs get a full-resolution copy
+  double fx = 1.0;
+  double fy = 1.0;
 
-  return(pb);
+  cairo_user_to_device_distance(cr, &fx, &fy);
+  fx = fabs(fx);
+  fy = fabs(fy);
+
+  if(!surface || fx <= 0.0 || fy <= 0.0)
+    return;
+
+  // snap to whole device pixels so the cached copy is blitted without resampling
+  long px = lround(x * fx);
+  long py = lround(y * fy);
+  int pw = (int)(lround((x + width) * fx) - px);
+  int ph = (int)(lround((y + height) * fy) - py);
+  int sw = cairo_image_surface_get_width(surface);
+  int sh = cairo_image_surface_get_height(surface);
+
+  if(pw <= 0 || ph <= 0 || sw <= 0 || sh <= 0)
+    return;
+
+  cairo_surface_t *source = surface;
+
+  if(pw != sw || ph != sh)
+    source = texture_scaled_copy(surface, pw, ph);
+
+  // draw in device pixel units from the snapped corner
+  cairo_save(cr);
+  cairo_translate(cr, px / fx, py / fy);
+  cairo_scale(cr, 1.0 / fx, 1.0 / fy);
+
+  if(!source)
+  {
+    // no cached copy could be kept: scale while drawing
+    cairo_scale(cr, pw / (double)sw, ph / (double)sh);
+    source = surface;
+  }
+
+  cairo_set_source_surface(cr, source, 0, 0);
+  cairo_paint_with_alpha(cr, alpha);
+  cairo_restore(cr);
 }
 
 // texture_load_from_arc - load a .tex file from an ARC archive by path
@@ -155,22 +505,7 @@ texture_load_from_arc(TQArcFile *arc, const char *tex_path)
   if(!arc)
     return(NULL);
 
-  char *target = normalize_path(tex_path);
-  int entry_index = -1;
-
-  for(uint32_t i = 0; i < arc->num_files; i++)
-  {
-    char *entry_norm = normalize_path(arc->entries[i].path);
-
-    if(strcasecmp(entry_norm, target) == 0)
-    {
-      entry_index = (int)i;
-      free(entry_norm);
-      break;
-    }
-    free(entry_norm);
-  }
-  free(target);
+  int entry_index = arc_find(arc, tex_path);
 
   if(entry_index == -1)
   {
@@ -193,13 +528,17 @@ texture_load_by_index(TQArcFile *arc, uint32_t index)
   if(!arc || index >= arc->num_files)
     return(NULL);
 
-  size_t raw_size;
-  uint8_t *raw_data = arc_extract_file(arc, index, &raw_size);
+  size_t buf_size;
+  uint8_t *buf = texture_scratch(arc->entries[index].real_size, &buf_size);
+  TQArcView view;
 
-  if(!raw_data)
+  if(!arc_view_file(arc, index, buf, buf_size, &view))
     return(NULL);
 
-  return(texture_load_from_data(raw_data, raw_size));
+  GdkPixbuf *pb = texture_load_from_data(view.data, view.size);
+
+  arc_view_release(&view);
+  return(pb);
 }
 
 // texture_create_with_number - create a new pixbuf with a number drawn on it
@@ -21,6 +21,54 @@ GdkPixbuf *texture_load_by_index(TQArcFile *arc, uint32_t index);
 // returns: GdkPixbuf or NULL on failure
 GdkPixbuf *texture_load(const char *tex_path);
 
+// texture_load_surface - load a texture using the asset index, decoded once
+// into a premultiplied native-endian ARGB32 cairo image surface so drawing
+// needs no per-frame pixel conversion. Only the requested mip level is
+// decoded, so icons shown small cost a fraction of the full-size decode.
+// tex_path: normalized game path to the texture
+// level: mip level to decode (0 = full size; each level halves both sides)
+// returns: new surface (caller destroys), or NULL on failure
+cairo_surface_t *texture_load_surface(const char *tex_path, unsigned level);
+
+// texture_base_size - get the level 0 size of a texture surface, whatever
+// level was decoded
+// surface: surface from texture_load_surface()
+// width: receives the width in texels
+// height: receives the height in texels
+void texture_base_size(cairo_surface_t *surface, int *width, int *height);
+
+// texture_set_base_size - record the level 0 size of a texture surface that
+// was not made by texture_load_surface(), e.g. one served from the icon cache
+// surface: texture surface
+// width: level 0 width in texels
+// height: level 0 height in texels
+void texture_set_base_size(cairo_surface_t *surface, int width, int height);
+
+// texture_get_size - read a texture's level 0 size from its header without
+// decoding any pixels
+// tex_path: normalized game path to the texture
+// width: receives the width in texels
+// height: receives the height in texels
+// returns: true on success, false if the texture cannot be read
+bool texture_get_size(const char *tex_path, int *width, int *height);
+
+// texture_level_for_scale - pick the mip level to decode for display at a
+// given scale: the smallest level that is still at least the display size
+// scale: display pixels per level 0 texel
+// returns: mip level for texture_load_surface()
+unsigned texture_level_for_scale(double scale);
+
+// texture_paint - paint a texture surface into a pixel rectangle. The
+// rectangle is snapped to whole pixels; a copy scaled to that size is cached
+// on the surface, so repeated draws at one size are plain blits.
+// cr: cairo context
+// surface: surface from texture_load_surface()
+// x, y: top-left corner of the destination rectangle
+// width, height: destination size in pixels
+// alpha: opacity (1.0 for opaque)
+void texture_paint(cairo_t *cr, cairo_surface_t *surface,
+                   double x, double y, double width, double height, double alpha);
+
 // texture_create_with_number - create a new pixbuf with a number drawn on it
 // base: source pixbuf to composite onto
 // number: the number to render
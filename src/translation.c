@@ -1,21 +1,74 @@
 #include "translation.h"
 #include "arc.h"
+#include "config.h"
+#include "path_hash.h"
+#include "platform_mmap.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#define TEXT_TABLE_VERSION 1
+#define TEXT_SLOT_EMPTY UINT32_MAX
+
+#pragma pack(push, 1)
+
+// TextTableHeader - header for tqvc-text-<name>.bin
+// size: 56 bytes
+typedef struct {
+  char magic[4];            // "TQVT"
+  uint32_t version;         // TEXT_TABLE_VERSION
+  uint64_t source_size;     // size of the .arc the table was parsed from
+  int64_t source_mtime;     // modification time of that .arc
+  uint64_t source_hash;     // path_hash() of the .arc's filesystem path
+  uint32_t num_entries;     // number of tags
+  uint32_t num_slots;       // number of TextSlot entries (a power of two)
+  uint32_t slots_offset;    // offset to TextSlot array
+  uint32_t strings_offset;  // offset to null-terminated keys and values
+  uint32_t strings_size;    // size of the string pool in bytes
+  uint32_t reserved;
+} TextTableHeader;
+
+// TextSlot - one slot of the open-addressing table
+// size: 12 bytes
+typedef struct {
+  uint32_t hash;            // low 32 bits of text_hash() of the key
+  uint32_t key_offset;      // lowercase tag, relative to strings_offset
+                            // (TEXT_SLOT_EMPTY for an empty slot)
+  uint32_t value_offset;    // translated string, relative to strings_offset
+} TextSlot;
+
+#pragma pack(pop)
 
 // translation_init - create and initialize a new translation table
-// returns: allocated TQTranslation with an empty hash table
+// returns: allocated TQTranslation with no tags
 TQTranslation *
 translation_init(void)
 {
-  TQTranslation *t = g_malloc0(sizeof(TQTranslation));
+  return(g_malloc0(sizeof(TQTranslation)));
+}
 
-  if(!t)
-    return(NULL);
+// translation_release - drop the table image of a translation
+// t: translation table
+static void
+translation_release(TQTranslation *t)
+{
+  if(t->image)
+  {
+    if(t->mapped)
+      platform_munmap(t->image, t->image_size);
+    else
+      free(t->image);
+  }
 
-  t->tags = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
-  return(t);
+  t->image = NULL;
+  t->image_size = 0;
+  t->mapped = false;
+  t->slots = NULL;
+  t->slot_mask = 0;
+  t->num_entries = 0;
+  t->strings = NULL;
 }
 
 // translation_free - free a translation table and all its entries
@@ -26,10 +79,51 @@ translation_free(TQTranslation *t)
   if(!t)
     return;
 
-  g_hash_table_destroy(t->tags);
+  translation_release(t);
   g_free(t);
 }
 
+// text_hash - 64-bit FNV-1a hash of a tag with ASCII letters lowercased
+// tag: tag in any case
+// returns: hash value
+static uint64_t
+text_hash(const char *tag)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+
+  for(const unsigned char *p = (const unsigned char *)tag; *p; p++)
+  {
+    unsigned char c = (*p >= 'A' && *p <= 'Z') ? (unsigned char)(*p + 32) : *p;
+
+    h ^= c;
+    h *= 0x100000001b3ULL;
+  }
+
+  return(h);
+}
+
+// text_key_equal - compare a stored lowercase key with a tag in any case
+// key: stored key (lowercase)
+// tag: tag to compare
+// returns: true if they match ignoring ASCII case
+static bool
+text_key_equal(const char *key, const char *tag)
+{
+  for(;; key++, tag++)
+  {
+    unsigned char c = (unsigned char)*tag;
+
+    if(c >= 'A' && c <= 'Z')
+      c += 32;
+
+    if((unsigned char)*key != c)
+      return(false);
+
+    if(c == '\0')
+      return(true);
+  }
+}
+
 // strip_tq_tags - strip TQ format codes like {^L}, {^N}, ^L etc. in-place
 // str: string to modify in-place
 static void
@@ -49,12 +143,12 @@ strip_tq_tags(char *str)
   *w = '\0';
 }
 
-// parse_text_data - parse raw text file data and insert tag=value pairs into the table
-// t: translation table to populate
+// parse_text_data - parse raw text file data and insert tag=value pairs into a table
+// tags: lowercase tag -> stripped value (both g_free'd by the table)
 // data: raw file bytes (may be UTF-16 or Windows-1252 encoded)
 // size: number of bytes in data
 static void
-parse_text_data(TQTranslation *t, uint8_t *data, size_t size)
+parse_text_data(GHashTable *tags, const uint8_t *data, size_t size)
 {
   if(!data || size == 0)
     return;
@@ -78,13 +172,7 @@ parse_text_data(TQTranslation *t, uint8_t *data, size_t size)
     // assume Windows-1252 (superset of Latin-1) if not valid UTF-8
     if(g_utf8_validate((const gchar *)data, size, NULL))
     {
-      content = malloc(size + 1);
-
-      if(!content)
-        return;
-
-      memcpy(content, data, size);
-      content[size] = '\0';
+      content = g_strndup((const gchar *)data, size);
     }
     else
     {
@@ -108,27 +196,198 @@ parse_text_data(TQTranslation *t, uint8_t *data, size_t size)
     {
       *eq = '\0';
       char *tag = g_ascii_strdown(line, -1);
-      char *val = strdup(eq + 1);
+      char *val = g_strdup(eq + 1);
 
       strip_tq_tags(val);
-      g_hash_table_insert(t->tags, tag, val);
+      g_hash_table_insert(tags, tag, val);
     }
     line = strtok(NULL, "\r\n");
   }
   g_free(content);
 }
 
-// translation_load_from_arc - load translation strings from a Text .arc file
-// t: translation table to populate
+// text_table_path - cache file path for a Text .arc
 // arc_path: filesystem path to the .arc file
-// returns: true on success, false if the arc could not be loaded
-bool
-translation_load_from_arc(TQTranslation *t, const char *arc_path)
+// returns: newly allocated path (caller frees with g_free)
+static char *
+text_table_path(const char *arc_path)
+{
+  char *base = g_path_get_basename(arc_path);
+  char *dot = strrchr(base, '.');
+
+  if(dot)
+    *dot = '\0';
+
+  char *cache_dir = tqvc_cache_dir_new();
+  char *name = g_strdup_printf("tqvc-text-%s.bin", base);
+  char *path = g_build_filename(cache_dir, name, NULL);
+
+  g_free(name);
+  g_free(cache_dir);
+  g_free(base);
+  return(path);
+}
+
+// text_table_attach - check a table image and point a translation at it
+// t: translation table (its image fields are set by the caller)
+// image: mapped or built image
+// size: image size in bytes
+// source_size: size of the .arc the image must come from
+// source_mtime: modification time of that .arc
+// source_hash: path_hash() of the .arc's path
+// returns: true if the image is valid and current
+static bool
+text_table_attach(TQTranslation *t, const uint8_t *image, size_t size,
+                  uint64_t source_size, int64_t source_mtime, uint64_t source_hash)
+{
+  if(size < sizeof(TextTableHeader))
+    return(false);
+
+  const TextTableHeader *h = (const TextTableHeader *)image;
+
+  if(memcmp(h->magic, "TQVT", 4) != 0 || h->version != TEXT_TABLE_VERSION ||
+     h->source_size != source_size || h->source_mtime != source_mtime ||
+     h->source_hash != source_hash ||
+     h->num_slots == 0 || (h->num_slots & (h->num_slots - 1)) != 0 ||
+     h->num_entries >= h->num_slots ||
+     (uint64_t)h->slots_offset + (uint64_t)h->num_slots * sizeof(TextSlot) > size ||
+     (uint64_t)h->strings_offset + h->strings_size > size ||
+     h->strings_size == 0 || image[h->strings_offset + h->strings_size - 1] != '\0')
+    return(false);
+
+  // every offset inside the pool is NUL-terminated by the check above
+  const TextSlot *slots = (const TextSlot *)(image + h->slots_offset);
+  uint32_t used = 0;
+
+  for(uint32_t i = 0; i < h->num_slots; i++)
+  {
+    if(slots[i].key_offset == TEXT_SLOT_EMPTY)
+      continue;
+
+    if(slots[i].key_offset >= h->strings_size || slots[i].value_offset >= h->strings_size)
+      return(false);
+
+    used++;
+  }
+
+  // lookups stop at an empty slot, so at least one must exist
+  if(used != h->num_entries || used >= h->num_slots)
+    return(false);
+
+  t->slots = slots;
+  t->slot_mask = h->num_slots - 1;
+  t->num_entries = h->num_entries;
+  t->strings = (const char *)image + h->strings_offset;
+  return(true);
+}
+
+// text_table_serialize - build a table image from parsed tags
+// tags: lowercase tag -> stripped value
+// source_size: size of the .arc parsed
+// source_mtime: modification time of that .arc
+// source_hash: path_hash() of the .arc's path
+// size_out: receives the image size in bytes
+// returns: malloc'd image (caller frees), or NULL on failure
+static uint8_t *
+text_table_serialize(GHashTable *tags, uint64_t source_size, int64_t source_mtime,
+                     uint64_t source_hash, size_t *size_out)
+{
+  uint32_t num_entries = g_hash_table_size(tags);
+  uint32_t num_slots = 16;
+
+  // keep the table at most half full so probe runs stay short
+  while(num_slots < num_entries * 2ULL)
+    num_slots <<= 1;
+
+  TextSlot *slots = malloc((size_t)num_slots * sizeof(TextSlot));
+  GString *pool = g_string_new(NULL);
+
+  if(!slots)
+  {
+    g_string_free(pool, TRUE);
+    return(NULL);
+  }
+
+  for(uint32_t i = 0; i < num_slots; i++)
+    slots[i].key_offset = TEXT_SLOT_EMPTY;
+
+  GHashTableIter iter;
+  gpointer key, value;
+
+  g_hash_table_iter_init(&iter, tags);
+  while(g_hash_table_iter_next(&iter, &key, &value))
+  {
+    uint64_t hash = text_hash(key);
+    uint32_t slot = (uint32_t)hash & (num_slots - 1);
+
+    while(slots[slot].key_offset != TEXT_SLOT_EMPTY)
+      slot = (slot + 1) & (num_slots - 1);
+
+    slots[slot].hash = (uint32_t)hash;
+    slots[slot].key_offset = (uint32_t)pool->len;
+    g_string_append_len(pool, key, (gssize)strlen(key) + 1);
+    slots[slot].value_offset = (uint32_t)pool->len;
+    g_string_append_len(pool, value, (gssize)strlen(value) + 1);
+  }
+
+  // an empty pool still needs its terminating NUL for the attach check
+  if(pool->len == 0)
+    g_string_append_c(pool, '\0');
+
+  TextTableHeader h;
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "TQVT", 4);
+  h.version = TEXT_TABLE_VERSION;
+  h.source_size = source_size;
+  h.source_mtime = source_mtime;
+  h.source_hash = source_hash;
+  h.num_entries = num_entries;
+  h.num_slots = num_slots;
+  h.slots_offset = sizeof(TextTableHeader);
+  h.strings_offset = h.slots_offset + num_slots * (uint32_t)sizeof(TextSlot);
+  h.strings_size = (uint32_t)pool->len;
+
+  size_t size = (size_t)h.strings_offset + pool->len;
+  uint8_t *image = malloc(size);
+
+  if(image)
+  {
+    memcpy(image, &h, sizeof(h));
+    memcpy(image + h.slots_offset, slots, (size_t)num_slots * sizeof(TextSlot));
+    memcpy(image + h.strings_offset, pool->str, pool->len);
+    *size_out = size;
+  }
+
+  free(slots);
+  g_string_free(pool, TRUE);
+  return(image);
+}
+
+// text_table_save - write a table image via a temporary file and rename
+// path: filesystem path of the cache file
+// image: serialized table
+// size: image size in bytes
+static void
+text_table_save(const char *path, const uint8_t *image, size_t size)
+{
+  if(!platform_write_file(path, image, size))
+    fprintf(stderr, "text_table_save: could not replace %s\n", path);
+}
+
+// text_table_parse - parse every .txt file of a Text .arc
+// arc_path: filesystem path to the .arc file
+// returns: lowercase tag -> stripped value table, or NULL if the arc could
+//          not be loaded
+static GHashTable *
+text_table_parse(const char *arc_path)
 {
   TQArcFile *arc = arc_load(arc_path);
 
   if(!arc)
-    return(false);
+    return(NULL);
+
+  GHashTable *tags = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 
   for(uint32_t i = 0; i < arc->num_files; i++)
   {
@@ -136,18 +395,99 @@ translation_load_from_arc(TQTranslation *t, const char *arc_path)
 
     if(ext && strcasecmp(ext, ".txt") == 0)
     {
-      size_t size;
-      uint8_t *data = arc_extract_file(arc, i, &size);
+      TQArcView view;
 
-      if(data)
+      if(arc_view_file(arc, i, NULL, 0, &view))
       {
-        parse_text_data(t, data, size);
-        free(data);
+        parse_text_data(tags, view.data, view.size);
+        arc_view_release(&view);
       }
     }
   }
 
   arc_free(arc);
+  return(tags);
+}
+
+// translation_load_from_arc - load translation strings from a Text .arc file,
+// via the parsed-table cache
+// t: translation table to populate
+// arc_path: filesystem path to the .arc file
+// returns: true on success, false if the arc could not be loaded
+bool
+translation_load_from_arc(TQTranslation *t, const char *arc_path)
+{
+  if(!t || !arc_path)
+    return(false);
+
+  uint64_t source_size = 0;
+  int64_t source_mtime = 0;
+
+  if(!platform_file_info(arc_path, &source_size, &source_mtime))
+    return(false);
+
+  struct timespec t0;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  uint64_t source_hash = path_hash(arc_path);
+  char *cache_path = text_table_path(arc_path);
+  size_t size = 0;
+  uint8_t *image = platform_mmap_readonly(cache_path, &size);
+  bool from_cache = false;
+
+  translation_release(t);
+
+  if(image)
+  {
+    if(text_table_attach(t, image, size, source_size, source_mtime, source_hash))
+    {
+      t->image = image;
+      t->image_size = size;
+      t->mapped = true;
+      from_cache = true;
+    }
+    else
+      platform_munmap(image, size);
+  }
+
+  if(!from_cache)
+  {
+    GHashTable *tags = text_table_parse(arc_path);
+
+    if(!tags)
+    {
+      g_free(cache_path);
+      return(false);
+    }
+
+    image = text_table_serialize(tags, source_size, source_mtime, source_hash, &size);
+    g_hash_table_destroy(tags);
+
+    if(image && text_table_attach(t, image, size, source_size, source_mtime, source_hash))
+    {
+      t->image = image;
+      t->image_size = size;
+      t->mapped = false;
+      text_table_save(cache_path, image, size);
+    }
+    else
+      free(image);
+  }
+
+  g_free(cache_path);
+
+  if(tqvc_debug)
+  {
+    struct timespec t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ms = (t1.tv_sec - t0.tv_sec) * 1000.0 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+    fprintf(stderr, "Translation: %u tags %s in %.2f ms (%s)\n", t->num_entries,
+            from_cache ? "mapped from cache" : "parsed", ms, arc_path);
+  }
+
   return(true);
 }
 
@@ -158,15 +498,371 @@ translation_load_from_arc(TQTranslation *t, const char *arc_path)
 const char *
 translation_get(TQTranslation *t, const char *tag)
 {
-  if(!t || !tag)
+  if(!t || !tag || !t->slots)
+    return(NULL);
+
+  const TextSlot *slots = t->slots;
+  uint64_t hash = text_hash(tag);
+
+  for(uint32_t slot = (uint32_t)hash & t->slot_mask; ; slot = (slot + 1) & t->slot_mask)
+  {
+    const TextSlot *s = &slots[slot];
+
+    if(s->key_offset == TEXT_SLOT_EMPTY)
+      return(NULL);
+
+    if(s->hash == (uint32_t)hash && text_key_equal(t->strings + s->key_offset, tag))
+      return(t->strings + s->value_offset);
+  }
+}
+
+// LangWaiter - one callback waiting for a language load
+typedef struct {
+  TranslationReadyFunc ready;
+  void *user_data;
+} LangWaiter;
+
+// LangJob - one queued language load. The pending table on the main thread
+// maps each .arc path to its job; a worker fills in table and hands the job
+// back to the main loop, which frees it.
+typedef struct {
+  char *arc_path;
+  GArray *waiters;          // LangWaiter (main thread only)
+  TQTranslation *table;     // set by the worker
+  GMutex mutex;
+  GCond cond;               // signalled when done is set
+  bool done;                // table is final
+} LangJob;
+
+static GHashTable *g_languages = NULL;     // .arc path -> TQTranslation*
+static GHashTable *g_lang_pending = NULL;  // .arc path -> LangJob* (main thread)
+static GThreadPool *g_lang_pool = NULL;
+
+// language_code_of - get the language code of a Text .arc file name
+// name: file name (e.g. "Text_EN.arc")
+// code: receives the uppercase code
+// size: size of code in bytes
+// returns: true if name is a Text_<code>.arc file
+static bool
+language_code_of(const char *name, char *code, size_t size)
+{
+  size_t len = strlen(name);
+
+  if(len <= 9 || len - 9 >= size ||
+     g_ascii_strncasecmp(name, "Text_", 5) != 0 ||
+     g_ascii_strcasecmp(name + len - 4, ".arc") != 0)
+    return(false);
+
+  for(size_t i = 0; i < len - 9; i++)
+    code[i] = g_ascii_toupper(name[5 + i]);
+
+  code[len - 9] = '\0';
+  return(true);
+}
+
+// language_arc_path - find the Text .arc of a language (the file name's
+// case is ignored, as installs differ)
+// game_folder: game install root
+// code: language code (case-insensitive)
+// returns: newly allocated path (caller frees with g_free), or NULL if the
+//          language is not installed
+static char *
+language_arc_path(const char *game_folder, const char *code)
+{
+  char *dir_path = g_build_filename(game_folder, "Text", NULL);
+  GDir *dir = g_dir_open(dir_path, 0, NULL);
+  char *arc_path = NULL;
+
+  if(dir)
+  {
+    const char *name;
+    char found[8];
+
+    while(!arc_path && (name = g_dir_read_name(dir)))
+    {
+      if(language_code_of(name, found, sizeof(found)) && g_ascii_strcasecmp(found, code) == 0)
+        arc_path = g_build_filename(dir_path, name, NULL);
+    }
+
+    g_dir_close(dir);
+  }
+
+  g_free(dir_path);
+  return(arc_path);
+}
+
+// language_load - load the table of one language
+// arc_path: filesystem path to the Text_<code>.arc file
+// returns: new table (caller frees with translation_free), or NULL on failure
+static TQTranslation *
+language_load(const char *arc_path)
+{
+  TQTranslation *t = translation_init();
+  char *name = g_path_get_basename(arc_path);
+
+  if(!language_code_of(name, t->language, sizeof(t->language)) ||
+     !translation_load_from_arc(t, arc_path))
+  {
+    translation_free(t);
+    t = NULL;
+  }
+
+  g_free(name);
+  return(t);
+}
+
+// language_job_free - release a job and the table it carries
+// job: job to free
+static void
+language_job_free(LangJob *job)
+{
+  translation_free(job->table);
+  g_array_unref(job->waiters);
+  g_mutex_clear(&job->mutex);
+  g_cond_clear(&job->cond);
+  g_free(job->arc_path);
+  g_free(job);
+}
+
+// language_deliver - main loop side of a finished load
+// data: the job
+// returns: G_SOURCE_REMOVE
+static gboolean
+language_deliver(gpointer data)
+{
+  LangJob *job = data;
+
+  if(g_lang_pending && g_hash_table_lookup(g_lang_pending, job->arc_path) == job)
+  {
+    g_hash_table_remove(g_lang_pending, job->arc_path);
+
+    // translation_language() may have loaded it meanwhile; keep that copy
+    TQTranslation *t = g_hash_table_lookup(g_languages, job->arc_path);
+
+    if(!t && job->table)
+    {
+      t = job->table;
+      job->table = NULL;
+      g_hash_table_insert(g_languages, g_strdup(job->arc_path), t);
+    }
+
+    for(guint i = 0; i < job->waiters->len; i++)
+    {
+      LangWaiter *w = &g_array_index(job->waiters, LangWaiter, i);
+
+      w->ready(t, w->user_data);
+    }
+  }
+
+  language_job_free(job);
+  return(G_SOURCE_REMOVE);
+}
+
+// language_worker - thread pool function: load one language
+// data: the job
+// user_data: unused
+static void
+language_worker(gpointer data, gpointer user_data)
+{
+  LangJob *job = data;
+
+  (void)user_data;
+
+  TQTranslation *table = language_load(job->arc_path);
+
+  g_mutex_lock(&job->mutex);
+  job->table = table;
+  job->done = true;
+  g_cond_broadcast(&job->cond);
+  g_mutex_unlock(&job->mutex);
+  g_idle_add(language_deliver, job);
+}
+
+// languages_init - create the registry on first use
+static void
+languages_init(void)
+{
+  if(g_languages)
+    return;
+
+  g_languages = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                      (GDestroyNotify)translation_free);
+  g_lang_pending = g_hash_table_new(g_str_hash, g_str_equal);
+  g_lang_pool = g_thread_pool_new(language_worker, NULL, 2, FALSE, NULL);
+}
+
+// compare_codes - sort order for language codes
+static gint
+compare_codes(gconstpointer a, gconstpointer b)
+{
+  return(strcmp(*(char * const *)a, *(char * const *)b));
+}
+
+// translation_languages_new - list the languages installed with the game
+// game_folder: game install root
+// returns: NULL-terminated, sorted array of language codes (free with g_strfreev)
+char **
+translation_languages_new(const char *game_folder)
+{
+  GPtrArray *codes = g_ptr_array_new();
+
+  if(game_folder)
+  {
+    char *dir_path = g_build_filename(game_folder, "Text", NULL);
+    GDir *dir = g_dir_open(dir_path, 0, NULL);
+
+    if(dir)
+    {
+      const char *name;
+      char code[8];
+
+      while((name = g_dir_read_name(dir)))
+      {
+        if(language_code_of(name, code, sizeof(code)))
+          g_ptr_array_add(codes, g_strdup(code));
+      }
+
+      g_dir_close(dir);
+    }
+
+    g_free(dir_path);
+  }
+
+  g_ptr_array_sort(codes, compare_codes);
+  g_ptr_array_add(codes, NULL);
+  return((char **)g_ptr_array_free(codes, FALSE));
+}
+
+// translation_language - get the table for a language, loading it now if
+// it is not loaded yet, or waiting for a worker that is already loading it
+// game_folder: game install root
+// code: language code (case-insensitive)
+// returns: shared table, or NULL if the language is not installed
+TQTranslation *
+translation_language(const char *game_folder, const char *code)
+{
+  if(!game_folder || !code)
     return(NULL);
 
-  char lower[256];
-  size_t i;
+  char *arc_path = language_arc_path(game_folder, code);
+
+  if(!arc_path)
+    return(NULL);
+
+  languages_init();
+
+  TQTranslation *t = g_hash_table_lookup(g_languages, arc_path);
+  LangJob *job = t ? NULL : g_hash_table_lookup(g_lang_pending, arc_path);
+
+  if(job)
+  {
+    // a worker is already loading it: take its table rather than loading
+    // the same .arc twice. The job stays pending, so language_deliver()
+    // still calls its waiters, with this copy.
+    g_mutex_lock(&job->mutex);
+
+    while(!job->done)
+      g_cond_wait(&job->cond, &job->mutex);
+
+    t = job->table;
+    job->table = NULL;
+    g_mutex_unlock(&job->mutex);
+
+    if(t)
+    {
+      g_hash_table_insert(g_languages, arc_path, t);
+      return(t);
+    }
+  }
+  else if(!t)
+  {
+    t = language_load(arc_path);
+
+    if(t)
+    {
+      g_hash_table_insert(g_languages, arc_path, t);
+      return(t);
+    }
+  }
+
+  g_free(arc_path);
+  return(t);
+}
+
+// translation_language_async - get the table for a language, loading it on
+// a worker thread if it is not loaded yet
+// game_folder: game install root
+// code: language code (case-insensitive)
+// ready: callback, or NULL to only preload
+// user_data: passed through to ready
+void
+translation_language_async(const char *game_folder, const char *code,
+                           TranslationReadyFunc ready, void *user_data)
+{
+  char *arc_path = (game_folder && code) ? language_arc_path(game_folder, code) : NULL;
+
+  if(!arc_path)
+  {
+    if(ready)
+      ready(NULL, user_data);
+    return;
+  }
+
+  languages_init();
+
+  TQTranslation *t = g_hash_table_lookup(g_languages, arc_path);
+
+  if(t)
+  {
+    g_free(arc_path);
+
+    if(ready)
+      ready(t, user_data);
+    return;
+  }
+
+  LangJob *job = g_hash_table_lookup(g_lang_pending, arc_path);
+
+  if(job)
+    g_free(arc_path);
+  else
+  {
+    job = g_new0(LangJob, 1);
+    job->arc_path = arc_path;
+    job->waiters = g_array_new(FALSE, FALSE, sizeof(LangWaiter));
+    g_mutex_init(&job->mutex);
+    g_cond_init(&job->cond);
+    g_hash_table_insert(g_lang_pending, job->arc_path, job);
+    g_thread_pool_push(g_lang_pool, job, NULL);
+  }
+
+  if(ready)
+  {
+    LangWaiter w = { ready, user_data };
+
+    g_array_append_val(job->waiters, w);
+  }
+}
+
+// translation_languages_free - wait for running loads and free every
+// loaded table
+void
+translation_languages_free(void)
+{
+  if(!g_languages)
+    return;
+
+  // queued loads still run; finished ones posted to the main loop find no
+  // pending table and are freed when their sources are dispatched below
+  g_thread_pool_free(g_lang_pool, FALSE, TRUE);
+  g_lang_pool = NULL;
+
+  g_hash_table_destroy(g_lang_pending);
+  g_lang_pending = NULL;
 
-  for(i = 0; tag[i] && i < 255; i++)
-    lower[i] = (tag[i] >= 'A' && tag[i] <= 'Z') ? (tag[i] + 32) : tag[i];
+  // the application's main loop has usually stopped by now
+  while(g_main_context_iteration(NULL, FALSE));
 
-  lower[i] = '\0';
-  return(g_hash_table_lookup(t->tags, lower));
+  g_hash_table_destroy(g_languages);
+  g_languages = NULL;
 }
@@ -3,11 +3,27 @@
 
 #include <glib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
+// TQTranslation - tag -> string table for one Text .arc. The table is an
+// open-addressing hash table image: keys stored lowercase, values already
+// stripped of TQ format codes and converted to UTF-8. It is mapped from a
+// cache file when one matches the .arc, so loading costs no parsing.
 typedef struct {
-  GHashTable *tags;
+  uint8_t *image;        // table image: mapped cache file or built in memory
+  size_t image_size;     // size of image in bytes
+  bool mapped;           // image is a file mapping (else malloc'd)
+  const void *slots;     // slot array inside image
+  uint32_t slot_mask;    // number of slots - 1
+  uint32_t num_entries;  // number of tags
+  const char *strings;   // key/value string pool inside image
+  char language[8];      // language code (e.g. "EN") for tables from
+                         // translation_language(), else empty
 } TQTranslation;
 
+// language used when none is configured
+#define TRANSLATION_DEFAULT_LANGUAGE "EN"
+
 // translation_init - create and initialize a new translation table
 // returns: allocated TQTranslation, or NULL on failure
 TQTranslation *translation_init(void);
@@ -16,16 +32,57 @@ TQTranslation *translation_init(void);
 // t: translation table to free
 void translation_free(TQTranslation *t);
 
-// translation_load_from_arc - load translation strings from a Text_EN.arc file
-// t: translation table to populate
+// translation_load_from_arc - load translation strings from a Text_EN.arc
+// file. The parsed table is cached in the cache directory per .arc file and
+// reused while the .arc's size and modification time are unchanged.
+// t: translation table to populate (replaces any table already loaded)
 // arc_path: filesystem path to the .arc file
 // returns: true on success
 bool translation_load_from_arc(TQTranslation *t, const char *arc_path);
 
 // translation_get - look up a translation tag
 // t: translation table
-// tag: the tag to look up (case-insensitive)
+// tag: the tag to look up (case-insensitive; hashed and compared in place,
+//      without copying)
 // returns: translated string (internal pointer, do not free), or NULL
 const char *translation_get(TQTranslation *t, const char *tag);
 
+// The language registry keeps one table per Text_<code>.arc. Each table is
+// loaded on first use and stays loaded until translation_languages_free(),
+// so switching back to a language costs nothing and pointers to a table
+// stay valid for the whole session. Main thread only.
+
+// translation_languages_new - list the languages installed with the game
+// game_folder: game install root
+// returns: NULL-terminated array of language codes (e.g. "DE", "EN"), one
+//          per Text/Text_<code>.arc, sorted (free with g_strfreev)
+char **translation_languages_new(const char *game_folder);
+
+// translation_language - get the table for a language, loading it now if
+// it is not loaded yet
+// game_folder: game install root
+// code: language code (case-insensitive)
+// returns: shared table (do not free), or NULL if the language is not installed
+TQTranslation *translation_language(const char *game_folder, const char *code);
+
+// TranslationReadyFunc - completion callback, run on the main thread
+// t: shared table (do not free), or NULL if the language could not be loaded
+// user_data: value passed to translation_language_async()
+typedef void (*TranslationReadyFunc)(TQTranslation *t, void *user_data);
+
+// translation_language_async - get the table for a language, loading it on
+// a worker thread if it is not loaded yet. Requests for a language that is
+// already loading are merged.
+// game_folder: game install root
+// code: language code (case-insensitive)
+// ready: callback, or NULL to only preload; runs before this returns if the
+//        language is already loaded
+// user_data: passed through to ready
+void translation_language_async(const char *game_folder, const char *code,
+                                TranslationReadyFunc ready, void *user_data);
+
+// translation_languages_free - wait for running loads and free every
+// loaded table
+void translation_languages_free(void);
+
 #endif
@@ -7,6 +7,8 @@
 #include "item_stats.h"
 #include "affix_table.h"
 #include "prefetch.h"
+#include "icon_loader.h"
+#include "icon_cache.h"
 #include "version.h"
 #include "build_number.h"
 #include <stdio.h>
@@ -15,90 +17,234 @@
 #include <strings.h>
 #include <ctype.h>
 
-// Load the texture for a vault item, using a cache keyed by base_name:var1.
+// Build the texture cache key for an item icon.
+// Cache key includes shard count so incomplete and complete relics/charms
+// get different textures even though they share the same base_name.
+//   key       - output buffer
+//   size      - size of key in bytes
+//   base_name - DBR record path for the item
+//   var1      - shard count
+//   level     - mip level
+static void
+item_texture_key(char *key, size_t size, const char *base_name, uint32_t var1, unsigned level)
+{
+  snprintf(key, size, "%s:%u@%u", base_name, var1, level);
+}
+
+// Look up an item icon in the texture cache, then in the on-disk icon
+// cache. Icons found on disk are added to the texture cache.
+//   widgets   - app state (owns the texture cache)
+//   cache_key - key from item_texture_key()
+// Returns a new cairo surface ref (caller must destroy), or NULL on a miss.
+static cairo_surface_t*
+lookup_item_texture(AppWidgets *widgets, const char *cache_key)
+{
+  cairo_surface_t *cached = g_hash_table_lookup(widgets->texture_cache, cache_key);
+
+  if(cached)
+    return(cairo_surface_reference(cached));
+
+  cached = icon_cache_lookup(cache_key);
+  if(cached)
+    g_hash_table_insert(widgets->texture_cache, strdup(cache_key), cairo_surface_reference(cached));
+
+  return(cached);
+}
+
+// Load the texture for a vault item at a mip level, using a cache keyed by
+// base_name:var1@level.
 // Handles relics/charms (shard vs complete bitmap), artifacts, and normal items.
 //   widgets   - app state (owns the texture cache)
 //   base_name - DBR record path for the item
 //   var1      - shard count (used to pick shard vs complete relic texture)
-// Returns a new GdkPixbuf ref (caller must unref), or NULL on failure.
-GdkPixbuf*
-load_item_texture(AppWidgets *widgets, const char *base_name, uint32_t var1)
+//   level     - mip level to decode (0 = full size)
+// Returns a new cairo surface ref (caller must destroy), or NULL on failure.
+static cairo_surface_t*
+load_item_texture_level(AppWidgets *widgets, const char *base_name, uint32_t var1,
+                        unsigned level)
 {
   if(!base_name)
     return(NULL);
   if(!global_config.game_folder)
     return(NULL);
 
-  // Cache key includes shard count so incomplete and complete relics/charms
-  // get different textures even though they share the same base_name.
   char cache_key[1200];
 
-  snprintf(cache_key, sizeof(cache_key), "%s:%u", base_name, var1);
+  item_texture_key(cache_key, sizeof(cache_key), base_name, var1, level);
 
-  GdkPixbuf *cached = g_hash_table_lookup(widgets->texture_cache, cache_key);
+  cairo_surface_t *cached = lookup_item_texture(widgets, cache_key);
 
   if(cached)
-    return(g_object_ref(cached));
+    return(cached);
 
-  char *bitmap_path = NULL;
-  TQArzRecordData *data = asset_get_dbr(base_name);
+  char tex_path[1024];
 
-  if(data)
+  icon_texture_path(base_name, var1, tex_path, sizeof(tex_path));
+
+  cairo_surface_t *surface = texture_load_surface(tex_path, level);
+
+  if(surface)
   {
-    bitmap_path = arz_record_get_string(data, "bitmap", NULL);
-    if(!bitmap_path)
-      bitmap_path = arz_record_get_string(data, "artifactBitmap", NULL);
+    g_hash_table_insert(widgets->texture_cache, strdup(cache_key), cairo_surface_reference(surface));
+    icon_cache_add(cache_key, surface);
+  }
+
+  return(surface);
+}
+
+// Load the texture for a vault item at the mip level last used for drawing.
+//   widgets   - app state (owns the texture cache)
+//   base_name - DBR record path for the item
+//   var1      - shard count (used to pick shard vs complete relic texture)
+// Returns a new cairo surface ref (caller must destroy), or NULL on failure.
+cairo_surface_t*
+load_item_texture(AppWidgets *widgets, const char *base_name, uint32_t var1)
+{
+  return(load_item_texture_level(widgets, base_name, var1, widgets->icon_level));
+}
 
-    if(!bitmap_path)
+// Load the texture for a vault item sized for a display cell. Item textures
+// are 32 texels per cell, so the level follows from the cell size alone.
+//   widgets   - app state (owns the texture cache)
+//   base_name - DBR record path for the item
+//   var1      - shard count (used to pick shard vs complete relic texture)
+//   cell_px   - device pixels per cell
+// Returns a new cairo surface ref (caller must destroy), or NULL on failure.
+cairo_surface_t*
+load_item_texture_for_cell(AppWidgets *widgets, const char *base_name, uint32_t var1,
+                           double cell_px)
+{
+  widgets->icon_level = texture_level_for_scale(cell_px / 32.0);
+  return(load_item_texture_level(widgets, base_name, var1, widgets->icon_level));
+}
+
+// Get an item texture for drawing without blocking. On a cache miss the
+// icon is queued on the icon loader and NULL is returned; the caller draws
+// a placeholder and waiter is redrawn once the icon arrives.
+//   widgets   - app state (owns the texture cache)
+//   base_name - DBR record path for the item
+//   var1      - shard count (used to pick shard vs complete relic texture)
+//   cell_px   - device pixels per cell
+//   waiter    - widget to redraw when a queued icon is ready
+// Returns a new cairo surface ref (caller must destroy), or NULL if not ready.
+cairo_surface_t*
+load_item_texture_async(AppWidgets *widgets, const char *base_name, uint32_t var1,
+                        double cell_px, GtkWidget *waiter)
+{
+  if(!base_name || !global_config.game_folder)
+    return(NULL);
+
+  widgets->icon_level = texture_level_for_scale(cell_px / 32.0);
+
+  char cache_key[1200];
+
+  item_texture_key(cache_key, sizeof(cache_key), base_name, var1, widgets->icon_level);
+
+  cairo_surface_t *cached = lookup_item_texture(widgets, cache_key);
+
+  if(cached)
+    return(cached);
+
+  icon_loader_request(cache_key, base_name, var1, widgets->icon_level,
+                      ICON_PRIORITY_VISIBLE, waiter);
+  return(NULL);
+}
+
+// Queue background decodes of the icons in a set of sacks, behind any
+// icons that are waiting to be drawn.
+//   widgets   - app state (owns the texture cache)
+//   sacks     - sacks whose items to queue
+//   num_sacks - number of sacks
+void
+prefetch_item_icons(AppWidgets *widgets, TQVaultSack *sacks, int num_sacks)
+{
+  char cache_key[1200];
+
+  if(!global_config.game_folder)
+    return;
+
+  for(int s = 0; s < num_sacks; s++)
+  {
+    for(int i = 0; i < sacks[s].num_items; i++)
     {
-      // For relics/charms: use shardBitmap when incomplete, relicBitmap when complete.
-      // completedRelicLevel from the DBR tells us how many shards are needed.
-      char *relic_bmp = arz_record_get_string(data, "relicBitmap", NULL);
-      char *shard_bmp = arz_record_get_string(data, "shardBitmap", NULL);
+      TQVaultItem *it = &sacks[s].items[i];
 
-      if(relic_bmp && shard_bmp)
-      {
-        int max_shards = arz_record_get_int(data, "completedRelicLevel", 0, NULL);
+      if(!it->base_name)
+        continue;
 
-        if(max_shards > 0 && var1 < (uint32_t)max_shards)
-        {
-          bitmap_path = shard_bmp;
-          free(relic_bmp);
-        }
-        else
-        {
-          bitmap_path = relic_bmp;
-          free(shard_bmp);
-        }
-      }
-      else if(relic_bmp)
-        bitmap_path = relic_bmp;
-      else if(shard_bmp)
-        bitmap_path = shard_bmp;
+      item_texture_key(cache_key, sizeof(cache_key), it->base_name, it->var1, widgets->icon_level);
+
+      // icons already decoded or in the on-disk cache need no worker
+      cairo_surface_t *cached = lookup_item_texture(widgets, cache_key);
+
+      if(cached)
+        cairo_surface_destroy(cached);
+      else
+        icon_loader_request(cache_key, it->base_name, it->var1, widgets->icon_level,
+                            ICON_PRIORITY_PREFETCH, NULL);
     }
   }
+}
 
-  char tex_path[1024];
-  const char *source = bitmap_path ? bitmap_path : base_name;
+// Icon loader completion: cache the icon and redraw the areas showing its
+// placeholder.
+//   key       - texture cache key
+//   surface   - decoded icon, or NULL if it could not be loaded
+//   waiters   - widgets to redraw
+//   user_data - AppWidgets
+static void
+on_icon_ready(const char *key, cairo_surface_t *surface, GPtrArray *waiters, void *user_data)
+{
+  AppWidgets *widgets = (AppWidgets *)user_data;
 
-  strncpy(tex_path, source, sizeof(tex_path));
-  tex_path[sizeof(tex_path)-1] = '\0';
-  if(bitmap_path)
-    free(bitmap_path);
+  if(surface)
+  {
+    g_hash_table_replace(widgets->texture_cache, g_strdup(key), cairo_surface_reference(surface));
+    icon_cache_add(key, surface);
+  }
 
-  char *dot = strrchr(tex_path, '.');
+  for(guint i = 0; i < waiters->len; i++)
+    gtk_widget_queue_draw(GTK_WIDGET(g_ptr_array_index(waiters, i)));
+}
 
-  if(dot)
-    strcpy(dot, ".tex");
-  else
-    strcat(tex_path, ".tex");
+// Load a bag button texture at button size. The decoded texture is served
+// from and added to the on-disk icon cache, keyed like item icons as
+// tex_path@level.
+//   tex_path - game path of the bag texture
+// Returns a new 40x36 pixbuf (caller unrefs), or NULL on failure.
+static GdkPixbuf*
+load_bag_texture(const char *tex_path)
+{
+  char cache_key[1100];
+
+  snprintf(cache_key, sizeof(cache_key), "%s@0", tex_path);
 
-  GdkPixbuf *pixbuf = texture_load(tex_path);
+  cairo_surface_t *surface = icon_cache_lookup(cache_key);
 
-  if(pixbuf)
-    g_hash_table_insert(widgets->texture_cache, strdup(cache_key), g_object_ref(pixbuf));
+  if(!surface)
+  {
+    surface = texture_load_surface(tex_path, 0);
+    if(!surface)
+      return(NULL);
+    icon_cache_add(cache_key, surface);
+  }
+
+  int width = cairo_image_surface_get_width(surface);
+  int height = cairo_image_surface_get_height(surface);
+
+  G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+  GdkPixbuf *raw = gdk_pixbuf_get_from_surface(surface, 0, 0, width, height);
+  G_GNUC_END_IGNORE_DEPRECATIONS
+
+  cairo_surface_destroy(surface);
+
+  if(!raw)
+    return(NULL);
 
-  return(pixbuf);
+  GdkPixbuf *scaled = gdk_pixbuf_scale_simple(raw, 40, 36, GDK_INTERP_BILINEAR);
+
+  g_object_unref(raw);
+  return(scaled);
 }
 
 // Check whether base_name refers to a standalone relic or charm item.
@@ -342,31 +488,53 @@ save_stashes_if_dirty(AppWidgets *widgets)
     stash_save(widgets->relic_vault);
 }
 
-// Get the cell dimensions of an item from its texture, falling back to struct fields.
-//   widgets - app state (for texture loading)
+// Get the cell dimensions of an item from its texture, falling back to struct
+// fields. Called on input and while drawing, so it never decodes: a cached
+// or atlas icon gives its size directly, otherwise the size is read from
+// the texture header and the icon is queued on the icon loader.
+//   widgets - app state (owns the texture cache)
 //   item    - the vault item
 //   w       - output: width in cells
 //   h       - output: height in cells
 void
 get_item_dims(AppWidgets *widgets, TQVaultItem *item, int *w, int *h)
 {
-  GdkPixbuf *pixbuf = load_item_texture(widgets, item->base_name, item->var1);
+  *w = item->width  > 0 ? item->width  : 1;
+  *h = item->height > 0 ? item->height : 1;
+
+  if(!item->base_name || !global_config.game_folder)
+    return;
+
+  char cache_key[1200];
+  int tw, th;
+
+  item_texture_key(cache_key, sizeof(cache_key), item->base_name, item->var1, widgets->icon_level);
+
+  cairo_surface_t *tex = lookup_item_texture(widgets, cache_key);
 
-  if(pixbuf)
+  if(tex)
   {
-    *w = gdk_pixbuf_get_width(pixbuf) / 32;
-    *h = gdk_pixbuf_get_height(pixbuf) / 32;
-    if(*w < 1)
-      *w = 1;
-    if(*h < 1)
-      *h = 1;
-    g_object_unref(pixbuf);
+    texture_base_size(tex, &tw, &th);
+    cairo_surface_destroy(tex);
   }
   else
   {
-    *w = item->width  > 0 ? item->width  : 1;
-    *h = item->height > 0 ? item->height : 1;
+    char tex_path[1024];
+
+    icon_loader_request(cache_key, item->base_name, item->var1, widgets->icon_level,
+                        ICON_PRIORITY_VISIBLE, NULL);
+    icon_texture_path(item->base_name, item->var1, tex_path, sizeof(tex_path));
+
+    if(!texture_get_size(tex_path, &tw, &th))
+      return;
   }
+
+  *w = tw / 32;
+  *h = th / 32;
+  if(*w < 1)
+    *w = 1;
+  if(*h < 1)
+    *h = 1;
 }
 
 // Strip Pango/HTML markup tags from a string, producing plain text.
@@ -1043,6 +1211,20 @@ on_overlay_motion(GtkEventControllerMotion *ctrl,
     gtk_widget_queue_draw(widgets->held_overlay);
 }
 
+// Callback: application shutdown. Drops the texture cache, whose icons
+// may be surfaces over the mapped icon atlas, so icon_cache_save() in
+// main() can replace the atlas file once the application has stopped.
+//   app       - the GtkApplication (unused)
+//   user_data - AppWidgets*
+static void
+on_app_shutdown(GApplication *app, gpointer user_data)
+{
+  (void)app;
+  AppWidgets *widgets = (AppWidgets *)user_data;
+
+  g_hash_table_remove_all(widgets->texture_cache);
+}
+
 // ── Application window layout ──────────────────────────────────────────
 
 // Main application activate callback. Builds the entire UI layout.
@@ -1054,7 +1236,10 @@ ui_app_activate(GtkApplication *app, gpointer user_data)
   (void)user_data;
   AppWidgets *widgets = g_malloc0(sizeof(AppWidgets));
 
-  widgets->texture_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+  widgets->texture_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                                 (GDestroyNotify)cairo_surface_destroy);
+  icon_loader_init(on_icon_ready, widgets);
+  g_signal_connect(app, "shutdown", G_CALLBACK(on_app_shutdown), widgets);
   widgets->last_equip_tooltip_slot = -1;
   widgets->context_equip_slot = -1;
 
@@ -1141,12 +1326,11 @@ ui_app_activate(GtkApplication *app, gpointer user_data)
   gtk_widget_set_visible(widgets->compare_separator, FALSE);
   widgets->tooltip_parent = NULL;
 
-  GdkPixbuf *test_relic = texture_load("Items\\AnimalRelics\\AnimalPart07B_L.tex");
+  GdkPixbuf *test_relic = tqvc_debug ? texture_load("Items\\AnimalRelics\\AnimalPart07B_L.tex") : NULL;
 
   if(test_relic)
   {
-    if(tqvc_debug)
-      printf("DEBUG: AnimalPart07B_L.tex size: %dx%d\n", gdk_pixbuf_get_width(test_relic), gdk_pixbuf_get_height(test_relic));
+    printf("DEBUG: AnimalPart07B_L.tex size: %dx%d\n", gdk_pixbuf_get_width(test_relic), gdk_pixbuf_get_height(test_relic));
     g_object_unref(test_relic);
   }
 
@@ -1182,11 +1366,12 @@ ui_app_activate(GtkApplication *app, gpointer user_data)
 
   if(global_config.game_folder)
   {
-    widgets->translations = translation_init();
-    char trans_path[1024];
+    const char *lang = global_config.language ? global_config.language : TRANSLATION_DEFAULT_LANGUAGE;
 
-    snprintf(trans_path, sizeof(trans_path), "%s/Text/Text_EN.arc", global_config.game_folder);
-    translation_load_from_arc(widgets->translations, trans_path);
+    widgets->translations = translation_language(global_config.game_folder, lang);
+    if(!widgets->translations)
+      widgets->translations = translation_language(global_config.game_folder,
+                                                   TRANSLATION_DEFAULT_LANGUAGE);
   }
 
   GtkWidget *header = gtk_header_bar_new();
@@ -1336,15 +1521,7 @@ ui_app_activate(GtkApplication *app, gpointer user_data)
     GdkPixbuf *base[3] = {NULL, NULL, NULL};
 
     for(int s = 0; s < 3; s++)
-    {
-      GdkPixbuf *raw = texture_load(tex_paths[s]);
-
-      if(raw)
-      {
-        base[s] = gdk_pixbuf_scale_simple(raw, 40, 36, GDK_INTERP_BILINEAR);
-        g_object_unref(raw);
-      }
-    }
+      base[s] = load_bag_texture(tex_paths[s]);
 
     bool have_tex = (base[0] && base[1] && base[2]);
 
@@ -1453,15 +1630,7 @@ ui_app_activate(GtkApplication *app, gpointer user_data)
     GdkPixbuf *cbase[3] = {NULL, NULL, NULL};
 
     for(int s = 0; s < 3; s++)
-    {
-      GdkPixbuf *raw = texture_load(tex_paths[s]);
-
-      if(raw)
-      {
-        cbase[s] = gdk_pixbuf_scale_simple(raw, 40, 36, GDK_INTERP_BILINEAR);
-        g_object_unref(raw);
-      }
-    }
+      cbase[s] = load_bag_texture(tex_paths[s]);
 
     bool have_tex = (cbase[0] && cbase[1] && cbase[2]);
 
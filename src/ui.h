@@ -96,7 +96,7 @@ typedef struct {
     ContainerType source;
     int source_sack_idx;     // vault sack or char bag index
     int source_equip_slot;
-    GdkPixbuf *texture;      // cached for cursor drawing
+    cairo_surface_t *texture; // cached for cursor drawing
     int item_w, item_h;      // cell dimensions
     bool is_copy;            // true = created by Copy/Duplicate, discard on cancel
 } HeldItem;
@@ -165,6 +165,7 @@ typedef struct {
     TQVault *current_vault;
     TQTranslation *translations;
     GHashTable *texture_cache;
+    unsigned icon_level;               // mip level of the last drawn grid (0 until the first draw)
 
     // Tooltip caches
     TQVaultItem *last_tooltip_item;
@@ -420,10 +421,47 @@ get_item_dims(AppWidgets *widgets, TQVaultItem *item, int *w, int *h);
 // widgets: the application widget state (for texture cache).
 // base_name: DBR path of the item.
 // var1: item variant (used for relic shard count).
-// Returns: GdkPixbuf texture, or NULL if not found.
-GdkPixbuf *
+// The texture is decoded at the mip level of the most recent
+// load_item_texture_for_cell() call; use texture_base_size() for its
+// natural size.
+// Returns: new reference to a premultiplied ARGB32 surface (caller must
+// cairo_surface_destroy), or NULL if not found.
+cairo_surface_t *
 load_item_texture(AppWidgets *widgets, const char *base_name, uint32_t var1);
 
+// Load or retrieve from cache the texture for an item, decoded at the
+// smallest mip level that still covers the given cell size. Textures are
+// cached per level, so each size class is decoded once.
+// widgets: the application widget state (for texture cache).
+// base_name: DBR path of the item.
+// var1: item variant (used for relic shard count).
+// cell_px: device pixels per inventory cell where the item is drawn.
+// Returns: new surface reference (caller must cairo_surface_destroy), or NULL.
+cairo_surface_t *
+load_item_texture_for_cell(AppWidgets *widgets, const char *base_name, uint32_t var1,
+                           double cell_px);
+
+// Get an item texture for drawing without blocking the draw callback. On a
+// cache miss the icon is decoded on a worker thread and NULL is returned;
+// waiter is redrawn when it is ready.
+// widgets: the application widget state (for texture cache).
+// base_name: DBR path of the item.
+// var1: item variant (used for relic shard count).
+// cell_px: device pixels per inventory cell where the item is drawn.
+// waiter: widget to redraw once the icon is cached.
+// Returns: new surface reference (caller must cairo_surface_destroy), or NULL.
+cairo_surface_t *
+load_item_texture_async(AppWidgets *widgets, const char *base_name, uint32_t var1,
+                        double cell_px, GtkWidget *waiter);
+
+// Queue background decodes of every item icon in a set of sacks. They run
+// after icons that are waiting to be drawn.
+// widgets: the application widget state (for texture cache).
+// sacks: sacks whose items to queue.
+// num_sacks: number of sacks.
+void
+prefetch_item_icons(AppWidgets *widgets, TQVaultSack *sacks, int num_sacks);
+
 // Check if a vault item matches the current search text.
 // widgets: the application widget state (for search_text).
 // item: the vault item to check.
@@ -4,6 +4,7 @@
 // with variable inspection for selected records.
 
 #include "ui.h"
+#include "texture.h"
 #include "arz.h"
 #include "config.h"
 #include "item_stats.h"
@@ -779,21 +780,12 @@ dlg_held_overlay_draw_cb(GtkDrawingArea *da, cairo_t *cr,
   if(cell <= 0.0)
     cell = 32.0;
 
-  int pw = gdk_pixbuf_get_width(hi->texture);
-  int ph = gdk_pixbuf_get_height(hi->texture);
   double rw = (double)hi->item_w * cell;
   double rh = (double)hi->item_h * cell;
   double ix = st->dlg_cursor_x - rw / 2.0;
   double iy = st->dlg_cursor_y - rh / 2.0;
 
-  cairo_save(cr);
-  cairo_translate(cr, ix, iy);
-  cairo_scale(cr, rw / (double)pw, rh / (double)ph);
-  G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-  gdk_cairo_set_source_pixbuf(cr, hi->texture, 0, 0);
-  G_GNUC_END_IGNORE_DEPRECATIONS
-  cairo_paint_with_alpha(cr, 0.7);
-  cairo_restore(cr);
+  texture_paint(cr, hi->texture, ix, iy, rw, rh, 0.7);
 }
 
 // Capture-phase motion handler: tracks cursor in dialog overlay coordinates
@@ -1,6 +1,7 @@
 // ui_dnd.c -- Click-to-move / drag-and-drop item handling.
 
 #include "ui.h"
+#include "texture.h"
 #include "arz.h"
 #include "asset_lookup.h"
 #include "item_stats.h"
@@ -148,23 +149,9 @@ build_occupancy_grid(AppWidgets *widgets, TQVaultSack *sack,
     if(it == exclude || !it->base_name)
       continue;
 
-    int w = it->width > 0 ? it->width : 1;
-    int h = it->height > 0 ? it->height : 1;
-    GdkPixbuf *pixbuf = load_item_texture(widgets, it->base_name, it->var1);
-
-    if(pixbuf)
-    {
-      w = gdk_pixbuf_get_width(pixbuf) / 32;
-      h = gdk_pixbuf_get_height(pixbuf) / 32;
-
-      if(w < 1)
-        w = 1;
-
-      if(h < 1)
-        h = 1;
+    int w, h;
 
-      g_object_unref(pixbuf);
-    }
+    get_item_dims(widgets, it, &w, &h);
 
     for(int dy = 0; dy < h; dy++)
       for(int dx = 0; dx < w; dx++)
@@ -211,7 +198,7 @@ free_held_item(AppWidgets *widgets)
   vault_item_free_strings(&widgets->held_item->item);
 
   if(widgets->held_item->texture)
-    g_object_unref(widgets->held_item->texture);
+    cairo_surface_destroy(widgets->held_item->texture);
 
   free(widgets->held_item);
   widgets->held_item = NULL;
@@ -846,7 +833,7 @@ place_in_sack(AppWidgets *widgets, TQVaultSack *sack,
     hi->item_h = th;
 
     if(hi->texture)
-      g_object_unref(hi->texture);
+      cairo_surface_destroy(hi->texture);
 
     hi->texture = load_item_texture(widgets, target_copy.base_name, target_copy.var1);
     hi->source = ctype;
@@ -1241,8 +1228,9 @@ on_equip_click(GtkGestureClick *gesture, int n_press, double x, double y, gpoint
     // Get dimensions
     if(hi->texture)
     {
-      hi->item_w = gdk_pixbuf_get_width(hi->texture) / 32;
-      hi->item_h = gdk_pixbuf_get_height(hi->texture) / 32;
+      texture_base_size(hi->texture, &hi->item_w, &hi->item_h);
+      hi->item_w /= 32;
+      hi->item_h /= 32;
 
       if(hi->item_w < 1)
         hi->item_w = 1;
@@ -1325,13 +1313,14 @@ on_equip_click(GtkGestureClick *gesture, int n_press, double x, double y, gpoint
 
       equip_to_vault_item(&old_vi, existing);
 
-      GdkPixbuf *old_tex = load_item_texture(widgets, existing->base_name, existing->var1);
+      cairo_surface_t *old_tex = load_item_texture(widgets, existing->base_name, existing->var1);
       int ow = 1, oh = 1;
 
       if(old_tex)
       {
-        ow = gdk_pixbuf_get_width(old_tex) / 32;
-        oh = gdk_pixbuf_get_height(old_tex) / 32;
+        texture_base_size(old_tex, &ow, &oh);
+        ow /= 32;
+        oh /= 32;
 
         if(ow < 1)
           ow = 1;
@@ -1350,7 +1339,7 @@ on_equip_click(GtkGestureClick *gesture, int n_press, double x, double y, gpoint
       hi->item_h = oh;
 
       if(hi->texture)
-        g_object_unref(hi->texture);
+        cairo_surface_destroy(hi->texture);
 
       hi->texture = old_tex;
       hi->source = CONTAINER_EQUIP;
@@ -5,56 +5,76 @@
 #include "item_stats.h"
 #include <string.h>
 #include <strings.h>
+#include <math.h>
+
+// Size of an inventory cell in device pixels, for picking texture mip levels.
+// cr: cairo context the cell is drawn to
+// cell_size: cell dimension in user-space pixels
+// Returns: device pixels per cell
+static double
+cell_device_px(cairo_t *cr, double cell_size)
+{
+  double dx = cell_size;
+  double dy = cell_size;
+
+  cairo_user_to_device_distance(cr, &dx, &dy);
+  return(fmax(fabs(dx), fabs(dy)));
+}
 
 // Load the relic/charm overlay icon (cached via the texture cache).
 // The game texture has a solid black background, so we key it out to
 // transparent so the overlay composites cleanly over item textures.
 // widgets: application widget state with texture cache
-// Returns: a new ref to the overlay pixbuf, or NULL
-static GdkPixbuf *
-load_relic_overlay(AppWidgets *widgets)
+// level: mip level to decode (0 = full size)
+// Returns: a new ref to the overlay surface, or NULL
+static cairo_surface_t *
+load_relic_overlay(AppWidgets *widgets, unsigned level)
 {
   static const char *overlay_path = "Items\\Relic\\ItemRelicOverlay.tex";
+  char cache_key[64];
 
-  GdkPixbuf *cached = g_hash_table_lookup(widgets->texture_cache, overlay_path);
+  snprintf(cache_key, sizeof(cache_key), "%s@%u", overlay_path, level);
+
+  cairo_surface_t *cached = g_hash_table_lookup(widgets->texture_cache, cache_key);
 
   if(cached)
-    return(g_object_ref(cached));
+    return(cairo_surface_reference(cached));
 
-  GdkPixbuf *raw = texture_load(overlay_path);
+  cairo_surface_t *surface = texture_load_surface(overlay_path, level);
 
-  if(!raw)
+  if(!surface)
     return(NULL);
 
-  // Make a writable copy and key out black pixels
-  GdkPixbuf *pixbuf = gdk_pixbuf_copy(raw);
+  // Key out black pixels in place. The surface is premultiplied, so a
+  // channel below 8 in straight color is c * 255 < 8 * alpha.
+  int w = cairo_image_surface_get_width(surface);
+  int h = cairo_image_surface_get_height(surface);
+  int stride = cairo_image_surface_get_stride(surface);
 
-  g_object_unref(raw);
-  if(pixbuf && gdk_pixbuf_get_has_alpha(pixbuf))
-  {
-    int w = gdk_pixbuf_get_width(pixbuf);
-    int h = gdk_pixbuf_get_height(pixbuf);
-    int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
-    guchar *pixels = gdk_pixbuf_get_pixels(pixbuf);
+  cairo_surface_flush(surface);
 
-    for(int y = 0; y < h; y++)
-    {
-      guchar *row = pixels + y * rowstride;
+  unsigned char *pixels = cairo_image_surface_get_data(surface);
 
-      for(int x = 0; x < w; x++)
-      {
-        guchar *px = row + x * 4;
+  for(int y = 0; y < h; y++)
+  {
+    uint32_t *row = (uint32_t *)(pixels + (size_t)y * stride);
 
-        // Treat near-black pixels as background -> fully transparent
-        if(px[0] < 8 && px[1] < 8 && px[2] < 8)
-          px[3] = 0;
-      }
+    for(int x = 0; x < w; x++)
+    {
+      uint32_t a = row[x] >> 24;
+      uint32_t limit = 8 * a;
+
+      // Treat near-black pixels as background -> fully transparent
+      if(((row[x] >> 16) & 0xFF) * 255 < limit &&
+         ((row[x] >> 8) & 0xFF) * 255 < limit &&
+         (row[x] & 0xFF) * 255 < limit)
+        row[x] = 0;
     }
   }
 
-  if(pixbuf)
-    g_hash_table_insert(widgets->texture_cache, strdup(overlay_path), g_object_ref(pixbuf));
-  return(pixbuf);
+  cairo_surface_mark_dirty(surface);
+  g_hash_table_insert(widgets->texture_cache, strdup(cache_key), cairo_surface_reference(surface));
+  return(surface);
 }
 
 // Draw the relic overlay icon in the bottom-right cell of an item.
@@ -70,13 +90,15 @@ draw_relic_overlay(cairo_t *cr, AppWidgets *widgets,
                    double x, double y,
                    int item_w, int item_h, double cell_size)
 {
-  GdkPixbuf *overlay = load_relic_overlay(widgets);
+  cairo_surface_t *overlay =
+    load_relic_overlay(widgets, texture_level_for_scale(cell_device_px(cr, cell_size) / 32.0));
 
   if(!overlay)
     return;
 
-  int ow = gdk_pixbuf_get_width(overlay);
-  int oh = gdk_pixbuf_get_height(overlay);
+  int ow, oh;
+
+  texture_base_size(overlay, &ow, &oh);
 
   // Scale overlay proportionally: 32 native pixels = 1 cell (TQVaultAE standard).
   // This keeps the overlay at its natural size relative to the cell rather than
@@ -88,15 +110,8 @@ draw_relic_overlay(cairo_t *cr, AppWidgets *widgets,
   double ox = x + (double)item_w * cell_size - draw_w;
   double oy = y + (double)item_h * cell_size - draw_h;
 
-  cairo_save(cr);
-  cairo_translate(cr, ox, oy);
-  cairo_scale(cr, draw_w / (double)ow, draw_h / (double)oh);
-  G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-  gdk_cairo_set_source_pixbuf(cr, overlay, 0, 0);
-  G_GNUC_END_IGNORE_DEPRECATIONS
-  cairo_paint(cr);
-  cairo_restore(cr);
-  g_object_unref(overlay);
+  texture_paint(cr, overlay, ox, oy, draw_w, draw_h, 1.0);
+  cairo_surface_destroy(overlay);
 }
 
 // Returns the completedRelicLevel from the DBR, or 0 if not found.
@@ -261,12 +276,14 @@ draw_equip_slot(cairo_t *cr, AppWidgets *widgets,
 
     if(item)
     {
-      GdkPixbuf *pixbuf = load_item_texture(widgets, item->base_name, item->var1);
+      cairo_surface_t *tex = load_item_texture_for_cell(widgets, item->base_name, item->var1,
+                                                        cell_device_px(cr, cell_size));
 
-      if(pixbuf)
+      if(tex)
       {
-        int pw = gdk_pixbuf_get_width(pixbuf);
-        int ph = gdk_pixbuf_get_height(pixbuf);
+        int pw, ph;
+
+        texture_base_size(tex, &pw, &ph);
 
         // Cell count from texture (32 px per cell -- TQVaultAE standard)
         int iw = pw / 32;
@@ -282,15 +299,8 @@ draw_equip_slot(cairo_t *cr, AppWidgets *widgets,
         double dx = x + (box_w - draw_w) / 2.0;
         double dy = y + (box_h - draw_h) / 2.0;
 
-        cairo_save(cr);
-        cairo_translate(cr, dx, dy);
-        cairo_scale(cr, draw_w / (double)pw, draw_h / (double)ph);
-        G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-        gdk_cairo_set_source_pixbuf(cr, pixbuf, 0, 0);
-        G_GNUC_END_IGNORE_DEPRECATIONS
-        cairo_paint(cr);
-        cairo_restore(cr);
-        g_object_unref(pixbuf);
+        texture_paint(cr, tex, dx, dy, draw_w, draw_h, 1.0);
+        cairo_surface_destroy(tex);
 
         // Relic/charm overlay icon
         if((item->relic_name && item->relic_name[0]) ||
@@ -511,17 +521,21 @@ draw_sack_items(cairo_t *cr, AppWidgets *widgets,
       highlight_compare = true;
   }
 
+  double cell_px = cell_device_px(cr, fmax(cell_width, cell_height));
+
   for(int i = 0; i < sack->num_items; i++)
   {
     TQVaultItem *item = &sack->items[i];
     int w, h;
 
-    GdkPixbuf *pixbuf = load_item_texture(widgets, item->base_name, item->var1);
+    cairo_surface_t *tex = load_item_texture_async(widgets, item->base_name, item->var1,
+                                                   cell_px, this_widget);
 
-    if(pixbuf)
+    if(tex)
     {
-      w = gdk_pixbuf_get_width(pixbuf) / 32;
-      h = gdk_pixbuf_get_height(pixbuf) / 32;
+      texture_base_size(tex, &w, &h);
+      w /= 32;
+      h /= 32;
       if(w < 1)
         w = 1;
       if(h < 1)
@@ -548,20 +562,10 @@ draw_sack_items(cairo_t *cr, AppWidgets *widgets,
       cairo_fill(cr);
     }
 
-    if(pixbuf)
+    if(tex)
     {
-      int pw = gdk_pixbuf_get_width(pixbuf);
-      int ph = gdk_pixbuf_get_height(pixbuf);
-
-      cairo_save(cr);
-      cairo_translate(cr, x + 2, y + 2);
-      cairo_scale(cr, (rw - 4) / pw, (rh - 4) / ph);
-      G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-      gdk_cairo_set_source_pixbuf(cr, pixbuf, 0, 0);
-      G_GNUC_END_IGNORE_DEPRECATIONS
-      cairo_paint(cr);
-      cairo_restore(cr);
-      g_object_unref(pixbuf);
+      texture_paint(cr, tex, x + 2, y + 2, rw - 4, rh - 4, 1.0);
+      cairo_surface_destroy(tex);
     }
     else
     {
@@ -1113,19 +1117,10 @@ held_overlay_draw_cb(GtkDrawingArea *da, cairo_t *cr,
   if(cell <= 0.0)
     cell = 32.0;
 
-  int pw = gdk_pixbuf_get_width(hi->texture);
-  int ph = gdk_pixbuf_get_height(hi->texture);
   double rw = (double)hi->item_w * cell;
   double rh = (double)hi->item_h * cell;
   double ix = widgets->win_cursor_x - rw / 2.0;
   double iy = widgets->win_cursor_y - rh / 2.0;
 
-  cairo_save(cr);
-  cairo_translate(cr, ix, iy);
-  cairo_scale(cr, rw / (double)pw, rh / (double)ph);
-  G_GNUC_BEGIN_IGNORE_DEPRECATIONS
-  gdk_cairo_set_source_pixbuf(cr, hi->texture, 0, 0);
-  G_GNUC_END_IGNORE_DEPRECATIONS
-  cairo_paint_with_alpha(cr, 0.7);
-  cairo_restore(cr);
+  texture_paint(cr, hi->texture, ix, iy, rw, rh, 0.7);
 }
@@ -390,6 +390,7 @@ on_refresh_char_clicked(GtkButton *btn, gpointer user_data)
   {
     update_ui(widgets, chr);
     prefetch_for_character(chr);
+    prefetch_item_icons(widgets, chr->inv_sacks, chr->num_inv_sacks);
     run_search(widgets);
   }
 }
@@ -480,6 +481,7 @@ on_character_changed(GObject *obj, GParamSpec *pspec, gpointer user_data)
   {
     update_ui(widgets, chr);
     prefetch_for_character(chr);
+    prefetch_item_icons(widgets, chr->inv_sacks, chr->num_inv_sacks);
     run_search(widgets);
   }
   queue_redraw_all(widgets);
@@ -561,7 +563,10 @@ on_vault_changed(GObject *obj, GParamSpec *pspec, gpointer user_data)
 
   widgets->current_vault = vault_load_json(path);
   if(widgets->current_vault)
+  {
     prefetch_for_vault(widgets->current_vault);
+    prefetch_item_icons(widgets, widgets->current_vault->sacks, widgets->current_vault->num_sacks);
+  }
 
   // Restore last viewed bag, or default to bag 0
   int restore_bag = global_config.last_vault_bag;
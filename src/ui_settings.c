@@ -155,9 +155,56 @@ on_browse_clicked(GtkButton *btn, gpointer user_data)
 typedef struct {
   GtkEntry *save_folder_entry;
   GtkEntry *game_folder_entry;
+  GtkWidget *language_dd;
   AppWidgets *app_widgets;
 } SettingsWidgets;
 
+// Switch the UI to a loaded language. Only the tooltip markup is
+// re-rendered; affix results are cached per language and nothing else
+// depends on the text table.
+//
+// t: the language's table, or NULL if it could not be loaded
+// user_data: AppWidgets pointer
+static void
+on_language_ready(TQTranslation *t, void *user_data)
+{
+  AppWidgets *widgets = user_data;
+
+  // keep the current language, or fall back to the default if there is none
+  if(!t && !widgets->translations && global_config.game_folder)
+    t = translation_language(global_config.game_folder, TRANSLATION_DEFAULT_LANGUAGE);
+
+  if(!t || t == widgets->translations)
+    return;
+
+  widgets->translations = t;
+
+  if(widgets->compare_active)
+    vault_item_format_stats(&widgets->compare_item, t, widgets->compare_markup,
+                            sizeof(widgets->compare_markup));
+
+  invalidate_tooltips(widgets);
+  queue_redraw_all(widgets);
+}
+
+// Start loading the picked language in the background, so that it is
+// usually ready by the time the dialog is saved.
+//
+// dd: the language GtkDropDown
+// pspec: the "selected" property (unused)
+// user_data: unused
+static void
+on_language_selected(GObject *dd, GParamSpec *pspec, gpointer user_data)
+{
+  (void)pspec; (void)user_data;
+  char *code = dropdown_get_selected_text(GTK_WIDGET(dd));
+
+  if(code && global_config.game_folder)
+    translation_language_async(global_config.game_folder, code, NULL, NULL);
+
+  g_free(code);
+}
+
 // Save settings, close the dialog, and reload translations/combos.
 //
 // btn: the Save & Close button (unused)
@@ -182,26 +229,27 @@ on_settings_close(GtkButton *btn, gpointer user_data)
     return;  // keep settings open
   }
 
+  char *lang = dropdown_get_selected_text(sw->language_dd);
+
   config_set_save_folder(save);
   config_set_game_folder(game);
+  if(lang)
+    config_set_language(lang);
   config_save();
+  g_free(lang);
 
-  gtk_window_destroy(GTK_WINDOW(window));
-
-  // Reload translations and repopulate combos after settings change
+  // the dialog owns sw
   AppWidgets *widgets = sw->app_widgets;
 
+  gtk_window_destroy(GTK_WINDOW(window));
+
+  // Switch translations and repopulate combos after settings change
   if(widgets)
   {
-    if(global_config.game_folder && !widgets->translations)
-    {
-      widgets->translations = translation_init();
-      char trans_path[1024];
-
-      snprintf(trans_path, sizeof(trans_path), "%s/Text/Text_EN.arc",
-               global_config.game_folder);
-      translation_load_from_arc(widgets->translations, trans_path);
-    }
+    if(global_config.game_folder)
+      translation_language_async(global_config.game_folder,
+                                 global_config.language ? global_config.language : TRANSLATION_DEFAULT_LANGUAGE,
+                                 on_language_ready, widgets);
 
     if(global_config.save_folder)
     {
@@ -451,6 +499,21 @@ on_settings_action(GSimpleAction *action, GVariant *parameter, gpointer user_dat
   g_signal_connect(browse_game_btn, "clicked", G_CALLBACK(on_browse_clicked), sw->game_folder_entry);
   gtk_box_append(GTK_BOX(hbox2), browse_game_btn);
 
+  gtk_box_append(GTK_BOX(vbox), gtk_label_new("Text Language:"));
+
+  // one entry per Text_<code>.arc installed with the game
+  char **codes = translation_languages_new(global_config.game_folder);
+  char *cur_lang = g_ascii_strup(global_config.language ? global_config.language
+                                                         : TRANSLATION_DEFAULT_LANGUAGE, -1);
+
+  sw->language_dd = gtk_drop_down_new_from_strings((const char * const *)codes);
+  gtk_widget_set_halign(sw->language_dd, GTK_ALIGN_START);
+  dropdown_select_by_name(sw->language_dd, cur_lang);
+  g_signal_connect(sw->language_dd, "notify::selected", G_CALLBACK(on_language_selected), NULL);
+  gtk_box_append(GTK_BOX(vbox), sw->language_dd);
+  g_free(cur_lang);
+  g_strfreev(codes);
+
   GtkWidget *close_button = gtk_button_new_with_label("Save & Close");
 
   gtk_widget_set_margin_top(close_button, 20);
@@ -468,6 +531,71 @@ typedef struct {
   GtkEntry *game_folder_entry;
 } FirstRunData;
 
+typedef struct {
+  GtkWidget *window;
+  GtkWidget *bar;
+} IndexProgress;
+
+// Progress callback for the first-run resource index build. Shows the
+// progress window on first use, updates the bar, and pumps the main
+// context so it repaints while the build blocks this thread.
+//
+// done: containers scanned so far
+// total: containers to scan
+// user_data: IndexProgress pointer
+static void
+on_index_progress(int done, int total, void *user_data)
+{
+  IndexProgress *ip = user_data;
+
+  if(!gtk_widget_get_visible(ip->window))
+    gtk_window_present(GTK_WINDOW(ip->window));
+
+  char *text = g_strdup_printf("Indexing game files… %d / %d", done, total);
+
+  gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(ip->bar),
+                                total > 0 ? (double)done / total : 1.0);
+  gtk_progress_bar_set_text(GTK_PROGRESS_BAR(ip->bar), text);
+  g_free(text);
+
+  while(g_main_context_pending(NULL))
+    g_main_context_iteration(NULL, FALSE);
+}
+
+// Create the (initially hidden) first-run index progress window. It is
+// attached to the application so the app stays alive between the wizard
+// closing and the main window opening.
+//
+// app: the GtkApplication instance
+// ip: progress state to fill in
+static void
+index_progress_init(GtkApplication *app, IndexProgress *ip)
+{
+  ip->window = gtk_window_new();
+  gtk_window_set_application(GTK_WINDOW(ip->window), app);
+  gtk_window_set_title(GTK_WINDOW(ip->window), "TQVaultC - First Run");
+  gtk_window_set_deletable(GTK_WINDOW(ip->window), FALSE);
+  gtk_window_set_resizable(GTK_WINDOW(ip->window), FALSE);
+  gtk_window_set_default_size(GTK_WINDOW(ip->window), 420, -1);
+
+  GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
+
+  gtk_widget_set_margin_start(vbox, 20);
+  gtk_widget_set_margin_end(vbox, 20);
+  gtk_widget_set_margin_top(vbox, 20);
+  gtk_widget_set_margin_bottom(vbox, 20);
+  gtk_window_set_child(GTK_WINDOW(ip->window), vbox);
+
+  GtkWidget *label = gtk_label_new("Building the game resource index. This only happens once.");
+
+  gtk_label_set_wrap(GTK_LABEL(label), TRUE);
+  gtk_box_append(GTK_BOX(vbox), label);
+
+  ip->bar = gtk_progress_bar_new();
+  gtk_progress_bar_set_show_text(GTK_PROGRESS_BAR(ip->bar), TRUE);
+  gtk_box_append(GTK_BOX(vbox), ip->bar);
+}
+
 // Save first-run settings and launch the main UI.
 //
 // btn: the Save & Continue button (unused)
@@ -497,7 +625,9 @@ on_first_run_save(GtkButton *btn, gpointer user_data)
   config_save();
 
   GtkApplication *app = fr->app;
+  IndexProgress ip;
 
+  index_progress_init(app, &ip);
   gtk_window_destroy(GTK_WINDOW(win));
 
   // Run the same init sequence as on_activate(). Without this, the asset
@@ -506,13 +636,14 @@ on_first_run_save(GtkButton *btn, gpointer user_data)
   // textures and "g_hash_table_lookup: hash_table != NULL" spam.
   if(global_config.game_folder)
   {
-    asset_manager_init(global_config.game_folder);
+    asset_manager_init_with_progress(global_config.game_folder, on_index_progress, &ip);
     arz_intern_init();
     item_stats_init();
     affix_table_init(NULL);
   }
 
   ui_app_activate(app, NULL);
+  gtk_window_destroy(GTK_WINDOW(ip.window));
 }
 
 // Deferred callback to show the About dialog once the settings window is mapped.
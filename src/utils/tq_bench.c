@@ -0,0 +1,635 @@
+// tq_bench.c -- micro-benchmarks for TQVaultC hot paths.
+//
+// Works directly against the cache files and game data, without starting
+// the GUI. Each command prints throughput for the current implementation
+// and, where one exists, the layout or code path it replaced.
+//
+// Usage:
+//   tq-bench <command> [options]
+//
+// Commands:
+//   lookup  <index> [iterations]           Resource index lookups/sec
+//   arzload <file.arz> [iterations]        ARZ open time (string table)
+//   dds     [iterations]                   BC1/BC2/BC3 decode MP/s per code path
+//   arc     <file.arc> [iterations]        Largest files: serial vs parallel inflate
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <glib.h>
+#include "../asset_index.h"
+#include "../arz.h"
+#include "../arc.h"
+#include "../dds_decode.h"
+#include "../platform_mmap.h"
+
+// Prints usage information for all commands to stderr.
+// prog: the program name (argv[0]).
+static void
+usage(const char *prog)
+{
+  fprintf(stderr,
+    "Usage: %s <command> [options]\n"
+    "\n"
+    "Commands:\n"
+    "  lookup  <index> [iterations]         Resource index lookups/sec\n"
+    "  arzload <file.arz> [iterations]      ARZ open time (string table)\n"
+    "  dds     [iterations]                 BC1/BC2/BC3 decode MP/s per code path\n"
+    "  arc     <file.arc> [iterations]      Largest files: serial vs parallel inflate\n"
+    "\n"
+    "Examples:\n"
+    "  %s lookup ~/.cache/tqvaultc/tqvc-resource-index.bin\n"
+    "  %s arzload Database/database.arz\n"
+    "  %s dds 50\n"
+    "  %s arc Text/Text_EN.arc\n"
+    "  %s arc Resources/Items.arc\n",
+    prog, prog, prog, prog, prog, prog);
+}
+
+// Returns the next value of a xorshift64 generator (deterministic shuffles).
+// state: generator state, updated in place.
+static uint64_t
+xorshift64(uint64_t *state)
+{
+  uint64_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *state = x;
+  return(x);
+}
+
+// Finds the first entry with a given hash by binary search over the packed
+// entry array -- the layout asset_lookup() used before the bucket directory.
+// entries: hash-sorted entry array.
+// n: number of entries.
+// hash: key to find.
+// Returns the entry index, or UINT32_MAX if absent.
+static uint32_t
+binary_search_entries(const TQAssetEntry *entries, uint32_t n, uint64_t hash)
+{
+  uint32_t low = 0;
+  uint32_t high = n;
+
+  while(low < high)
+  {
+    uint32_t mid = low + (high - low) / 2;
+
+    if(entries[mid].hash < hash)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return(low < n && entries[low].hash == hash ? low : UINT32_MAX);
+}
+
+// Prints one benchmark result line.
+// label: what was measured.
+// ops: number of operations performed.
+// usec: elapsed wall time in microseconds.
+static void
+print_rate(const char *label, uint64_t ops, gint64 usec)
+{
+  double secs = usec > 0 ? usec / 1e6 : 1e-6;
+
+  printf("  %-28s %10.2f M/s  (%.1f ns/op)\n",
+         label, ops / secs / 1e6, secs * 1e9 / (double)ops);
+}
+
+// Benchmarks resource index lookups: bucket directory + dense keys against
+// binary search over the entry array, on shuffled keys from a real index.
+// index_path: path to tqvc-resource-index.bin.
+// iterations: number of passes over the key set.
+// Returns 0 on success, 1 on failure.
+static int
+cmd_lookup(const char *index_path, int iterations)
+{
+  size_t size = 0;
+  const uint8_t *map = platform_mmap_readonly(index_path, &size);
+
+  if(iterations < 1)
+    iterations = 1;
+
+  if(!map)
+  {
+    fprintf(stderr, "Cannot map %s\n", index_path);
+    return(1);
+  }
+
+  const TQIndexHeader *h = (const TQIndexHeader *)map;
+
+  if(size < sizeof(TQIndexHeader) || memcmp(h->magic, "TQVI", 4) != 0 ||
+     h->version != ASSET_INDEX_VERSION || h->num_entries == 0)
+  {
+    fprintf(stderr, "%s is not a version %d resource index\n", index_path,
+            ASSET_INDEX_VERSION);
+    platform_munmap((void *)map, size);
+    return(1);
+  }
+
+  const TQAssetEntry *entries = (const TQAssetEntry *)(map + h->entries_offset);
+  const uint64_t *keys = (const uint64_t *)(map + h->keys_offset);
+  const uint32_t *buckets = (const uint32_t *)(map + h->buckets_offset);
+  uint32_t n = h->num_entries;
+
+  // half hits in shuffled order, half misses
+  uint64_t *queries = malloc((size_t)n * 2 * sizeof(uint64_t));
+  uint64_t rng = 0x9e3779b97f4a7c15ULL;
+
+  if(!queries)
+  {
+    platform_munmap((void *)map, size);
+    return(1);
+  }
+
+  for(uint32_t i = 0; i < n; i++)
+  {
+    queries[i * 2] = keys[i];
+    queries[i * 2 + 1] = xorshift64(&rng);
+  }
+
+  for(uint32_t i = n * 2 - 1; i > 0; i--)
+  {
+    uint32_t j = (uint32_t)(xorshift64(&rng) % (i + 1));
+    uint64_t t = queries[i];
+
+    queries[i] = queries[j];
+    queries[j] = t;
+  }
+
+  // both paths must agree before timing means anything
+  for(uint32_t i = 0; i < n * 2; i++)
+  {
+    uint32_t a = asset_index_probe(keys, buckets, h->bucket_bits, queries[i]);
+    uint32_t b = binary_search_entries(entries, n, queries[i]);
+
+    if(a != b)
+    {
+      fprintf(stderr, "Mismatch for key %016llx: bucket %u, binary %u\n",
+              (unsigned long long)queries[i], a, b);
+      free(queries);
+      platform_munmap((void *)map, size);
+      return(1);
+    }
+  }
+
+  printf("%s: %u entries, %u buckets (%u bits), %d x %u lookups\n",
+         index_path, n, 1u << h->bucket_bits, h->bucket_bits, iterations, n * 2);
+
+  uint64_t ops = (uint64_t)iterations * n * 2;
+  uint64_t sink = 0;
+  gint64 t0 = g_get_monotonic_time();
+
+  for(int it = 0; it < iterations; it++)
+    for(uint32_t i = 0; i < n * 2; i++)
+      sink += asset_index_probe(keys, buckets, h->bucket_bits, queries[i]);
+
+  gint64 t1 = g_get_monotonic_time();
+
+  for(int it = 0; it < iterations; it++)
+    for(uint32_t i = 0; i < n * 2; i++)
+      sink += binary_search_entries(entries, n, queries[i]);
+
+  gint64 t2 = g_get_monotonic_time();
+
+  print_rate("bucket directory", ops, t1 - t0);
+  print_rate("binary search (entries)", ops, t2 - t1);
+  printf("  speedup %.2fx  (checksum %llu)\n",
+         (double)(t2 - t1) / (double)(t1 - t0 > 0 ? t1 - t0 : 1),
+         (unsigned long long)sink);
+
+  free(queries);
+  platform_munmap((void *)map, size);
+  return(0);
+}
+
+// Builds an ARZ string table the way arz_load() used to: one malloc and
+// copy per string, then an arz_intern() of every entry.
+// data: mapped ARZ file.
+// size: size of the mapping.
+// Returns the number of strings read (the table is freed before returning).
+static uint32_t
+legacy_string_table(const uint8_t *data, size_t size)
+{
+  uint32_t string_start;
+  uint32_t num_strings;
+
+  memcpy(&string_start, data + 16, 4);
+
+  if((size_t)string_start + 4 > size)
+    return(0);
+
+  memcpy(&num_strings, data + string_start, 4);
+
+  char **table = calloc(num_strings ? num_strings : 1, sizeof(char *));
+  size_t off = (size_t)string_start + 4;
+  uint32_t n = 0;
+
+  if(!table)
+    return(0);
+
+  for(; n < num_strings && off + 4 <= size; n++)
+  {
+    uint32_t len;
+
+    memcpy(&len, data + off, 4);
+
+    if(off + 4 + len > size)
+      break;
+
+    table[n] = malloc((size_t)len + 1);
+
+    if(table[n])
+    {
+      memcpy(table[n], data + off + 4, len);
+      table[n][len] = '\0';
+    }
+
+    off += 4 + (size_t)len;
+  }
+
+  for(uint32_t i = 0; i < n; i++)
+    if(table[i])
+      arz_intern(table[i]);
+
+  for(uint32_t i = 0; i < n; i++)
+    free(table[i]);
+
+  free(table);
+  return(n);
+}
+
+// Benchmarks opening an ARZ database: arz_load() (one string arena, lazy
+// interning) against the per-string malloc + eager intern it replaced.
+// The intern table is reset before every open, as at application start.
+// arz_path: path to an .arz file.
+// iterations: number of opens per variant.
+// Returns 0 on success, 1 on failure.
+static int
+cmd_arzload(const char *arz_path, int iterations)
+{
+  if(iterations < 1)
+    iterations = 1;
+
+  TQArzFile *probe = arz_load(arz_path);
+
+  if(!probe)
+  {
+    fprintf(stderr, "Cannot load %s\n", arz_path);
+    return(1);
+  }
+
+  printf("%s: %u strings, %u records, %d opens\n",
+         arz_path, probe->num_strings, probe->num_records, iterations);
+  arz_free(probe);
+
+  gint64 arena_usec = 0;
+  gint64 legacy_usec = 0;
+  uint64_t sink = 0;
+
+  for(int it = 0; it < iterations; it++)
+  {
+    arz_intern_free();
+    arz_intern_init();
+
+    gint64 t0 = g_get_monotonic_time();
+    TQArzFile *arz = arz_load(arz_path);
+
+    if(arz)
+    {
+      sink += arz->num_strings;
+      arz_free(arz);
+    }
+
+    arena_usec += g_get_monotonic_time() - t0;
+
+    arz_intern_free();
+    arz_intern_init();
+
+    // legacy variant: arz_load() plus the old string table and intern
+    // pass on top, so the difference between the rows is the old cost
+    size_t size = 0;
+    const uint8_t *map;
+
+    t0 = g_get_monotonic_time();
+    arz = arz_load(arz_path);
+    map = arz ? arz->raw_data : NULL;
+    size = arz ? arz->data_size : 0;
+
+    if(map)
+      sink += legacy_string_table(map, size);
+
+    arz_free(arz);
+    legacy_usec += g_get_monotonic_time() - t0;
+  }
+
+  arz_intern_free();
+
+  printf("  %-28s %10.2f ms/open\n", "arz_load", arena_usec / 1000.0 / iterations);
+  printf("  %-28s %10.2f ms/open\n", "+ per-string malloc/intern", legacy_usec / 1000.0 / iterations);
+  printf("  old string table cost %.2f ms/open  (checksum %llu)\n",
+         (legacy_usec - arena_usec) / 1000.0 / iterations, (unsigned long long)sink);
+  return(0);
+}
+
+// BCn decoder paths compared by cmd_dds(), scalar (the reference) first.
+static const struct {
+  DdsDecodePath path;
+  const char *name;
+} dds_paths[] = {
+  { DDS_DECODE_SCALAR, "scalar" },
+  { DDS_DECODE_SSE2,   "sse2" },
+  { DDS_DECODE_AVX2,   "avx2" },
+};
+
+// Checks every supported decoder path against the scalar decoder on random
+// blocks, including sizes that leave partial blocks on the right and bottom.
+// Returns 0 if all outputs are identical, 1 otherwise.
+static int
+dds_verify(void)
+{
+  static const int sizes[][2] = {
+    { 1, 1 }, { 3, 5 }, { 4, 4 }, { 17, 9 }, { 257, 131 }, { 512, 512 },
+  };
+  uint64_t rng = 0x2545f4914f6cdd1dULL;
+
+  for(int variant = 1; variant <= 3; variant++)
+  {
+    for(size_t s = 0; s < G_N_ELEMENTS(sizes); s++)
+    {
+      int w = sizes[s][0];
+      int h = sizes[s][1];
+      size_t n = (size_t)((w + 3) / 4) * ((h + 3) / 4) * (variant == 1 ? 8 : 16);
+      uint8_t *blocks = malloc(n);
+
+      if(!blocks)
+        return(1);
+
+      for(size_t i = 0; i < n; i++)
+        blocks[i] = (uint8_t)xorshift64(&rng);
+
+      uint8_t *ref = dds_decode_bcn(blocks, n, w, h, variant, DDS_DECODE_SCALAR);
+
+      for(size_t p = 1; p < G_N_ELEMENTS(dds_paths); p++)
+      {
+        if(!dds_decode_path_supported(dds_paths[p].path))
+          continue;
+
+        uint8_t *out = dds_decode_bcn(blocks, n, w, h, variant, dds_paths[p].path);
+        int same = ref && out && memcmp(ref, out, (size_t)w * h * 4) == 0;
+
+        free(out);
+
+        if(!same)
+        {
+          fprintf(stderr, "BC%d %dx%d: %s output differs from scalar\n",
+                  variant, w, h, dds_paths[p].name);
+          free(ref);
+          free(blocks);
+          return(1);
+        }
+      }
+
+      free(ref);
+      free(blocks);
+    }
+  }
+
+  return(0);
+}
+
+// Benchmarks BC1/BC2/BC3 decoding of a 1024x1024 texture of random blocks
+// on every code path this CPU supports, after checking that each path
+// reproduces the scalar decoder exactly.
+// iterations: number of decodes per variant and path.
+// Returns 0 on success, 1 on failure.
+static int
+cmd_dds(int iterations)
+{
+  const int w = 1024;
+  const int h = 1024;
+  uint64_t rng = 0x9e3779b97f4a7c15ULL;
+
+  if(iterations < 1)
+    iterations = 1;
+
+  if(dds_verify() != 0)
+    return(1);
+
+  printf("dds: all supported paths match scalar; %dx%d, %d decodes\n", w, h, iterations);
+
+  for(int variant = 1; variant <= 3; variant++)
+  {
+    size_t n = (size_t)(w / 4) * (h / 4) * (variant == 1 ? 8 : 16);
+    uint8_t *blocks = malloc(n);
+    gint64 scalar_usec = 0;
+    uint64_t sink = 0;
+
+    if(!blocks)
+      return(1);
+
+    for(size_t i = 0; i < n; i++)
+      blocks[i] = (uint8_t)xorshift64(&rng);
+
+    printf(" BC%d\n", variant);
+
+    for(size_t p = 0; p < G_N_ELEMENTS(dds_paths); p++)
+    {
+      if(!dds_decode_path_supported(dds_paths[p].path))
+      {
+        printf("  %-28s %10s\n", dds_paths[p].name, "n/a");
+        continue;
+      }
+
+      gint64 t0 = g_get_monotonic_time();
+
+      for(int it = 0; it < iterations; it++)
+      {
+        uint8_t *out = dds_decode_bcn(blocks, n, w, h, variant, dds_paths[p].path);
+
+        if(out)
+          sink += out[(size_t)it % ((size_t)w * h * 4)];
+
+        free(out);
+      }
+
+      gint64 usec = g_get_monotonic_time() - t0;
+      double secs = usec > 0 ? usec / 1e6 : 1e-6;
+
+      if(p == 0)
+        scalar_usec = usec;
+
+      printf("  %-28s %10.1f MP/s  (%.2fx scalar)\n", dds_paths[p].name,
+             (double)w * h * iterations / secs / 1e6,
+             (double)scalar_usec / (double)(usec > 0 ? usec : 1));
+    }
+
+    printf("  (checksum %llu)\n", (unsigned long long)sink);
+    free(blocks);
+  }
+
+  return(0);
+}
+
+// Number of files cmd_arc() measures in an archive.
+#define ARC_BENCH_FILES 8
+
+// Times extraction of the largest files in an ARC archive, inflating their
+// parts one after another on one thread against spreading them over the
+// inflate pool, and checks that both give the same bytes.
+// arc_path: path to an .arc file.
+// iterations: number of extractions per file and variant.
+// Returns 0 on success, 1 on failure.
+static int
+cmd_arc(const char *arc_path, int iterations)
+{
+  if(iterations < 1)
+    iterations = 1;
+
+  TQArcFile *arc = arc_load(arc_path);
+
+  if(!arc)
+  {
+    fprintf(stderr, "Cannot load %s\n", arc_path);
+    return(1);
+  }
+
+  // pick the largest files
+  uint32_t top[ARC_BENCH_FILES];
+  int num_top = 0;
+
+  for(uint32_t i = 0; i < arc->num_files; i++)
+  {
+    int pos = num_top;
+
+    while(pos > 0 && arc->entries[top[pos - 1]].real_size < arc->entries[i].real_size)
+      pos--;
+
+    if(pos >= ARC_BENCH_FILES)
+      continue;
+
+    if(num_top < ARC_BENCH_FILES)
+      num_top++;
+
+    memmove(&top[pos + 1], &top[pos], (size_t)(num_top - 1 - pos) * sizeof(uint32_t));
+    top[pos] = i;
+  }
+
+  int threads = (int)g_get_num_processors();
+
+  printf("%s: %u files, %u parts, %d extractions per file, %d threads\n",
+         arc_path, arc->num_files, arc->num_parts, iterations, threads);
+
+  int rc = 0;
+
+  for(int t = 0; t < num_top; t++)
+  {
+    const TQArcEntry *e = &arc->entries[top[t]];
+    uint8_t *serial = malloc(e->real_size ? e->real_size : 1);
+    uint8_t *parallel = malloc(e->real_size ? e->real_size : 1);
+    bool ok = (serial && parallel);
+
+    gint64 t0 = g_get_monotonic_time();
+
+    for(int it = 0; ok && it < iterations; it++)
+      ok = arc_read_parts(arc, e->first_part_index, e->real_size, serial, 1);
+
+    gint64 serial_usec = g_get_monotonic_time() - t0;
+
+    t0 = g_get_monotonic_time();
+
+    for(int it = 0; ok && it < iterations; it++)
+      ok = arc_read_parts(arc, e->first_part_index, e->real_size, parallel, threads);
+
+    gint64 parallel_usec = g_get_monotonic_time() - t0;
+
+    if(ok && memcmp(serial, parallel, e->real_size) != 0)
+      ok = false;
+
+    if(!ok)
+    {
+      printf("  %-40s FAILED\n", e->path);
+      rc = 1;
+    }
+    else
+    {
+      double mb = e->real_size / (1024.0 * 1024.0);
+
+      printf("  %-40s %4u parts %8.2f MB  serial %8.2f ms  parallel %8.2f ms  (%.2fx)\n",
+             e->path, e->num_parts, mb,
+             serial_usec / 1000.0 / iterations, parallel_usec / 1000.0 / iterations,
+             (double)serial_usec / (double)(parallel_usec > 0 ? parallel_usec : 1));
+    }
+
+    free(serial);
+    free(parallel);
+  }
+
+  arc_free(arc);
+  return(rc);
+}
+
+// Entry point. Dispatches to the appropriate subcommand handler.
+// argc: argument count (must be >= 2).
+// argv: argument vector; argv[1] is the command name.
+// Returns 0 on success, 1 on failure or unknown command.
+int
+main(int argc, char **argv)
+{
+  if(argc < 2)
+  {
+    usage(argv[0]);
+    return(1);
+  }
+
+  const char *cmd = argv[1];
+
+  if(strcmp(cmd, "--help") == 0 || strcmp(cmd, "-h") == 0)
+  {
+    usage(argv[0]);
+    return(0);
+  }
+
+  if(strcmp(cmd, "lookup") == 0)
+  {
+    if(argc < 3)
+    {
+      fprintf(stderr, "Usage: %s lookup <index> [iterations]\n", argv[0]);
+      return(1);
+    }
+
+    return(cmd_lookup(argv[2], argc > 3 ? atoi(argv[3]) : 10));
+  }
+
+  if(strcmp(cmd, "arzload") == 0)
+  {
+    if(argc < 3)
+    {
+      fprintf(stderr, "Usage: %s arzload <file.arz> [iterations]\n", argv[0]);
+      return(1);
+    }
+
+    return(cmd_arzload(argv[2], argc > 3 ? atoi(argv[3]) : 5));
+  }
+
+  if(strcmp(cmd, "dds") == 0)
+    return(cmd_dds(argc > 2 ? atoi(argv[2]) : 20));
+
+  if(strcmp(cmd, "arc") == 0)
+  {
+    if(argc < 3)
+    {
+      fprintf(stderr, "Usage: %s arc <file.arc> [iterations]\n", argv[0]);
+      return(1);
+    }
+
+    return(cmd_arc(argv[2], argc > 3 ? atoi(argv[3]) : 5));
+  }
+
+  fprintf(stderr, "Unknown command: %s\n", cmd);
+  usage(argv[0]);
+  return(1);
+}
@@ -247,7 +247,8 @@ cmd_fields(const char *arz_path, const char *pattern, const char *field_list)
 
     g_free(lower_path);
 
-    TQArzRecordData *data = arz_read_record(arz, arz->records[i].path);
+    TQArzRecordData *data = arz_read_record_at(arz, arz->records[i].offset,
+                                               arz->records[i].compressed_size);
     if(!data)
       continue;
 
@@ -315,7 +316,8 @@ cmd_stats(const char *arz_path, const char *pattern)
 
     g_free(lower_path);
 
-    TQArzRecordData *data = arz_read_record(arz, arz->records[i].path);
+    TQArzRecordData *data = arz_read_record_at(arz, arz->records[i].offset,
+                                               arz->records[i].compressed_size);
     if(!data)
       continue;
 
@@ -426,7 +428,8 @@ cmd_coverage(const char *arz_path, const char *path_substr)
     if(!match)
       continue;
 
-    TQArzRecordData *data = arz_read_record(arz, arz->records[i].path);
+    TQArzRecordData *data = arz_read_record_at(arz, arz->records[i].offset,
+                                               arz->records[i].compressed_size);
     if(!data)
       continue;
 